@@ -1,33 +1,528 @@
 #include "AddressBook.h"
+#include "AhoCorasick.h"
+#include "BlockCodec.h"
+#include "CsvCodec.h"
+#include "TextUtils.h"
+#include "WorkStealing.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
 #include <map>
+#include <iterator>
+#include <thread>
+#include <atomic>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
 
 //============================= CONSTANTS ====================================
 const std::string AddressBook::DEFAULT_FILENAME = "addressbook.csv";
+const size_t AddressBook::CSV_FIELD_COUNT = 13;
+const size_t AddressBook::RENDER_CACHE_BYTES = 1024 * 1024;
+const size_t AddressBook::RESIDENT_RECORD_LIMIT = 4096;
+const size_t AddressBook::HISTORY_LIMIT = 1000;
+const size_t AddressBook::CHANGE_FEED_CAPACITY = 4096;
+const size_t AddressBook::READ_CHUNK_BYTES = 1024 * 1024;
+const size_t AddressBook::PIPELINE_DEPTH = 4;
+const size_t AddressBook::MAX_RECORD_BYTES = 4 * 1024 * 1024;
+const size_t AddressBook::SCAN_CHUNK_CONTACTS = 2048;
 
 //============================= HELPER FUNCTIONS ====================================
 
-//helper pointer
-Contact* AddressBook::FindContactById(int contactId) {
-    for (auto& contact : contacts_) {
-        if (contact.getId() == contactId) {
-            return &contact;
+namespace {
+
+    bool EndsWith(const std::string& text, const std::string& suffix) {
+        return text.size() >= suffix.size() &&
+               text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    //  Shard files in a directory: every "*.csv", sorted by name so the
+    //  load order (and therefore the listing order) is stable.
+    bool ListShardFiles(const std::string& directory, std::vector<std::string>& names) {
+#if defined(_WIN32)
+        WIN32_FIND_DATAA entry;
+        HANDLE search = FindFirstFileA((directory + "\\*.csv").c_str(), &entry);
+        if (search == INVALID_HANDLE_VALUE) {
+            return GetLastError() == ERROR_FILE_NOT_FOUND;
+        }
+        do {
+            if (!(entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+                names.push_back(entry.cFileName);
+            }
+        } while (FindNextFileA(search, &entry));
+        FindClose(search);
+#else
+        DIR* dir = opendir(directory.c_str());
+        if (!dir) {
+            return false;
+        }
+        while (dirent* entry = readdir(dir)) {
+            const std::string name = entry->d_name;
+            if (name[0] != '.' && EndsWith(name, ".csv")) {
+                names.push_back(name);
+            }
+        }
+        closedir(dir);
+#endif
+        std::sort(names.begin(), names.end());
+        return true;
+    }
+
+    bool IsValidShardName(const std::string& name) {
+        return !name.empty() && name[0] != '.' &&
+               name.find('/') == std::string::npos && name.find('\\') == std::string::npos;
+    }
+
+    //  A record's first field must be a whole number (the saved id); a
+    //  header row or stray text is rejected rather than imported.
+    bool IsRecordId(const std::string& field) {
+        if (field.empty()) return false;
+        errno = 0;
+        char* end = nullptr;
+        const long id = std::strtol(field.c_str(), &end, 10);
+        return errno == 0 && *end == '\0' && id >= INT_MIN && id <= INT_MAX;
+    }
+
+    //  True when two versions of a contact differ at most in their tags
+    //  and groups; only the label index keys on those.
+    bool SameExceptLabels(const Contact& a, const Contact& b) {
+        return a.getType() == b.getType() &&
+               a.getFirstName() == b.getFirstName() && a.getLastName() == b.getLastName() &&
+               a.getEmail() == b.getEmail() && a.getPhone() == b.getPhone() &&
+               a.getAddressLine() == b.getAddressLine() && a.getCity() == b.getCity() &&
+               a.getState() == b.getState() && a.getPostalCode() == b.getPostalCode() &&
+               a.getNotes() == b.getNotes();
+    }
+
+    bool ApplyLabelEdit(Contact& contact, const AddressBook::LabelEdit& edit) {
+        typedef AddressBook::LabelEdit::Action Action;
+        switch (edit.action) {
+            case Action::Apply:
+                return edit.group ? contact.addGroup(edit.label) : contact.addTag(edit.label);
+            case Action::Remove:
+                return edit.group ? contact.removeGroup(edit.label) : contact.removeTag(edit.label);
+            case Action::Rename:
+                return edit.group ? contact.renameGroup(edit.label, edit.newLabel)
+                                  : contact.renameTag(edit.label, edit.newLabel);
+        }
+        return false;
+    }
+}
+
+//helper pointer (O(1) through the id -> position map). Stored contacts
+//are immutable; to change one, copy it and call ReplaceContact().
+//A lazily loaded preview is parsed in full here, on first access. At
+//most RESIDENT_RECORD_LIMIT unedited ones stay parsed; the least
+//recently used go back to previews. The caller shares ownership of the
+//record it gets, so an eviction never frees one still in use. Once the
+//book is indexed, readers may run concurrently, so a preview is parsed
+//for the caller only and nothing is cached.
+ContactPtr AddressBook::FindContactById(int contactId) const {
+    auto found = positionById_.find(contactId);
+    if (found == positionById_.end()) {
+        return nullptr;
+    }
+    ContactPtr& stored = contacts_[found->second];
+    if (indexed_) {
+        return Full(stored);
+    }
+    if (resident_.Get(contactId)) {
+        return stored;
+    }
+    auto pending = pending_.find(contactId);
+    if (pending == pending_.end()) {
+        return stored;               // added or edited since the load
+    }
+
+    ResidentRecord resident {stored, pending->second};
+    ContactPtr full = Materialize(*stored, pending->second);
+    ++lazyParses_;
+    {
+        std::lock_guard<std::mutex> lock(contactsMutex_);
+        stored = full;
+        pending_.erase(pending);
+    }
+
+    LruCache<int, ResidentRecord>::Evicted evicted;
+    resident_.Put(contactId, std::move(resident), 1, &evicted);
+    for (auto& item : evicted) {
+        std::lock_guard<std::mutex> lock(contactsMutex_);
+        contacts_[positionById_.at(item.first)] = item.second.preview;
+        pending_[item.first] = item.second.record;
+    }
+    return stored;
+}
+
+//  A stored contact with every field. A lazy preview is parsed for the
+//  caller without being stored, so scans and concurrent readers never
+//  write to the book.
+ContactPtr AddressBook::Full(const ContactPtr& stored) const {
+    if (pending_.empty()) {
+        return stored;
+    }
+    auto pending = pending_.find(stored->getId());
+    return pending == pending_.end() ? stored : Materialize(*stored, pending->second);
+}
+
+//  Drops cached state for a contact that was edited or removed; an
+//  edited contact no longer matches its file record, so it stays parsed.
+void AddressBook::ForgetCached(int contactId) const {
+    resident_.Erase(contactId);
+    renderCache_.Invalidate(contactId);
+}
+
+//  Index maintenance: registers a contact with every secondary index.
+//  A lazy book skips this until EnsureIndexed() indexes everything.
+void AddressBook::IndexContact(const Contact& contact) const {
+    if (!indexed_) {
+        return;
+    }
+    prefixIndex_.Add(contact);
+    fuzzyIndex_.Add(contact);
+    phoneticIndex_.Add(contact);
+    phoneIndex_.Add(contact);
+    emailIndex_.Add(contact);
+    locationIndex_.Add(contact);
+    labelIndex_.Add(contact);
+    for (auto& order : orderIndexes_) {
+        if (order) {
+            order->Add(contact);
+        }
+    }
+    if (textIndex_) {
+        textIndex_->Add(contact);
+    }
+}
+
+//  Index maintenance: must be called with the contact as it was indexed.
+void AddressBook::UnindexContact(const Contact& contact) const {
+    if (!indexed_) {
+        return;
+    }
+    prefixIndex_.Remove(contact);
+    fuzzyIndex_.Remove(contact);
+    phoneticIndex_.Remove(contact);
+    phoneIndex_.Remove(contact);
+    emailIndex_.Remove(contact);
+    locationIndex_.Remove(contact);
+    labelIndex_.Remove(contact);
+    for (auto& order : orderIndexes_) {
+        if (order) {
+            order->Remove(contact);
+        }
+    }
+    if (textIndex_) {
+        textIndex_->Remove(contact);
+    }
+}
+
+//  Index maintenance for an edit that only touched tags / groups: the
+//  other indexes key on fields that did not change.
+void AddressBook::ReindexLabels(const Contact& before, const Contact& after) const {
+    if (!indexed_) {
+        return;
+    }
+    labelIndex_.Remove(before);
+    labelIndex_.Add(after);
+}
+
+//  The maintained index for one sort order, built from contacts_ the
+//  first time that order is asked for.
+OrderIndex& AddressBook::OrderFor(SortField field) const {
+    EnsureIndexed();
+    std::lock_guard<std::mutex> lock(orderMutex_);
+    std::unique_ptr<OrderIndex>& order = orderIndexes_[static_cast<size_t>(field)];
+    if (!order) {
+        order.reset(new OrderIndex(field));
+        order->BeginBulkLoad();
+        for (const auto& stored : contacts_) {
+            order->Add(*Full(stored));
+        }
+        order->EndBulkLoad();
+    }
+    return *order;
+}
+
+//  The full-text index, built from contacts_ on the first text search.
+const FullTextIndex& AddressBook::TextIndex() const {
+    EnsureIndexed();
+    std::lock_guard<std::mutex> lock(textIndexMutex_);
+    if (!textIndex_) {
+        textIndex_.reset(new FullTextIndex(stemWords_));
+        textIndex_->BeginBulkLoad();
+        for (const auto& stored : contacts_) {
+            textIndex_->Add(*Full(stored));
+        }
+        textIndex_->EndBulkLoad();
+    }
+    return *textIndex_;
+}
+
+//  Materializes index hits (contact ids) into result copies, skipping
+//  ids that are no longer present.
+std::vector<Contact> AddressBook::ContactsFromIds(const std::vector<int>& contactIds) const {
+    std::vector<Contact> results;
+    results.reserve(contactIds.size());
+    for (int contactId : contactIds) {
+        ContactPtr contact = FindContactById(contactId);
+        if (contact) {
+            results.push_back(*contact);
+        }
+    }
+    return results;
+}
+
+//  Orders index results the way a scan of contacts_ would find them.
+void AddressBook::SortByPosition(std::vector<int>& contactIds) const {
+    std::sort(contactIds.begin(), contactIds.end(), [this](int a, int b) {
+        return positionById_.at(a) < positionById_.at(b);
+    });
+}
+
+//  True for the queries whose Search* method scans contacts_ rather
+//  than asking an index; SearchBatch() answers those in one shared pass.
+bool AddressBook::NeedsScan(const BatchQuery& query) {
+    switch (query.kind) {
+        case BatchQuery::Kind::Name:
+            return true;
+        case BatchQuery::Kind::Email: {
+            const std::string& text = query.text;
+            const bool domain = text.size() > 1 && text.front() == '@';
+            const bool localPart = text.size() > 1 && text.back() == '@' && text.find('@') == text.size() - 1;
+            return !domain && !localPart;
+        }
+        case BatchQuery::Kind::Phone:
+            return PhoneIndex::Canonicalize(query.text) == 0;
+        default:
+            return false;
+    }
+}
+
+//  One pass over contacts_ for every selected Name / Email / Phone query:
+//  each field is scanned once by an automaton holding all the queries on
+//  that field (a name query matches the full name, which contains the
+//  first and last names). Chunks of contacts are scanned in parallel;
+//  the caller must have called EnsureIndexed().
+AddressBook::ScanMatches AddressBook::ScanOnce(const std::vector<BatchQuery>& queries,
+                                               const std::vector<bool>& selected,
+                                               unsigned threadCount) const {
+    AhoCorasick names, emails, phones;
+    std::vector<size_t> nameQuery, emailQuery, phoneQuery;   // pattern id -> query id
+    for (size_t q = 0; q < queries.size(); ++q) {
+        if (!selected[q]) {
+            continue;
+        }
+        switch (queries[q].kind) {
+            case BatchQuery::Kind::Name:  names.Add(queries[q].text);  nameQuery.push_back(q);  break;
+            case BatchQuery::Kind::Email: emails.Add(queries[q].text); emailQuery.push_back(q); break;
+            case BatchQuery::Kind::Phone: phones.Add(queries[q].text); phoneQuery.push_back(q); break;
+            default: break;
+        }
+    }
+    names.Build();
+    emails.Build();
+    phones.Build();
+
+    const size_t chunks = (contacts_.size() + SCAN_CHUNK_CONTACTS - 1) / SCAN_CHUNK_CONTACTS;
+    std::vector<ScanMatches> perChunk(chunks);
+    WorkStealing::ParallelFor(chunks, threadCount, [&](size_t chunk) {
+        std::vector<size_t> hits;
+        const size_t end = std::min(contacts_.size(), (chunk + 1) * SCAN_CHUNK_CONTACTS);
+        for (size_t position = chunk * SCAN_CHUNK_CONTACTS; position < end; ++position) {
+            const ContactPtr full = Full(contacts_[position]);
+            const Contact& contact = *full;
+            std::vector<size_t> matched;
+            auto scan = [&](const AhoCorasick& matcher, const std::string& field, const std::vector<size_t>& ids) {
+                if (matcher.Size() == 0) {
+                    return;
+                }
+                hits.clear();
+                matcher.FindAll(field, hits);
+                for (size_t pattern : hits) {
+                    matched.push_back(ids[pattern]);
+                }
+            };
+            scan(names, contact.getFullName(), nameQuery);
+            scan(emails, contact.getEmail(), emailQuery);
+            scan(phones, contact.getPhone(), phoneQuery);
+            if (!matched.empty()) {
+                std::sort(matched.begin(), matched.end());
+                perChunk[chunk].emplace_back(position, std::move(matched));
+            }
         }
+    });
+
+    ScanMatches matches;
+    for (auto& chunk : perChunk) {
+        std::move(chunk.begin(), chunk.end(), std::back_inserter(matches));
     }
-    return nullptr;
+    return matches;
 }
 
-const Contact* AddressBook::FindContactById(int contactId) const {
+//  Copies of every contact, in storage order (for "match everything" filters).
+std::vector<Contact> AddressBook::CopyAllContacts() const {
+    std::vector<Contact> results;
+    results.reserve(contacts_.size());
     for (const auto& contact : contacts_) {
-        if (contact.getId() == contactId) {
-            return &contact;
+        results.push_back(*Full(contact));
+    }
+    return results;
+}
+
+//  Re-syncs the id -> position map after an erase shifted the vector.
+void AddressBook::RebuildPositions(size_t fromPosition) {
+    for (size_t i = fromPosition; i < contacts_.size(); ++i) {
+        positionById_[contacts_[i]->getId()] = i;
+    }
+}
+
+//  Shard index by file name, or shards_.size() if there is none.
+size_t AddressBook::FindShard(const std::string& name) const {
+    for (size_t shard = 0; shard < shards_.size(); ++shard) {
+        if (shards_[shard].name == name) {
+            return shard;
+        }
+    }
+    return shards_.size();
+}
+
+std::string AddressBook::ShardPath(size_t shard) const {
+    if (shardDirectory_.empty()) {
+        return shards_[shard].name;
+    }
+    return shardDirectory_ + "/" + shards_[shard].name;
+}
+
+//  One save job per loaded shard (only the edited ones if changedOnly),
+//  taken under the lock so it is a consistent snapshot. The included
+//  shards are marked clean.
+std::vector<SnapshotWriter::Job> AddressBook::ShardJobs(bool changedOnly) const {
+    std::vector<SnapshotWriter::Job> jobs;
+    std::vector<PendingWork> work;
+    {
+        std::lock_guard<std::mutex> lock(contactsMutex_);
+        std::vector<SnapshotWriter::Job> byShard(shards_.size());
+        for (size_t slot = 0; slot < contacts_.size(); ++slot) {
+            byShard[shardOfSlot_[slot]].contacts.push_back(contacts_[slot]);
+        }
+
+        for (size_t shard = 0; shard < shards_.size(); ++shard) {
+            if (!shards_[shard].loaded || (changedOnly && !shards_[shard].dirty)) {
+                continue;
+            }
+            byShard[shard].path = ShardPath(shard);
+            jobs.push_back(std::move(byShard[shard]));
+            work.emplace_back();
+            CollectPending(jobs.back().contacts, work.back());
+            shards_[shard].dirty = false;
+        }
+    }
+    // Previews are parsed outside the lock; this may be the autosave thread.
+    for (size_t job = 0; job < jobs.size(); ++job) {
+        ResolvePending(jobs[job].contacts, work[job]);
+    }
+    return jobs;
+}
+
+//  Feeds the autosave policy; file loads are not edits.
+void AddressBook::NoteMutation() {
+    if (autosaver_ && !loadingFile_ && !bulkEditing_) {
+        autosaver_->NoteMutation();
+    }
+}
+
+//  Commits an edited copy of a stored contact (matched by id).
+bool AddressBook::ReplaceContact(const Contact& updated) {
+    auto found = positionById_.find(updated.getId());
+    if (found == positionById_.end()) {
+        return false;
+    }
+    ReplaceAt(found->second, std::make_shared<const Contact>(updated));
+    return true;
+}
+
+//  Storage primitives: every change to contacts_ goes through InsertAt,
+//  RemoveAt or ReplaceAt, so indexes, positions, shard bookkeeping and
+//  the undo history always move together.
+void AddressBook::InsertAt(size_t position, ContactPtr stored, size_t shard) {
+    {
+        std::lock_guard<std::mutex> lock(contactsMutex_);
+        contacts_.insert(contacts_.begin() + position, stored);
+        shardOfSlot_.insert(shardOfSlot_.begin() + position, shard);
+        if (!loadingFile_) {
+            shards_[shard].dirty = true;
         }
     }
-    return nullptr;
+    RebuildPositions(position);
+    IndexContact(*stored);
+    RecordChange(History::Change{nullptr, stored, position, shard}, "Add ");
+    NoteMutation();
+}
+
+void AddressBook::RemoveAt(size_t position) {
+    const ContactPtr removed = Full(contacts_[position]);
+    const size_t shard = shardOfSlot_[position];
+    ForgetCached(removed->getId());
+    UnindexContact(*removed);
+    positionById_.erase(removed->getId());
+    {
+        std::lock_guard<std::mutex> lock(contactsMutex_);
+        shards_[shard].dirty = true;
+        pending_.erase(removed->getId());
+        contacts_.erase(contacts_.begin() + position);
+        shardOfSlot_.erase(shardOfSlot_.begin() + position);
+    }
+    RebuildPositions(position);
+    RecordChange(History::Change{removed, nullptr, position, shard}, "Delete ");
+    NoteMutation();
+}
+
+//  Copy-on-write commit: swapping one pointer leaves any snapshot (or
+//  history entry) holding the old contact untouched.
+void AddressBook::ReplaceAt(size_t position, ContactPtr replacement) {
+    const ContactPtr previous = Full(contacts_[position]);
+    const size_t shard = shardOfSlot_[position];
+    const bool labelsOnly = SameExceptLabels(*previous, *replacement);
+    ForgetCached(previous->getId());
+    if (!labelsOnly) {
+        UnindexContact(*previous);
+    }
+    {
+        std::lock_guard<std::mutex> lock(contactsMutex_);
+        contacts_[position] = replacement;
+        shards_[shard].dirty = true;
+        pending_.erase(previous->getId());
+    }
+    if (labelsOnly) {
+        ReindexLabels(*previous, *replacement);
+    } else {
+        IndexContact(*replacement);
+    }
+    RecordChange(History::Change{previous, replacement, position, shard}, "Edit ");
+    NoteMutation();
+}
+
+//  Publishes a change to the feed and journals it for undo. Loads are
+//  neither; undo/redo replays are published but not journaled again.
+void AddressBook::RecordChange(const History::Change& change, const std::string& verb) {
+    if (loadingFile_) {
+        return;
+    }
+    changeFeed_.PublishChange(change.before, change.after);
+    if (replayingHistory_) {
+        return;
+    }
+    const Contact& subject = change.after ? *change.after : *change.before;
+    history_.Record(change, verb + subject.getFullName());
 }
 
 //  Input Handling: Enables smarter searching by converting uppercase characters in an input string
@@ -57,20 +552,32 @@ ContactType StringToContactType(const std::string& typeStr) {
 
 //============================= CRUD OPERATIONS ====================================
 
+AddressBook::AddressBook()
+    : resident_(RESIDENT_RECORD_LIMIT), renderCache_(RENDER_CACHE_BYTES), history_(HISTORY_LIMIT),
+      changeFeed_(CHANGE_FEED_CAPACITY) {
+    shards_.push_back(Shard{DEFAULT_FILENAME, true, false});
+}
+
 //add contact
 void AddressBook::AddContact(const Contact& contact)
 {
-    contacts_.push_back(contact);
+    AddContactToShard(contact, activeShard_);
+}
+
+//  Stores a contact as part of the given shard (loads and new contacts).
+void AddressBook::AddContactToShard(const Contact& contact, size_t shard) {
+    InsertAt(contacts_.size(), std::make_shared<const Contact>(contact), shard);
 }
 
 //edit contact
 bool AddressBook::EditContact(int contactId, const Contact& updatedContact)
 {
-    Contact* contact = FindContactById(contactId);
+    ContactPtr contact = FindContactById(contactId);
     if (!contact) return false;
 
     // Replace fields individually (id would stay  unchanged)
-    contact->setType(updatedContact.getType())
+    Contact edited = *contact;
+    edited.setType(updatedContact.getType())
            .setFirstName(updatedContact.getFirstName())
            .setLastName(updatedContact.getLastName())
            .setEmail(updatedContact.getEmail())
@@ -80,7 +587,8 @@ bool AddressBook::EditContact(int contactId, const Contact& updatedContact)
            .setState(updatedContact.getState())
            .setPostalCode(updatedContact.getPostalCode())
            .setNotes(updatedContact.getNotes());
-    return true;
+
+    return ReplaceContact(edited);
 }
 
 /*
@@ -158,7 +666,7 @@ void AddressBook::AddContact() {
     // New contacts are pushed to end of list.
     Contact newContact(type, firstName, lastName, email, phone,
                       addressLine, city, state, postalCode, notes);
-    contacts_.push_back(newContact);
+    AddContact(newContact);
 
     // Finally, the contact is given a unique ID.
     std::cout << "\nContact added successfully with ID: " << newContact.getId() << "\n";
@@ -178,7 +686,7 @@ NOTES:
 =====================================================
 */
 bool AddressBook::EditContact(int contactId) {
-    Contact* contact = FindContactById(contactId);
+    ContactPtr contact = FindContactById(contactId);
     if (!contact) {
         return false;
     }
@@ -187,61 +695,67 @@ bool AddressBook::EditContact(int contactId) {
     std::cout << "\n=== Edit Contact (ID: " << contactId << ") ===\n";
     std::cout << "Leave blank to keep current value.\n\n";
     std::cout << "Current Information:\n";
-    std::cout << contact->toString() << "\n";
+    std::cout << renderCache_.Render(*contact, RenderCache::Format::Summary) << "\n";
+
+    // Edits go to a private copy; the stored record (and any snapshot
+    // being saved) is untouched until the copy is committed below.
+    Contact edited = *contact;
 
     std::string input;
 
     // Editing type is done through an enum
     std::cout << "\nNew Type (1=Person, 2=Business, 3=Vendor, 4=Emergency) [Current: "
-              << Contact::contactTypeToString(contact->getType()) << "]: ";
+              << Contact::contactTypeToString(edited.getType()) << "]: ";
     std::getline(std::cin, input);
     if (!input.empty()) {
         int typeChoice = std::stoi(input);
         switch (typeChoice) {
-            case 1: contact->setType(ContactType::Person); break;
-            case 2: contact->setType(ContactType::Business); break;
-            case 3: contact->setType(ContactType::Vendor); break;
-            case 4: contact->setType(ContactType::Emergency); break;
-            default: contact->setType(ContactType::Person); break;
+            case 1: edited.setType(ContactType::Person); break;
+            case 2: edited.setType(ContactType::Business); break;
+            case 3: edited.setType(ContactType::Vendor); break;
+            case 4: edited.setType(ContactType::Emergency); break;
+            default: edited.setType(ContactType::Person); break;
         }
     }
 
     // Standardized logic for editing the remaining fields
-    std::cout << "First Name [" << contact->getFirstName() << "]: ";
+    std::cout << "First Name [" << edited.getFirstName() << "]: ";
     std::getline(std::cin, input);
-    if (!input.empty()) contact->setFirstName(input);
+    if (!input.empty()) edited.setFirstName(input);
 
-    std::cout << "Last Name [" << contact->getLastName() << "]: ";
+    std::cout << "Last Name [" << edited.getLastName() << "]: ";
     std::getline(std::cin, input);
-    if (!input.empty()) contact->setLastName(input);
+    if (!input.empty()) edited.setLastName(input);
 
-    std::cout << "Email [" << contact->getEmail() << "]: ";
+    std::cout << "Email [" << edited.getEmail() << "]: ";
     std::getline(std::cin, input);
-    if (!input.empty()) contact->setEmail(input);
+    if (!input.empty()) edited.setEmail(input);
 
-    std::cout << "Phone [" << contact->getPhone() << "]: ";
+    std::cout << "Phone [" << edited.getPhone() << "]: ";
     std::getline(std::cin, input);
-    if (!input.empty()) contact->setPhone(input);
+    if (!input.empty()) edited.setPhone(input);
 
-    std::cout << "Address Line [" << contact->getAddressLine() << "]: ";
+    std::cout << "Address Line [" << edited.getAddressLine() << "]: ";
     std::getline(std::cin, input);
-    if (!input.empty()) contact->setAddressLine(input);
+    if (!input.empty()) edited.setAddressLine(input);
 
-    std::cout << "City [" << contact->getCity() << "]: ";
+    std::cout << "City [" << edited.getCity() << "]: ";
     std::getline(std::cin, input);
-    if (!input.empty()) contact->setCity(input);
+    if (!input.empty()) edited.setCity(input);
 
-    std::cout << "State [" << contact->getState() << "]: ";
+    std::cout << "State [" << edited.getState() << "]: ";
     std::getline(std::cin, input);
-    if (!input.empty()) contact->setState(input);
+    if (!input.empty()) edited.setState(input);
 
-    std::cout << "Postal Code [" << contact->getPostalCode() << "]: ";
+    std::cout << "Postal Code [" << edited.getPostalCode() << "]: ";
     std::getline(std::cin, input);
-    if (!input.empty()) contact->setPostalCode(input);
+    if (!input.empty()) edited.setPostalCode(input);
 
-    std::cout << "Notes [" << contact->getNotes() << "]: ";
+    std::cout << "Notes [" << edited.getNotes() << "]: ";
     std::getline(std::cin, input);
-    if (!input.empty()) contact->setNotes(input);
+    if (!input.empty()) edited.setNotes(input);
+
+    ReplaceContact(edited);
 
     std::cout << "\nContact updated successfully!\n";
     return true;
@@ -258,26 +772,151 @@ Returns true if contact was found and deleted, false otherwise.
 =====================================================
 */
 bool AddressBook::DeleteContact(int contactId) {
-    auto contactSearch = std::find_if(
-        contacts_.begin(),
-        contacts_.end(),
-        [contactId](const Contact& c) {
-            return c.getId() == contactId;
-        }
-    );
-
     // Contact not found
-    if (contactSearch == contacts_.end()) {
+    if (!EraseContact(contactId)) {
         return false;
     }
 
-    // Contact found
-    contacts_.erase(contactSearch);
-
     std::cout << "Contact deleted successfully.\n";
     return true;
 }
 
+//  Removes a contact from storage and every index (no console output).
+//  A lazy preview is parsed first, so undoing the delete restores the
+//  whole record.
+bool AddressBook::EraseContact(int contactId) {
+    if (!FindContactById(contactId)) {
+        return false;
+    }
+    RemoveAt(positionById_.at(contactId));
+    return true;
+}
+
+/*
+==================== MergeContacts() ============
+PURPOSE:
+Folds a duplicate record into a surviving one and deletes the duplicate.
+
+OUTPUT:
+Returns true if both contacts existed and the merge happened.
+
+NOTES:
+- Empty fields on the survivor are filled from the duplicate.
+- Differing notes are kept from both records, separated by "; ".
+- Tags and groups are unioned.
+=====================================================
+*/
+bool AddressBook::MergeContacts(int survivorId, int duplicateId) {
+    if (survivorId == duplicateId) {
+        return false;
+    }
+    ContactPtr stored = FindContactById(survivorId);
+    ContactPtr duplicate = FindContactById(duplicateId);
+    if (!stored || !duplicate) {
+        return false;
+    }
+    History::Scope revision(history_, "Merge " + duplicate->getFullName() + " into " + stored->getFullName());
+
+    Contact merged = *stored;
+
+    if (merged.getFirstName().empty()) merged.setFirstName(duplicate->getFirstName());
+    if (merged.getLastName().empty()) merged.setLastName(duplicate->getLastName());
+    if (merged.getEmail().empty()) merged.setEmail(duplicate->getEmail());
+    if (merged.getPhone().empty()) merged.setPhone(duplicate->getPhone());
+    if (merged.getAddressLine().empty()) merged.setAddressLine(duplicate->getAddressLine());
+    if (merged.getCity().empty()) merged.setCity(duplicate->getCity());
+    if (merged.getState().empty()) merged.setState(duplicate->getState());
+    if (merged.getPostalCode().empty()) merged.setPostalCode(duplicate->getPostalCode());
+    if (merged.getNotes().empty()) {
+        merged.setNotes(duplicate->getNotes());
+    } else if (!duplicate->getNotes().empty() && duplicate->getNotes() != merged.getNotes()) {
+        merged.setNotes(merged.getNotes() + "; " + duplicate->getNotes());
+    }
+    for (const auto& group : duplicate->getGroups()) {
+        merged.addGroup(group);
+    }
+    for (const auto& tag : duplicate->getTags()) {
+        merged.addTag(tag);
+    }
+
+    ReplaceContact(merged);
+
+    // Erasing shifts the vector; duplicate must not be used after this.
+    EraseContact(duplicateId);
+    return true;
+}
+
+/*
+==================== Undo() / Redo() ============
+PURPOSE:
+Reverts the most recent change (add, edit, delete, merge, tag or group
+change), or re-applies the most recently undone one.
+
+OUTPUT:
+Returns false if there is nothing to undo / redo; otherwise label
+describes what was undone / redone.
+
+NOTES:
+- Up to HISTORY_LIMIT revisions are kept. A new change clears the
+  redo list; loading the file or unloading a shard clears both.
+- Undo and redo count as edits for autosave and dirty shards.
+=====================================================
+*/
+bool AddressBook::Undo(std::string& label) {
+    History::Revision revision;
+    if (!history_.TakeUndo(revision)) {
+        return false;
+    }
+
+    // A revision may be a bulk label edit over thousands of contacts;
+    // the label index settles once at the end instead of per change.
+    // Renames were made after the changes, so they are undone first.
+    replayingHistory_ = true;
+    for (auto rename = revision.renames.rbegin(); rename != revision.renames.rend(); ++rename) {
+        RenameLabel(*rename, false);
+    }
+    labelIndex_.BeginBulkLoad();
+    for (auto change = revision.changes.rbegin(); change != revision.changes.rend(); ++change) {
+        if (!change->before) {
+            RemoveAt(change->position);
+        } else if (!change->after) {
+            InsertAt(change->position, change->before, change->shard);
+        } else {
+            ReplaceAt(change->position, change->before);
+        }
+    }
+    labelIndex_.EndBulkLoad();
+    replayingHistory_ = false;
+    label = revision.label;
+    return true;
+}
+
+bool AddressBook::Redo(std::string& label) {
+    History::Revision revision;
+    if (!history_.TakeRedo(revision)) {
+        return false;
+    }
+
+    replayingHistory_ = true;
+    labelIndex_.BeginBulkLoad();
+    for (const auto& change : revision.changes) {
+        if (!change.before) {
+            InsertAt(change.position, change.after, change.shard);
+        } else if (!change.after) {
+            RemoveAt(change.position);
+        } else {
+            ReplaceAt(change.position, change.after);
+        }
+    }
+    labelIndex_.EndBulkLoad();
+    for (const auto& rename : revision.renames) {
+        RenameLabel(rename, true);
+    }
+    replayingHistory_ = false;
+    label = revision.label;
+    return true;
+}
+
 //============================= VIEW OPERATIONS ====================================
 /*
 ==================== ListAllPreviews() ============
@@ -296,7 +935,8 @@ void AddressBook::ListAllPreviews() const {
     }
     std::cout << "\nTotal contacts: " << contacts_.size() << "\n\n";
 
-    for (const auto& contact : contacts_) {
+    for (const auto& stored : contacts_) {
+        const Contact& contact = *stored;
         std::cout << "ID: " << contact.getId()
                   << " | Name: " << contact.getFullName()
                   << " | Type: " << Contact::contactTypeToString(contact.getType())
@@ -304,6 +944,28 @@ void AddressBook::ListAllPreviews() const {
     }
 }
 
+/*
+==================== ListSorted() ============
+PURPOSE:
+Returns one page of the book in a sort order: the contacts at ranks
+[offset, offset + count).
+
+OUTPUT:
+Up to count contacts (fewer on the last page, none past the end).
+
+NOTES:
+Reads a maintained OrderIndex, so paging costs the page, not a sort
+of the book. The first call for a field builds its index once.
+=====================================================
+*/
+std::vector<Contact> AddressBook::ListSorted(const SortKey& order, size_t offset, size_t count) const {
+    return ContactsFromIds(OrderFor(order.field).Page(offset, count, order.descending));
+}
+
+size_t AddressBook::ContactCount() const {
+    return contacts_.size();
+}
+
 /*
 ==================== ViewContact() ============
 PURPOSE:
@@ -315,18 +977,43 @@ Returns true if contact found and displayed, false otherwise.
 =====================================================
 */
 bool AddressBook::ViewContact(int contactId) const {
-    const Contact* contact = FindContactById(contactId);
+    ContactPtr contact = FindContactById(contactId);
 
     if (!contact) {
         return false;
     }
 
     std::cout << "\n" << std::string(60, '=') << "\n";
-    std::cout << contact->toString(true);
+    std::cout << renderCache_.Render(*contact, RenderCache::Format::Detail);
+    if (IsSharded()) {
+        std::cout << "Shard: " << shards_[shardOfSlot_[positionById_.at(contactId)]].name << "\n";
+    }
     std::cout << std::string(60, '=') << "\n";
     return true;
 }
 
+//  Formatted text of one contact (through the view cache), for callers
+//  that do not print to the console.
+bool AddressBook::RenderContact(int contactId, RenderCache::Format format, std::string& text) const {
+    ContactPtr contact = FindContactById(contactId);
+    if (!contact) {
+        return false;
+    }
+    text = renderCache_.Render(*contact, format);
+    return true;
+}
+
+//  A new contact (with a fresh id) from record fields in file column
+//  order without the leading id: type, firstName, ..., groups, tags.
+//  Missing trailing fields are empty.
+Contact AddressBook::ContactFromFields(std::vector<std::string> fields) {
+    fields.insert(fields.begin(), std::string());
+    fields.resize(CSV_FIELD_COUNT);
+    Contact contact;
+    ApplyFields(contact, fields);
+    return contact;
+}
+
 //============================= SEARCH OPERATIONS ====================================
 
 std::vector<Contact> AddressBook::SearchByName(const std::string& nameQuery) const
@@ -337,14 +1024,16 @@ std::vector<Contact> AddressBook::SearchByName(const std::string& nameQuery) con
     * RETURN  - Vector of contacts matching the search criteria
     * DESIGN  - Searches first name, last name, and full name combinations
     ******************************************************************/
+    EnsureIndexed();
     std::vector<Contact> results;
-    for (const auto &contact : contacts_)
+    for (const auto &stored : contacts_)
     {
+        const Contact &contact = *stored;
         if (ContainsCaseInsensitive(contact.getFirstName(), nameQuery) ||
             ContainsCaseInsensitive(contact.getLastName(), nameQuery) ||
             ContainsCaseInsensitive(contact.getFullName(), nameQuery))
         {
-            results.push_back(contact);
+            results.push_back(*Full(stored));   // names are in a lazy preview
         }
     }
     return results;
@@ -356,11 +1045,27 @@ std::vector<Contact> AddressBook::SearchByEmail(const std::string &emailQuery) c
     * SUMMARY - Searches contacts by email address (case-insensitive, partial match)
     * PARAM   - emailQuery The text to search for in contact emails
     * RETURN  - Vector of contacts matching the search criteria
-    * DESIGN  - Works with matching part of the email for flexible searches
+    * DESIGN  - Works with matching part of the email for flexible searches.
+    *           "@acme.com" and "jane@" are answered by the email index
+    *           (domain incl. subdomains / exact local part); anything
+    *           else is a substring scan.
     ******************************************************************/
+    EnsureIndexed();
+    if (emailQuery.size() > 1 && emailQuery.front() == '@')
+    {
+        return SearchByEmailDomain(emailQuery, true);
+    }
+    if (emailQuery.size() > 1 && emailQuery.back() == '@' &&
+        emailQuery.find('@') == emailQuery.size() - 1)
+    {
+        return SearchByEmailLocalPart(emailQuery);
+    }
+
     std::vector<Contact> results;
-    for (const auto &contact : contacts_)
+    for (const auto &stored : contacts_)
     {
+        const ContactPtr full = Full(stored);
+        const Contact &contact = *full;
         if (ContainsCaseInsensitive(contact.getEmail(), emailQuery))
         {
             results.push_back(contact);
@@ -372,81 +1077,465 @@ std::vector<Contact> AddressBook::SearchByEmail(const std::string &emailQuery) c
 std::vector<Contact> AddressBook::SearchByPhone(const std::string &phoneQuery) const
 {
     /******************************************************************
-    * SUMMARY - Searches contacts by phone number (case-insensitive, partial match)
-    * PARAM   - phoneQuery The text to search for in contact phone numbers
+    * SUMMARY - Searches contacts by phone number, ignoring formatting
+    * PARAM   - phoneQuery Digits to match; "(949) 555-1234" == "9495551234"
     * RETURN  - Vector of contacts matching the search criteria
-    * DESIGN  - Works with matching part of the phone number for flexible searches
+    * DESIGN  - Digits match anywhere in the number; "*1234" asks for
+    *           numbers ending in 1234 (SearchByPhoneSuffix). The phone
+    *           index answers from its suffix buckets when only a
+    *           suffix can match and scans its compact digit column
+    *           otherwise; results come back in storage order either
+    *           way. A query with no digits at all falls back to the
+    *           raw text match.
     ******************************************************************/
-    std::vector<Contact> results;
-    for (const auto &contact : contacts_)
+    EnsureIndexed();
+    if (phoneQuery.size() > 1 && phoneQuery.front() == '*')
+    {
+        return SearchByPhoneSuffix(phoneQuery.substr(1));
+    }
+    if (PhoneIndex::Canonicalize(phoneQuery) == 0)
     {
-        if (ContainsCaseInsensitive(contact.getPhone(), phoneQuery))
+        std::vector<Contact> results;
+        for (const auto &stored : contacts_)
         {
-            results.push_back(contact);
+            const ContactPtr full = Full(stored);
+            const Contact &contact = *full;
+            if (ContainsCaseInsensitive(contact.getPhone(), phoneQuery))
+            {
+                results.push_back(contact);
+            }
         }
+        return results;
     }
-    return results;
+
+    std::vector<int> contactIds = phoneIndex_.MatchDigits(phoneQuery);
+    SortByPosition(contactIds);
+    return ContactsFromIds(contactIds);
 }
 
-//============================= FILTER OPERATIONS ====================================
+std::vector<Contact> AddressBook::SearchByPhoneSuffix(const std::string& digits) const
+{
+    /******************************************************************
+    * SUMMARY - Contacts whose phone number ends with the given digits
+    * PARAM   - digits Trailing digits in any formatting ("555-1234")
+    * RETURN  - Vector of matching contacts, in storage order; empty if
+    *           digits has none
+    * DESIGN  - Answered from the last-4 / last-7 suffix buckets
+    ******************************************************************/
+    EnsureIndexed();
+    std::vector<int> contactIds = phoneIndex_.MatchSuffix(digits);
+    SortByPosition(contactIds);
+    return ContactsFromIds(contactIds);
+}
 
-std::vector<Contact> AddressBook::FilterByType(const std::string& type) const
+std::vector<Contact> AddressBook::SearchByEmailDomain(const std::string& domain, bool includeSubdomains) const
 {
     /******************************************************************
-    * SUMMARY - Filters contacts by exact match to type
-    * PARAM   - type The contact type to filter by ("Person", "Business", etc.)
-    * RETURN  - Vector of contacts of specified type
-    * DESIGN  - Exact type matching ensures precise category filtering
+    * SUMMARY - Everyone at a domain ("acme.com" or "@acme.com")
+    * PARAM   - domain The email domain, case-insensitive
+    * PARAM   - includeSubdomains Also return *.acme.com addresses
+    * RETURN  - Vector of contacts at the domain
+    * DESIGN  - Hash probe (exact) or sorted reversed-domain range scan
     ******************************************************************/
-    std::vector<Contact> results;
-    for (const auto &contact : contacts_)
-    {
-        if (Contact::contactTypeToString(contact.getType()) == type)
-        {
-            results.push_back(contact);
-        }
-    }
-    return results;
+    EnsureIndexed();
+    return ContactsFromIds(emailIndex_.ByDomain(domain, includeSubdomains));
 }
 
-std::vector<Contact> AddressBook::FilterByCity(const std::string& city) const
+std::vector<Contact> AddressBook::SearchByEmailLocalPart(const std::string& localPart) const
 {
     /******************************************************************
-    * SUMMARY - Filters contacts by city (case-insensitive, partial match)
-    * PARAM   - city The city name to filter by
-    * RETURN  - Vector of contacts located in the specified city
-    * DESIGN  - Case-insensitive matching for city
+    * SUMMARY - Addresses with the given local part in any domain
+    * PARAM   - localPart Text before the '@' (trailing '@' optional)
+    * RETURN  - Vector of contacts with that local part
+    * DESIGN  - Single hash probe on the split local part
     ******************************************************************/
-    std::vector<Contact> results;
-    for (const auto &contact : contacts_)
-    {
-        if (ContainsCaseInsensitive(contact.getCity(), city))
+    EnsureIndexed();
+    return ContactsFromIds(emailIndex_.ByLocalPart(localPart));
+}
+
+ContactPtr AddressBook::FindByCallerId(const std::string& phoneNumber) const
+{
+    /******************************************************************
+    * SUMMARY - Caller-id lookup for telephony integrations
+    * PARAM   - phoneNumber The full number in any formatting
+    * RETURN  - First contact with exactly that number, or nullptr
+    * DESIGN  - One canonicalization and one hash probe (a second one
+    *           with or without a leading country code 1); no copies
+    ******************************************************************/
+    EnsureIndexed();
+    const std::vector<int>* contactIds = phoneIndex_.Exact(phoneNumber);
+    if (!contactIds || contactIds->empty())
+    {
+        return nullptr;
+    }
+    return FindContactById(contactIds->front());
+}
+
+std::vector<Contact> AddressBook::SuggestByPrefix(const std::string& prefix, size_t limit) const
+{
+    /******************************************************************
+    * SUMMARY - Type-ahead completion on first/last/full name and email
+    * PARAM   - prefix The text typed so far (case-insensitive)
+    * PARAM   - limit Maximum number of suggestions returned
+    * RETURN  - Up to `limit` contacts, ordered by the matching key
+    * DESIGN  - Served by the prefix index; no scan over contacts_
+    ******************************************************************/
+    EnsureIndexed();
+    return ContactsFromIds(prefixIndex_.Complete(prefix, limit));
+}
+
+std::vector<Contact> AddressBook::SearchByNameFuzzy(const std::string& nameQuery, int maxDistance, size_t limit) const
+{
+    /******************************************************************
+    * SUMMARY - Typo-tolerant name search ("Jonh Smtih" finds "John Smith")
+    * PARAM   - nameQuery The name as typed (case-insensitive)
+    * PARAM   - maxDistance Maximum edits allowed (insert/delete/substitute/swap)
+    * PARAM   - limit Maximum number of results (top-K)
+    * RETURN  - Contacts ranked by edit distance, closest first
+    * DESIGN  - BK-tree prunes by the triangle inequality, so only a
+    *           fraction of the names are ever compared to the query
+    ******************************************************************/
+    EnsureIndexed();
+    std::vector<int> contactIds;
+    for (const auto& match : fuzzyIndex_.Search(nameQuery, maxDistance, limit))
+    {
+        contactIds.push_back(match.contactId);
+    }
+    return ContactsFromIds(contactIds);
+}
+
+std::vector<Contact> AddressBook::SearchBySoundsLike(const std::string& nameQuery) const
+{
+    /******************************************************************
+    * SUMMARY - Finds names that sound like the query ("Smyth" -> "Smith")
+    * PARAM   - nameQuery "First Last" (both must match) or a single name
+    * RETURN  - Vector of contacts whose Soundex codes match
+    * DESIGN  - Codes are computed once per contact at insert/edit time;
+    *           a lookup is a hash hit, not a pass over contacts_
+    ******************************************************************/
+    EnsureIndexed();
+    return ContactsFromIds(phoneticIndex_.Lookup(nameQuery));
+}
+
+std::vector<Contact> AddressBook::SearchText(const std::string& query) const
+{
+    /******************************************************************
+    * SUMMARY - Full-text search of names, street addresses and notes
+    * PARAM   - query Words that must all occur (any case, any order);
+    *           "quoted words" must occur together in that order, e.g.
+    *           prefers "morning delivery"
+    * RETURN  - Matching contacts, by id
+    * DESIGN  - Positional inverted index with variable-byte postings,
+    *           built on first use and maintained from then on; words
+    *           are stemmed unless SetStemming(false) was called
+    ******************************************************************/
+    EnsureIndexed();
+    return ContactsFromIds(TextIndex().Search(query));
+}
+
+std::vector<AddressBook::RankedMatch> AddressBook::SearchRanked(const std::string& query, size_t limit,
+                                                                const Relevance::Scorer& scorer,
+                                                                unsigned threadCount) const
+{
+    /******************************************************************
+    * SUMMARY - Best matches first, for broad queries with many hits
+    * PARAM   - query Words to look for in name, email and notes
+    * PARAM   - limit Maximum number of results (top-K)
+    * PARAM   - scorer Relevance rule; Relevance::DefaultScore weighs
+    *           exact > prefix > substring and name > email > notes
+    * PARAM   - threadCount Threads to use (0 = one per core)
+    * RETURN  - Up to `limit` contacts with a positive score, highest
+    *           first; equal scores in storage order
+    * DESIGN  - Every contact is scored, but only the best `limit` are
+    *           kept (a bounded heap per chunk of contacts, merged at
+    *           the end), so the full match set is never sorted or
+    *           copied
+    ******************************************************************/
+    EnsureIndexed();
+    const Relevance::Query parsed = Relevance::ParseQuery(query);
+    if (parsed.terms.empty() || limit == 0)
+    {
+        return {};
+    }
+
+    const size_t chunks = (contacts_.size() + SCAN_CHUNK_CONTACTS - 1) / SCAN_CHUNK_CONTACTS;
+    std::vector<Relevance::TopK> perChunk(chunks, Relevance::TopK(limit));
+    WorkStealing::ParallelFor(chunks, threadCount, [&](size_t chunk) {
+        const size_t end = std::min(contacts_.size(), (chunk + 1) * SCAN_CHUNK_CONTACTS);
+        for (size_t position = chunk * SCAN_CHUNK_CONTACTS; position < end; ++position)
         {
-            results.push_back(contact);
+            const double score = scorer(*Full(contacts_[position]), parsed);
+            if (score > 0.0)
+            {
+                perChunk[chunk].Offer(score, position);
+            }
         }
+    });
+
+    Relevance::TopK best(limit);
+    for (const auto& chunk : perChunk)
+    {
+        best.Merge(chunk);
+    }
+    std::vector<RankedMatch> results;
+    for (const auto& hit : best.Take())
+    {
+        results.push_back(RankedMatch{*Full(contacts_[hit.item]), hit.score});
     }
     return results;
 }
 
-std::vector<Contact> AddressBook::FilterByTag(const std::string& tag) const
+std::vector<std::vector<Contact>> AddressBook::SearchBatch(const std::vector<BatchQuery>& queries,
+                                                           unsigned threadCount) const
 {
     /******************************************************************
-    * SUMMARY - Filters contacts by exact match to tag (case-insensitive, partial match)
-    * PARAM   - tag The tag name to filter by
-    * RETURN  - Vector of contacts with the specified tag
-    * DESIGN  - Exact tag matching ensures precise tag consistency
+    * SUMMARY - Runs many lookups at once (e.g. an inbound call list
+    *           matched with CallerId queries)
+    * PARAM   - queries The lookups; each is answered as its Search*
+    *           method would answer it alone
+    * PARAM   - threadCount Threads to use (0 = one per core)
+    * RETURN  - One result list per query, in input order
+    * DESIGN  - Indexed once up front, after which the const searches
+    *           only read, so they run on a work-stealing scheduler
+    *           without locks. Each query writes its own result slot,
+    *           so order needs no merging. Queries that would each scan
+    *           contacts_ (name, email substring, phone text) share a
+    *           single pass instead; see ScanOnce().
+    ******************************************************************/
+    EnsureIndexed();
+    std::vector<std::vector<Contact>> results(queries.size());
+    std::vector<bool> scanned(queries.size());
+    bool anyScanned = false;
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        scanned[i] = NeedsScan(queries[i]);
+        anyScanned = anyScanned || scanned[i];
+    }
+    if (anyScanned)
+    {
+        for (const auto& match : ScanOnce(queries, scanned, threadCount))
+        {
+            for (size_t query : match.second)
+            {
+                results[query].push_back(*Full(contacts_[match.first]));
+            }
+        }
+    }
+
+    WorkStealing::ParallelFor(queries.size(), threadCount, [&](size_t i) {
+        if (scanned[i])
+        {
+            return;
+        }
+        const BatchQuery& query = queries[i];
+        switch (query.kind)
+        {
+            case BatchQuery::Kind::Name:           results[i] = SearchByName(query.text); break;
+            case BatchQuery::Kind::Email:          results[i] = SearchByEmail(query.text); break;
+            case BatchQuery::Kind::Phone:          results[i] = SearchByPhone(query.text); break;
+            case BatchQuery::Kind::PhoneSuffix:    results[i] = SearchByPhoneSuffix(query.text); break;
+            case BatchQuery::Kind::EmailDomain:    results[i] = SearchByEmailDomain(query.text, true); break;
+            case BatchQuery::Kind::EmailLocalPart: results[i] = SearchByEmailLocalPart(query.text); break;
+            case BatchQuery::Kind::SoundsLike:     results[i] = SearchBySoundsLike(query.text); break;
+            case BatchQuery::Kind::Prefix:         results[i] = SuggestByPrefix(query.text, query.limit); break;
+            case BatchQuery::Kind::Fuzzy:
+                results[i] = SearchByNameFuzzy(query.text, query.maxDistance, query.limit);
+                break;
+            case BatchQuery::Kind::CallerId:
+                if (ContactPtr caller = FindByCallerId(query.text))
+                {
+                    results[i].push_back(*caller);
+                }
+                break;
+        }
+    });
+    return results;
+}
+
+std::vector<AddressBook::WatchMatch> AddressBook::MatchWatchList(const std::vector<BatchQuery>& queries,
+                                                                 unsigned threadCount) const
+{
+    /******************************************************************
+    * SUMMARY - Checks the whole book against a watch list of searches
+    * PARAM   - queries Name / Email / Phone queries, each a plain
+    *           case-insensitive substring of that field (other kinds
+    *           match nothing)
+    * PARAM   - threadCount Threads to use (0 = one per core)
+    * RETURN  - Every contact that matched at least one query, in
+    *           storage order, tagged with the queries it matched
+    * DESIGN  - The contacts are read once, however long the list is
+    ******************************************************************/
+    EnsureIndexed();
+    std::vector<bool> selected(queries.size());
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        selected[i] = queries[i].kind == BatchQuery::Kind::Name || queries[i].kind == BatchQuery::Kind::Email ||
+                      queries[i].kind == BatchQuery::Kind::Phone;
+    }
+
+    std::vector<WatchMatch> matches;
+    for (auto& match : ScanOnce(queries, selected, threadCount))
+    {
+        matches.push_back(WatchMatch{*Full(contacts_[match.first]), std::move(match.second)});
+    }
+    return matches;
+}
+
+std::vector<DuplicateFinder::MergeProposal> AddressBook::FindDuplicates(double minScore) const
+{
+    /******************************************************************
+    * SUMMARY - Proposes likely duplicate pairs for merging
+    * PARAM   - minScore Similarity threshold, 0.0 - 1.0
+    * RETURN  - Merge proposals, most similar first
+    * DESIGN  - Blocking on phone / email / phonetic name + ZIP keeps the
+    *           work near-linear; blocks are scored on all cores. A
+    *           lazy book's previews are parsed for the duration only.
+    ******************************************************************/
+    EnsureIndexed();
+    if (pending_.empty())
+    {
+        return DuplicateFinder::Find(contacts_, minScore);
+    }
+    return DuplicateFinder::Find(Snapshot(), minScore);
+}
+
+//============================= FILTER OPERATIONS ====================================
+
+std::vector<Contact> AddressBook::FilterByType(const std::string& type) const
+{
+    /******************************************************************
+    * SUMMARY - Filters contacts by exact match to type
+    * PARAM   - type The contact type to filter by ("Person", "Business", etc.)
+    * RETURN  - Vector of contacts of specified type
+    * DESIGN  - Exact type matching ensures precise category filtering
     ******************************************************************/
+    EnsureIndexed();
     std::vector<Contact> results;
-    for (const auto &contact : contacts_)
+    for (const auto &stored : contacts_)
     {
-        if (contact.hasTag(tag))
+        const Contact &contact = *stored;
+        if (Contact::contactTypeToString(contact.getType()) == type)
         {
-            results.push_back(contact);
+            results.push_back(*Full(stored));   // the type is in a lazy preview
         }
     }
     return results;
 }
 
+std::vector<Contact> AddressBook::FilterByCity(const std::string& city) const
+{
+    /******************************************************************
+    * SUMMARY - Filters contacts by city (case-insensitive, partial match)
+    * PARAM   - city The city name to filter by
+    * RETURN  - Vector of contacts located in the specified city
+    * DESIGN  - Case-insensitive matching for city, evaluated against the
+    *           location index's distinct city names rather than every
+    *           contact
+    ******************************************************************/
+    EnsureIndexed();
+    if (city.empty())
+    {
+        return CopyAllContacts();
+    }
+    return ContactsFromIds(locationIndex_.ByCityContaining(city));
+}
+
+std::vector<Contact> AddressBook::FilterByState(const std::string& state) const
+{
+    /******************************************************************
+    * SUMMARY - Filters contacts by state (case-insensitive, exact match)
+    * PARAM   - state The state / region to filter by
+    * RETURN  - Vector of contacts in that state
+    * DESIGN  - Union of the state's per-city posting lists
+    ******************************************************************/
+    EnsureIndexed();
+    return ContactsFromIds(locationIndex_.ByState(state));
+}
+
+std::vector<Contact> AddressBook::FilterByPostalRange(int lowZip, int highZip) const
+{
+    /******************************************************************
+    * SUMMARY - Filters contacts by 5-digit ZIP range (inclusive)
+    * PARAM   - lowZip / highZip Range bounds, e.g. 92600 and 92699
+    * RETURN  - Vector of contacts whose ZIP is within the range
+    * DESIGN  - Two binary searches over the sorted ZIP array
+    ******************************************************************/
+    EnsureIndexed();
+    return ContactsFromIds(locationIndex_.ByPostalRange(lowZip, highZip));
+}
+
+std::vector<Contact> AddressBook::FilterByRegion(const std::string& state, const std::string& city,
+                                                 int lowZip, int highZip) const
+{
+    /******************************************************************
+    * SUMMARY - Combined regional filter for mailing campaigns
+    * PARAM   - state Exact state, or empty for any
+    * PARAM   - city Exact city, or empty for any
+    * PARAM   - lowZip / highZip Inclusive ZIP range, or negative for any
+    * RETURN  - Vector of contacts satisfying every given constraint
+    * DESIGN  - Each constraint yields a sorted posting list from the
+    *           location index; the lists are intersected
+    ******************************************************************/
+    EnsureIndexed();
+    std::vector<std::vector<int>> postings;
+    if (!state.empty() && !city.empty())
+    {
+        postings.push_back(locationIndex_.ByStateCity(state, city));
+    }
+    else if (!state.empty())
+    {
+        postings.push_back(locationIndex_.ByState(state));
+    }
+    else if (!city.empty())
+    {
+        postings.push_back(locationIndex_.ByCity(city));
+    }
+    if (lowZip >= 0 && highZip >= 0)
+    {
+        postings.push_back(locationIndex_.ByPostalRange(lowZip, highZip));
+    }
+
+    if (postings.empty())
+    {
+        return CopyAllContacts();
+    }
+
+    std::vector<int> matched = postings.front();
+    for (size_t i = 1; i < postings.size(); ++i)
+    {
+        std::vector<int> narrowed;
+        std::set_intersection(matched.begin(), matched.end(),
+                              postings[i].begin(), postings[i].end(),
+                              std::back_inserter(narrowed));
+        matched.swap(narrowed);
+    }
+    return ContactsFromIds(matched);
+}
+
+std::vector<Contact> AddressBook::FilterByTag(const std::string& tag) const
+{
+    /******************************************************************
+    * SUMMARY - Filters contacts by exact match to tag (case-sensitive)
+    * PARAM   - tag The tag name to filter by
+    * RETURN  - Vector of contacts with the specified tag
+    * DESIGN  - Reads the tag's posting list in labelIndex_; only the
+    *           holders are touched, not the whole book
+    ******************************************************************/
+    EnsureIndexed();
+    return ContactsFromIds(labelIndex_.WithTag(tag));
+}
+
+std::vector<Contact> AddressBook::FilterByGroup(const std::string& group) const
+{
+    /******************************************************************
+    * SUMMARY - Filters contacts by exact group membership (case-sensitive)
+    * PARAM   - group The group name to filter by
+    * RETURN  - Vector of the group's members
+    ******************************************************************/
+    EnsureIndexed();
+    return ContactsFromIds(labelIndex_.InGroup(group));
+}
+
 void AddressBook::DisplaySearchResults(const std::vector<Contact>& results, const std::string& searchType) const
 {
     /******************************************************************
@@ -472,10 +1561,19 @@ void AddressBook::DisplaySearchResults(const std::vector<Contact>& results, cons
         return;
     }
 
+    // Optional user-chosen order (SetResultOrder); otherwise as found
+    std::vector<Contact> ordered;
+    if (!resultOrder_.empty())
+    {
+        ordered = results;
+        SortContacts(ordered, resultOrder_);
+    }
+    const std::vector<Contact>& shown = resultOrder_.empty() ? results : ordered;
+
     // Preview Contacts display
     for (int i = 0; i < results.size(); ++i)
     {
-        const Contact &contact = results[i];
+        const Contact &contact = shown[i];
 
         // Contact header
         std::cout << "\n" << std::string(25, '-') << std::endl;
@@ -530,12 +1628,15 @@ Returns false if contact not found or tag already exists.
 =====================================================
 */
 bool AddressBook::AddTag(int contactId, const std::string& tag) {
-    Contact* contact = FindContactById(contactId);
+    ContactPtr contact = FindContactById(contactId);
     if (!contact) {
         return false;
     }
-    bool success = contact->addTag(tag);
+    Contact edited = *contact;
+    bool success = edited.addTag(tag);
     if (success) {
+        History::Scope revision(history_, "Add tag '" + tag + "' to " + edited.getFullName());
+        ReplaceContact(edited);
         std::cout << "Tag '" << tag << "' added to contact " << contactId << ".\n";
     } else {
         std::cout << "Tag already exists or is empty.\n";
@@ -552,14 +1653,17 @@ Removes a tag from a specific contact with matching ID.
 =====================================================
 */
 bool AddressBook::RemoveTag(int contactId, const std::string& tag) {
-    Contact* contact = FindContactById(contactId);
+    ContactPtr contact = FindContactById(contactId);
 
     // Contact list is empty
     if (!contact) {
         return false;
     }
-    bool success = contact->removeTag(tag);
+    Contact edited = *contact;
+    bool success = edited.removeTag(tag);
     if (success) {
+        History::Scope revision(history_, "Remove tag '" + tag + "' from " + edited.getFullName());
+        ReplaceContact(edited);
         std::cout << "Tag '" << tag << "' removed from contact " << contactId << ".\n";
     } else {
         std::cout << "Tag not found.\n";
@@ -575,12 +1679,15 @@ Assigns a contact to a group by ID.
 =====================================================
 */
 bool AddressBook::AssignToGroup(int contactId, const std::string& group) {
-    Contact* contact = FindContactById(contactId);
+    ContactPtr contact = FindContactById(contactId);
     if (!contact) {
         return false;
     }
-    bool success = contact->addGroup(group);
+    Contact edited = *contact;
+    bool success = edited.addGroup(group);
     if (success) {
+        History::Scope revision(history_, "Add " + edited.getFullName() + " to group " + group);
+        ReplaceContact(edited);
         std::cout << "Contact " << contactId << " assigned to group '" << group << "'.\n";
     } else {
         std::cout << "Group already assigned or is empty.\n";
@@ -597,12 +1704,15 @@ Removes a contact from a group by ID.
 =====================================================
 */
 bool AddressBook::RemoveFromGroup(int contactId, const std::string& group) {
-    Contact* contact = FindContactById(contactId);
+    ContactPtr contact = FindContactById(contactId);
     if (!contact) {
         return false;
     }
-    bool result = contact->removeGroup(group);
+    Contact edited = *contact;
+    bool result = edited.removeGroup(group);
     if (result) {
+        History::Scope revision(history_, "Remove " + edited.getFullName() + " from group " + group);
+        ReplaceContact(edited);
         std::cout << "Contact " << contactId << " removed from group '" << group << "'.\n";
     } else {
         std::cout << "Group not found.\n";
@@ -610,189 +1720,1247 @@ bool AddressBook::RemoveFromGroup(int contactId, const std::string& group) {
     return result;
 }
 
-//============================= FILE I/O OPERATIONS ====================================
-
 /*
-==================== LoadFromFile() ============
+==================== RemoveTagFromAll() ============
 PURPOSE:
-Loads contacts from a CSV file named "addressbook.csv".
+Removes a tag from every contact that carries it, as one undoable
+revision.
 
-NOTES:
-- File name is hardcoded as "addressbook.csv".
-- Parses CSV format with pipe-delimited groups and tags.
+OUTPUT:
+Returns the number of contacts changed (0 if nobody had the tag).
 
+NOTES:
+The holders come from the tag's posting list, so contacts without
+the tag are never visited or copied.
 =====================================================
 */
-void AddressBook::LoadFromFile() {
-    std::ifstream file(DEFAULT_FILENAME);
-
-    // Will always run for a new user
-    if (!file.is_open()) {
-        std::cout << "No existing file found. Created new file.\n";
-        return;
-    }
-
-    contacts_.clear();
-    std::string line;
-    int lineCount = 0;
-
-    while (std::getline(file, line)) {
-        lineCount++;
-
-        if (line.empty()) continue;
-
-        std::stringstream ss(line);
-        std::string token;
-        std::vector<std::string> fields;
-
-        // Parse CSV line
-        while (std::getline(ss, token, ',')) {
-            fields.push_back(token);
-        }
-
-        // Fills fields: id, type, firstName, lastName, email, phone,
-        //               addressLine, city, state, postalCode, notes, groups, tags
-        try {
-            int id = std::stoi(fields[0]);
-            ContactType type = StringToContactType(fields[1]);
-
-            Contact contact(type, fields[2], fields[3], fields[4], fields[5],
-                          fields[6], fields[7], fields[8], fields[9], fields[10]);
-
-            // Parse groups (pipe-delimited)
-            if (!fields[11].empty()) {
-                std::stringstream groupStream(fields[11]);
-                std::string group;
-                while (std::getline(groupStream, group, '|')) {
-                    if (!group.empty()) {
-                        contact.addGroup(group);
-                    }
-                }
-            }
-
-            // Parse tags (pipe-delimited)
-            if (!fields[12].empty()) {
-                std::stringstream tagStream(fields[12]);
-                std::string tag;
-                while (std::getline(tagStream, tag, '|')) {
-                    if (!tag.empty()) {
-                        contact.addTag(tag);
-                    }
-                }
-            }
-
-            contacts_.push_back(contact);
-
-        } catch (const std::exception& error) {
-            std::cout << "Error parsing line " << lineCount << ": " << error.what() << "\n";
-        }
-    }
-
-    file.close();
-    std::cout << "Loaded " << contacts_.size() << " contacts from " << DEFAULT_FILENAME << "\n";
+size_t AddressBook::RemoveTagFromAll(const std::string& tag) {
+    return EditLabelsForAll(LabelEdit{LabelEdit::Action::Remove, false, tag, std::string()});
 }
 
 /*
-==================== SaveToFile() ============
+==================== RemoveGroupFromAll() ============
 PURPOSE:
-Saves all contacts to a CSV file named "addressbook.csv".
+Dissolves a group: removes it from every member, as one undoable
+revision.
 
-NOTES:
-File name is hardcoded as "addressbook.csv".
+OUTPUT:
+Returns the number of contacts changed (0 if the group was empty).
 =====================================================
 */
-void AddressBook::SaveToFile() const {
-    std::ofstream file(DEFAULT_FILENAME);
-
-    if (!file.is_open()) {
-        std::cout << "Error: Could not open file.\n";
-        return;
-    }
-
-    for (const auto& contact : contacts_) {
-        file << contact.toCSV() << "\n";
-    }
-
-    file.close();
-    std::cout << "Saved " << contacts_.size() << " contacts to " << DEFAULT_FILENAME << "\n";
+size_t AddressBook::RemoveGroupFromAll(const std::string& group) {
+    return EditLabelsForAll(LabelEdit{LabelEdit::Action::Remove, true, group, std::string()});
 }
 
-
-//============================= REPORTS ====================================
 /*
-==================== ReportMissingInfo() ============
+==================== EditLabels() ============
 PURPOSE:
-This function scans through the contacts in the address book and sees whether
-they have an email or phone number.
+Applies, removes or renames one tag or group on a set of contacts:
+an id list (typically the ids of a search or filter result) or the
+whole book (EditLabelsForAll).
 
 OUTPUT:
-Displays the ID/NAME/TYPE of each contacts missing an email or phone number
-as well as the total number of contacts.
+Returns the number of contacts changed. The whole edit is a single
+undoable revision.
 
 NOTES:
-- Uses a for loop that scans the contacts for the length of the contact list.
-  If getEmail() or getPhone() is empty it outputs the contact's ID/NAME/TYPE
-
+Remove / Rename only visit contacts on the label's posting list and
+Apply skips contacts that already carry it, so the work is bounded
+by the contacts that actually change. Those edits touch only the
+label index, which runs in bulk mode for the duration, and the
+autosaver is told the total once at the end.
+A Rename that covers every holder, to a name no contact carries,
+copies no contact at all: it renames the label's dictionary entry
+(CommitLabelRename). Renaming onto a label in use merges the two,
+which is done contact by contact.
 =====================================================
 */
-void AddressBook::ReportMissingInfo() const
-{
-
-    std::cout << "\n=== Contacts Missing Information ===\n\n";
+size_t AddressBook::EditLabels(const std::vector<int>& contactIds, const LabelEdit& edit) {
+    EnsureIndexed();
+    if (edit.label.empty() ||
+        (edit.action == LabelEdit::Action::Rename && (edit.newLabel.empty() || edit.newLabel == edit.label))) {
+        return 0;
+    }
+    std::vector<int> selected = contactIds;
+    std::sort(selected.begin(), selected.end());
+    selected.erase(std::unique(selected.begin(), selected.end()), selected.end());
+
+    const std::vector<int> holders = edit.group ? labelIndex_.InGroup(edit.label)
+                                                : labelIndex_.WithTag(edit.label);
+    std::vector<int> targets;
+    if (edit.action == LabelEdit::Action::Apply) {
+        std::set_difference(selected.begin(), selected.end(), holders.begin(), holders.end(),
+                            std::back_inserter(targets));
+    } else {
+        std::set_intersection(selected.begin(), selected.end(), holders.begin(), holders.end(),
+                              std::back_inserter(targets));
+    }
+    if (edit.action == LabelEdit::Action::Rename && !targets.empty() && targets.size() == holders.size() &&
+        (edit.group ? labelIndex_.InGroup(edit.newLabel) : labelIndex_.WithTag(edit.newLabel)).empty()) {
+        return CommitLabelRename(edit, targets.size());
+    }
+    return CommitLabelEdit(targets, edit);
+}
 
-    // Keeps track of how many contacts have missing info
-    int count = 0;
+size_t AddressBook::EditLabelsForAll(const LabelEdit& edit) {
+    EnsureIndexed();
+    if (edit.action != LabelEdit::Action::Apply) {
+        return EditLabels(edit.group ? labelIndex_.InGroup(edit.label) : labelIndex_.WithTag(edit.label), edit);
+    }
+    std::vector<int> contactIds;
+    contactIds.reserve(contacts_.size());
+    for (const auto& stored : contacts_) {
+        contactIds.push_back(stored->getId());
+    }
+    return EditLabels(contactIds, edit);
+}
 
-    // For loop running contact list length
-    for (const auto& contact : contacts_) {
+//  Commits a bulk label edit over contacts known to change. Every copy
+//  goes through ReplaceAt (journal, change feed, dirty shard), which
+//  sees a labels-only change and leaves the other indexes alone.
+size_t AddressBook::CommitLabelEdit(const std::vector<int>& contactIds, const LabelEdit& edit) {
+    if (contactIds.empty()) {
+        return 0;
+    }
+    History::Scope revision(history_, DescribeLabelEdit(edit, contactIds.size()));
+    size_t changed = 0;
+    bulkEditing_ = true;
+    labelIndex_.BeginBulkLoad();
+    for (int contactId : contactIds) {
+        auto found = positionById_.find(contactId);
+        if (found == positionById_.end()) {
+            continue;
+        }
+        Contact edited = *Full(contacts_[found->second]);
+        if (ApplyLabelEdit(edited, edit)) {
+            ReplaceAt(found->second, std::make_shared<const Contact>(std::move(edited)));
+            ++changed;
+        }
+    }
+    labelIndex_.EndBulkLoad();
+    bulkEditing_ = false;
+    if (autosaver_ && !loadingFile_) {
+        autosaver_->NoteMutation(changed);
+    }
+    return changed;
+}
 
-        // Conditional statement using empty() to see if retrieved email and phone
-        // for contact is empty and if so it runs.
-        if (contact.getEmail().empty() || contact.getPhone().empty())
-        {
+//  Commits a rename of every holder of a label as one dictionary rename,
+//  journaled so that undo renames the entry back.
+size_t AddressBook::CommitLabelRename(const LabelEdit& edit, size_t holders) {
+    LabelDictionary::Id id;
+    if (!(edit.group ? LabelDictionary::Groups() : LabelDictionary::Tags()).Find(edit.label, id)) {
+        return 0;
+    }
+    const History::Rename rename {edit.group, id, edit.label, edit.newLabel};
+    RenameLabel(rename, true);
+    history_.RecordRename(rename, DescribeLabelEdit(edit, holders));
+    return holders;
+}
 
-            //Displays the basic info
-            std::cout << "ID: " << contact.getId()
-                << " | " << contact.getFullName()
-                << " | " << Contact::contactTypeToString(contact.getType())
-                << "\n";
+//  Applies a label rename (or, with forward false, reverses it) to the
+//  book: the dictionary entry changes, the holders' shards become dirty
+//  and cached renderings are dropped; no contact is copied. A save in
+//  progress (this book's or another's) finishes first, since it reads
+//  names from the same dictionary.
+//  Replaying the journal can find the target name back in use, through
+//  a shard loaded in the meantime. Those holders are moved onto the
+//  renamed id first (contact by contact), which the journal cannot
+//  reverse, so it is cleared.
+void AddressBook::RenameLabel(const History::Rename& rename, bool forward) {
+    const std::string& from = forward ? rename.from : rename.to;
+    const std::string& to = forward ? rename.to : rename.from;
+
+    const std::vector<int> taken = rename.group ? labelIndex_.InGroup(to) : labelIndex_.WithTag(to);
+    if (!taken.empty()) {
+        for (int contactId : taken) {
+            const size_t position = positionById_.at(contactId);
+            Contact edited = *Full(contacts_[position]);
+            if (ApplyLabelEdit(edited, LabelEdit{LabelEdit::Action::Rename, rename.group, to, from})) {
+                ReplaceAt(position, std::make_shared<const Contact>(std::move(edited)));
+            }
+        }
+        history_.Clear();
+    }
 
-            // Count is then added for the amount of empty contacts
-            count++;
+    const std::vector<int> holders = rename.group ? labelIndex_.InGroup(from) : labelIndex_.WithTag(from);
+    {
+        std::lock_guard<std::mutex> lock(contactsMutex_);
+        for (int contactId : holders) {
+            shards_[shardOfSlot_[positionById_.at(contactId)]].dirty = true;
         }
     }
+    (rename.group ? LabelDictionary::Groups() : LabelDictionary::Tags()).Rename(rename.id, to);
+    renderCache_.Clear();
+    changeFeed_.PublishRename(rename.group, from, to);
+    if (autosaver_ && !loadingFile_) {
+        autosaver_->NoteMutation(holders.size());
+    }
+}
 
-    // Displays the amount of contacts with missing info
-    std::cout << "\nTotal: " << count << " contacts missing email or phone\n";
+//  Journal label for a bulk edit, in the wording of the single-contact
+//  AddTag / AssignToGroup entries.
+std::string AddressBook::DescribeLabelEdit(const LabelEdit& edit, size_t contacts) {
+    const std::string count = std::to_string(contacts) + (contacts == 1 ? " contact" : " contacts");
+    switch (edit.action) {
+        case LabelEdit::Action::Apply:
+            return edit.group ? "Add " + count + " to group " + edit.label
+                              : "Add tag '" + edit.label + "' to " + count;
+        case LabelEdit::Action::Remove:
+            return edit.group ? "Remove " + count + " from group " + edit.label
+                              : "Remove tag '" + edit.label + "' from " + count;
+        case LabelEdit::Action::Rename:
+            return edit.group ? "Rename group " + edit.label + " to " + edit.newLabel + " for " + count
+                              : "Rename tag '" + edit.label + "' to '" + edit.newLabel + "' on " + count;
+    }
+    return std::string();
 }
 
+//============================= FILE I/O OPERATIONS ====================================
+
 /*
-==================== ReportCountsByType() ============
+==================== LoadFromFile() ============
 PURPOSE:
-This function counts how many contacts are categorized for each type.
-
-OUTPUT:
-Displays number of contacts per category/type.
+Loads contacts from a CSV file named "addressbook.csv", or from every
+"*.csv" file in the shard directory when one is set.
 
 NOTES:
-- Uses map for better sorting
-- uses two for loops: one for loop runs through the contact list assigning
-  converted enum to string for the string type
-  - Type is then used inside the brackets of count to increment to the next index
+- File name is hardcoded as "addressbook.csv".
+- Parses RFC 4180 CSV (quoted fields may hold commas, quotes and
+  line breaks) with pipe-delimited groups and tags.
+- Records with fewer than 13 fields are padded with empty values
+  instead of being read out of bounds.
+- Loading is a pipeline: per file, a reader thread reads 1 MiB
+  chunks (or decompresses BlockCodec blocks, a batch at a time in
+  parallel), a parser thread turns them into batches of contacts, and
+  this thread indexes each batch as it arrives. Bounded queues between
+  the stages keep memory at a few chunks, and the load takes about as
+  long as its slowest stage instead of the sum of all three.
+- Shard files are read and parsed on parallel threads, then indexed in
+  name order on this thread. Contact ids come from one atomic counter,
+  so they are unique across shards.
+- With SetLazyLoad(true), plain CSV files are mapped and only scanned
+  for record offsets and the preview columns (type and name). A full
+  record is parsed the first time its id is looked up; the first
+  search, filter or report parses the rest and builds the indexes.
 
 =====================================================
 */
+void AddressBook::LoadFromFile() {
+    std::vector<std::string> names;
+    if (!shardDirectory_.empty() && !ListShardFiles(shardDirectory_, names)) {
+        std::cout << "Could not open shard directory " << shardDirectory_ << ".\n";
+    }
+    if (names.empty()) {
+        names.push_back(DEFAULT_FILENAME);
+    }
 
-void AddressBook::ReportCountsByType() const
-{
-    std::cout << "\n=== Contact Counts by Type ===\n\n";
+    {
+        std::lock_guard<std::mutex> lock(contactsMutex_);
+        contacts_.clear();
+        shardOfSlot_.clear();
+        pending_.clear();
+        shards_.clear();
+        for (const auto& name : names) {
+            shards_.push_back(Shard{name, true, false});
+        }
+    }
+    activeShard_ = 0;
+    history_.Clear();
+    indexed_ = !lazyLoad_;
+    resident_.Clear();
+    renderCache_.Clear();
+    positionById_.clear();
+    prefixIndex_.Clear();
+    fuzzyIndex_.Clear();
+    phoneticIndex_.Clear();
+    phoneIndex_.Clear();
+    emailIndex_.Clear();
+    locationIndex_.Clear();
+    labelIndex_.Clear();
+    for (auto& order : orderIndexes_) {
+        order.reset();
+    }
+    textIndex_.reset();
+
+    // With several shards each file gets one decode thread, since the
+    // shards already keep every core busy. Indexes are single-threaded,
+    // so batches are committed here, in shard order.
+    std::vector<std::string> paths;
+    for (size_t shard = 0; shard < shards_.size(); ++shard) {
+        paths.push_back(ShardPath(shard));
+    }
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    bool found = false;
+    bool compressed = false;
+    bool lazy = false;
+    BeginLoading();
+    RunLoadPipeline(paths, shards_.size() > 1 ? 1 : cores, lazyLoad_,
+                    [&](size_t shard, ParsedShard& batch) {
+                        found = found || batch.found;
+                        compressed = compressed || batch.compressed;
+                        lazy = lazy || batch.source;
+                        CommitParsedShard(batch, shard);
+                        return true;
+                    });
+    EndLoading();
+
+    if (!IsSharded()) {
+        // Will always run for a new user
+        if (!found) {
+            std::cout << "No existing file found. Created new file.\n";
+            return;
+        }
+        std::cout << "Loaded " << contacts_.size() << " contacts from " << DEFAULT_FILENAME
+                  << (compressed ? " (compressed)" : "")
+                  << (lazy ? " (lazy)" : "") << "\n";
+        return;
+    }
+    std::cout << "Loaded " << contacts_.size() << " contacts from " << shards_.size()
+              << " shard(s) in " << shardDirectory_ << "\n";
+}
+
+//  Bulk-load mode for the indexes; pairs with EndLoading().
+void AddressBook::BeginLoading() {
+    prefixIndex_.BeginBulkLoad();
+    locationIndex_.BeginBulkLoad();
+    labelIndex_.BeginBulkLoad();
+    for (auto& order : orderIndexes_) {
+        if (order) {
+            order->BeginBulkLoad();
+        }
+    }
+    if (textIndex_) {
+        textIndex_->BeginBulkLoad();
+    }
+    loadingFile_ = true;
+}
+
+void AddressBook::EndLoading() {
+    loadingFile_ = false;
+    prefixIndex_.EndBulkLoad();
+    locationIndex_.EndBulkLoad();
+    labelIndex_.EndBulkLoad();
+    for (auto& order : orderIndexes_) {
+        if (order) {
+            order->EndBulkLoad();
+        }
+    }
+    if (textIndex_) {
+        textIndex_->EndBulkLoad();
+    }
+}
+
+//  Prints the parse messages for one shard and adds its contacts.
+void AddressBook::CommitParsedShard(ParsedShard& parsed, size_t shard) {
+    for (const auto& message : parsed.messages) {
+        std::cout << (IsSharded() ? shards_[shard].name + ": " : std::string()) << message << "\n";
+    }
+    if (parsed.source) {
+        std::lock_guard<std::mutex> lock(contactsMutex_);
+        for (size_t i = 0; i < parsed.contacts.size(); ++i) {
+            pending_[parsed.contacts[i].getId()] = PendingRecord{parsed.source, parsed.offsets[i]};
+        }
+    }
+    for (const auto& contact : parsed.contacts) {
+        AddContactToShard(contact, shard);
+    }
+    parsed.contacts.clear();
+}
+
+//  Load pipeline driver. Loader threads claim files from a shared cursor
+//  and stream each one into its own bounded queue; this thread pops the
+//  batches file by file, in order, and hands them to commit. A false
+//  from commit abandons the rest of that file. The threads never wait on
+//  each other in a cycle: files are claimed in the order they are
+//  committed, so the file being committed always has a running loader.
+void AddressBook::RunLoadPipeline(const std::vector<std::string>& paths, unsigned decodeThreads, bool lazy,
+                                  const std::function<bool(size_t, ParsedShard&)>& commit) {
+    std::vector<std::unique_ptr<BoundedQueue<ParsedShard>>> queues;
+    for (size_t file = 0; file < paths.size(); ++file) {
+        queues.emplace_back(new BoundedQueue<ParsedShard>(PIPELINE_DEPTH));
+    }
+    std::atomic<size_t> next(0);
+    auto loader = [&]() {
+        for (size_t file = next++; file < paths.size(); file = next++) {
+            StreamShardFile(paths[file], decodeThreads, lazy, *queues[file]);
+        }
+    };
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < std::min<size_t>(cores, paths.size()); ++t) {
+        threads.emplace_back(loader);
+    }
+
+    for (size_t file = 0; file < paths.size(); ++file) {
+        ParsedShard batch;
+        while (queues[file]->Pop(batch)) {
+            if (!commit(file, batch)) {
+                queues[file]->Close();
+                break;
+            }
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+//  Read and parse stages for one shard file (either format), run without
+//  touching the book. Always pushes at least one batch (found == false
+//  for a missing file) and closes the queue when done. decodeThreads is
+//  used for the compressed format only. lazy applies to plain CSV only:
+//  compressed blocks have no per-record offsets, so they are always
+//  parsed in full.
+void AddressBook::StreamShardFile(const std::string& path, unsigned decodeThreads, bool lazy,
+                                  BoundedQueue<ParsedShard>& batches) {
+    ParsedShard head;
+    if (lazy) {
+        std::string error;
+        std::shared_ptr<const MappedFile> source = MappedFile::Open(path, error);
+        if (source && !BlockCodec::HasMagic(source->Data(), source->Size())) {
+            head.found = true;
+            head.source = source;
+            ScanPreviews(head);
+            batches.Push(std::move(head));
+            batches.Close();
+            return;
+        }
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        batches.Push(std::move(head));
+        batches.Close();
+        return;
+    }
+    head.found = true;
+
+    // Format is sniffed from the first bytes, not from a setting, so
+    // either kind of file loads regardless of --compress.
+    char magic[BlockCodec::MAGIC_SIZE];
+    file.read(magic, BlockCodec::MAGIC_SIZE);
+    head.compressed = BlockCodec::HasMagic(magic, static_cast<size_t>(file.gcount()));
+    if (!head.compressed) {
+        file.clear();
+        file.seekg(0);
+    }
+
+    // Read stage: raw chunks of a CSV file, or decompressed blocks.
+    BoundedQueue<std::string> chunks(PIPELINE_DEPTH);
+    std::string readError;
+    std::thread reader([&]() {
+        if (!head.compressed) {
+            for (;;) {
+                std::string chunk(READ_CHUNK_BYTES, '\0');
+                file.read(&chunk[0], static_cast<std::streamsize>(chunk.size()));
+                chunk.resize(static_cast<size_t>(file.gcount()));
+                if (chunk.empty() || !chunks.Push(std::move(chunk))) {
+                    break;
+                }
+            }
+        } else {
+            // Blocks are read a batch at a time and decompressed in parallel.
+            BlockCodec::FrameReader frames(file);
+            std::vector<BlockCodec::Frame> batch;
+            std::vector<std::string> blocks;
+            bool more = true;
+            while (more && readError.empty()) {
+                batch.clear();
+                BlockCodec::Frame frame;
+                while (batch.size() < 2 * decodeThreads && (more = frames.Next(frame))) {
+                    batch.push_back(std::move(frame));
+                }
+                if (!BlockCodec::DecodeFrames(batch, blocks, decodeThreads, readError)) {
+                    break;
+                }
+                for (auto& block : blocks) {
+                    if (!chunks.Push(std::move(block))) {
+                        more = false;
+                        break;
+                    }
+                }
+            }
+            if (readError.empty()) {
+                readError = frames.Error();
+            }
+        }
+        chunks.Close();
+    });
+
+    // Parse stage (this thread). A chunk can end inside a record; that
+    // record is carried over and parsed with the next chunk.
+    std::string text;
+    std::string chunk;
+    size_t lineOffset = 0;
+    bool consumerGone = false;
+    bool final = false;
+    while (!final) {
+        final = !chunks.Pop(chunk);
+        if (!final) {
+            text += chunk;
+        }
+        ParsedShard batch;
+        batch.found = true;
+        batch.compressed = head.compressed;
+        text.erase(0, ParseRecords(text.data(), text.size(), final, lineOffset, batch));
+        if (final && !readError.empty()) {
+            // Safe to read: the reader closed the queue after setting it.
+            batch.messages.push_back("Error reading " + path + ": " + readError);
+        }
+        if (!batches.Push(std::move(batch))) {
+            consumerGone = true;
+            break;
+        }
+    }
+    if (consumerGone) {
+        chunks.Close();
+    }
+    reader.join();
+    batches.Close();
+}
+
+//  Parses the CSV records at the front of data into parsed.contacts and
+//  returns how many bytes they used. Unless final, a record that runs to
+//  the end of data may be cut off, so it is left for the next call -
+//  unless it is already longer than MAX_RECORD_BYTES (an unterminated
+//  quote runs to the end of the file, and carrying it would re-parse a
+//  growing tail on every call): then it is reported once and skipped to
+//  the end of the line it started on.
+//  lineOffset is the number of lines before data (for error messages)
+//  and is advanced past the records used.
+size_t AddressBook::ParseRecords(const char* data, size_t size, bool final, size_t& lineOffset,
+                                 ParsedShard& parsed) {
+    Csv::Reader reader(data, size);
+    std::vector<std::string> fields;
+    size_t used = 0;
+
+    for (;;) {
+        const size_t start = reader.Offset();
+        if (!reader.Next(fields)) {
+            used = size;
+            break;
+        }
+        const size_t lineNumber = lineOffset + reader.LineNumber();
+        if (!final && reader.Offset() >= size) {
+            if (size - start <= MAX_RECORD_BYTES) {
+                used = start;
+                break;
+            }
+            parsed.messages.push_back("Error parsing line " + std::to_string(lineNumber) +
+                                      ": record too long (unterminated quote?)");
+            const char* lineEnd = static_cast<const char*>(std::memchr(data + start, '\n', size - start));
+            used = lineEnd ? static_cast<size_t>(lineEnd - data) + 1 : size;
+            break;
+        }
+        used = reader.Offset();
+
+        // Fills fields: id, type, firstName, lastName, email, phone,
+        //               addressLine, city, state, postalCode, notes, groups, tags
+        if (fields.size() < 3) {
+            parsed.messages.push_back("Error parsing line " + std::to_string(lineNumber) + ": too few fields");
+            continue;
+        }
+        if (!IsRecordId(fields[0])) {
+            parsed.messages.push_back("Error parsing line " + std::to_string(lineNumber) + ": invalid id");
+            continue;
+        }
+        fields.resize(CSV_FIELD_COUNT);
+
+        try {
+            Contact contact;
+            ApplyFields(contact, fields);
+            parsed.contacts.push_back(std::move(contact));
+
+        } catch (const std::exception& error) {
+            parsed.messages.push_back("Error parsing line " + std::to_string(lineNumber) + ": " + error.what());
+        }
+    }
+    lineOffset += static_cast<size_t>(std::count(data, data + used, '\n'));
+    return used;
+}
+
+//  Fills a contact from the 13 record fields (id, type, firstName,
+//  lastName, email, phone, addressLine, city, state, postalCode, notes,
+//  groups, tags); the contact keeps its own id.
+void AddressBook::ApplyFields(Contact& contact, const std::vector<std::string>& fields) {
+    contact.setType(StringToContactType(fields[1]))
+           .setFirstName(fields[2])
+           .setLastName(fields[3])
+           .setEmail(fields[4])
+           .setPhone(fields[5])
+           .setAddressLine(fields[6])
+           .setCity(fields[7])
+           .setState(fields[8])
+           .setPostalCode(fields[9])
+           .setNotes(fields[10]);
+
+    // Parse groups (pipe-delimited)
+    if (!fields[11].empty()) {
+        std::stringstream groupStream(fields[11]);
+        std::string group;
+        while (std::getline(groupStream, group, '|')) {
+            if (!group.empty()) {
+                contact.addGroup(group);
+            }
+        }
+    }
+
+    // Parse tags (pipe-delimited)
+    if (!fields[12].empty()) {
+        std::stringstream tagStream(fields[12]);
+        std::string tag;
+        while (std::getline(tagStream, tag, '|')) {
+            if (!tag.empty()) {
+                contact.addTag(tag);
+            }
+        }
+    }
+}
+
+//  Lazy scan: one preview contact (type and name) plus the byte offset
+//  of its record for every record in the mapped file.
+void AddressBook::ScanPreviews(ParsedShard& parsed) {
+    Csv::Reader reader(parsed.source->Data(), parsed.source->Size());
+    std::vector<std::string> fields;
+    size_t offset = reader.Offset();
+
+    while (reader.Next(fields)) {
+        if (fields.size() < 3) {
+            parsed.messages.push_back("Error parsing line " + std::to_string(reader.LineNumber()) +
+                                      ": too few fields");
+        } else if (!IsRecordId(fields[0])) {
+            parsed.messages.push_back("Error parsing line " + std::to_string(reader.LineNumber()) +
+                                      ": invalid id");
+        } else {
+            fields.resize(CSV_FIELD_COUNT);
+            parsed.contacts.emplace_back(StringToContactType(fields[1]), fields[2], fields[3]);
+            parsed.offsets.push_back(offset);
+        }
+        offset = reader.Offset();
+    }
+}
+
+//  Full contact for a preview: parses its record, keeping the preview's id.
+ContactPtr AddressBook::Materialize(const Contact& preview, const PendingRecord& record) {
+    Csv::Reader reader(record.source->Data() + record.offset, record.source->Size() - record.offset);
+    std::vector<std::string> fields;
+    Contact full = preview;
+    if (reader.Next(fields)) {
+        fields.resize(CSV_FIELD_COUNT);
+        ApplyFields(full, fields);
+    }
+    return std::make_shared<const Contact>(std::move(full));
+}
+
+/*
+==================== EnsureIndexed() ============
+PURPOSE:
+Ends lazy mode: builds the secondary indexes over every contact. Every
+search, filter and report calls this first; after the first call it
+returns at once.
+
+NOTES:
+- const because it only completes data that logically was loaded
+  already; the members it fills are mutable.
+- Previews are parsed (in parallel) RESIDENT_RECORD_LIMIT at a time,
+  indexed and dropped again, so the book stays previews plus offsets;
+  reads from then on parse a record for the caller (see Full()).
+=====================================================
+*/
+void AddressBook::EnsureIndexed() const {
+    if (indexed_) {
+        return;
+    }
+
+    resident_.Clear();
+    indexed_ = true;
+    prefixIndex_.BeginBulkLoad();
+    locationIndex_.BeginBulkLoad();
+    labelIndex_.BeginBulkLoad();
+    for (auto& order : orderIndexes_) {
+        if (order) {
+            order->BeginBulkLoad();
+        }
+    }
+    if (textIndex_) {
+        textIndex_->BeginBulkLoad();
+    }
+
+    // Only this thread writes pending_, so the workers can read it
+    // without the lock.
+    std::vector<ContactPtr> batch;
+    for (size_t first = 0; first < contacts_.size(); first += RESIDENT_RECORD_LIMIT) {
+        batch.assign(std::min(RESIDENT_RECORD_LIMIT, contacts_.size() - first), nullptr);
+        WorkStealing::ParallelFor(batch.size(), 0, [&](size_t k) {
+            batch[k] = Full(contacts_[first + k]);
+        });
+        for (const auto& contact : batch) {
+            IndexContact(*contact);
+        }
+    }
+    batch.clear();
+
+    prefixIndex_.EndBulkLoad();
+    locationIndex_.EndBulkLoad();
+    labelIndex_.EndBulkLoad();
+    for (auto& order : orderIndexes_) {
+        if (order) {
+            order->EndBulkLoad();
+        }
+    }
+    if (textIndex_) {
+        textIndex_->EndBulkLoad();
+    }
+}
+
+//  With contactsMutex_ held: which entries of a snapshot are still
+//  previews, and where their records are.
+void AddressBook::CollectPending(const std::vector<ContactPtr>& contacts, PendingWork& work) const {
+    if (pending_.empty()) {
+        return;
+    }
+    for (size_t position = 0; position < contacts.size(); ++position) {
+        auto pending = pending_.find(contacts[position]->getId());
+        if (pending != pending_.end()) {
+            work.emplace_back(position, pending->second);
+        }
+    }
+}
+
+//  Without the lock: swaps full contacts into a snapshot (the book
+//  itself keeps its previews).
+void AddressBook::ResolvePending(std::vector<ContactPtr>& contacts, const PendingWork& work) {
+    for (const auto& item : work) {
+        contacts[item.first] = Materialize(*contacts[item.first], item.second);
+    }
+}
+
+/*
+==================== SaveToFile() ============
+PURPOSE:
+Saves all contacts to a CSV file named "addressbook.csv".
+
+NOTES:
+File name is hardcoded as "addressbook.csv".
+- Written to "addressbook.csv.tmp", fsynced, then renamed over the
+  real file, so a crash mid-save never leaves a truncated book.
+- Waits for a background save first; both use the same temp file.
+- Written as compressed blocks instead of plain CSV after
+  SetCompressedSaves(true).
+- A sharded book writes every loaded shard back to its own file;
+  unloaded shards are left as they are on disk.
+=====================================================
+*/
+void AddressBook::SaveToFile() const {
+    const std::vector<SnapshotWriter::Job> jobs = ShardJobs(false);
+    std::string error;
+    if (!snapshotWriter_.WriteNow(jobs, saveFormat_, error)) {
+        std::cout << "Error: Could not save file (" << error << ").\n";
+        std::lock_guard<std::mutex> lock(contactsMutex_);
+        for (auto& shard : shards_) {
+            shard.dirty = shard.loaded;
+        }
+        return;
+    }
+    if (autosaver_) {
+        autosaver_->NoteSaved();
+    }
+
+    if (!IsSharded()) {
+        std::cout << "Saved " << contacts_.size() << " contacts to " << DEFAULT_FILENAME << "\n";
+        return;
+    }
+    std::cout << "Saved " << contacts_.size() << " contacts to " << jobs.size()
+              << " shard file(s) in " << shardDirectory_ << "\n";
+}
+
+/*
+==================== SaveToFileAsync() ============
+PURPOSE:
+Starts saving the address book on a background thread and returns
+immediately, so editing can continue during a large save.
+
+OUTPUT:
+Returns false if a background save is already running.
+
+NOTES:
+- The snapshot is a copy of the contact pointers only. Stored
+  contacts are immutable, so later edits cannot change what is
+  being written.
+- Poll GetSaveStatus() for progress and the final result.
+- changedOnly writes just the shards edited since their last save
+  (autosave uses it); with nothing to write it returns true at once.
+- A failed background save is reported through GetSaveStatus(), and
+  the shards it was writing count as unsaved again.
+- finished, if set, is called once with the outcome (on the save
+  thread, or at once when there is nothing to write) unless this
+  returns false.
+=====================================================
+*/
+bool AddressBook::SaveToFileAsync(bool changedOnly, std::function<void(bool succeeded)> finished) const {
+    if (snapshotWriter_.IsRunning()) {
+        return false;
+    }
+    std::vector<SnapshotWriter::Job> jobs = ShardJobs(changedOnly);
+    if (jobs.empty()) {
+        if (finished) {
+            finished(true);
+        }
+        return true;
+    }
+    std::vector<std::string> paths;
+    for (const auto& job : jobs) {
+        paths.push_back(job.path);
+    }
+    auto settle = [this, paths, finished](bool succeeded) {
+        if (!succeeded) {
+            MarkUnsaved(paths);
+        }
+        if (finished) {
+            finished(succeeded);
+        }
+    };
+    if (snapshotWriter_.Start(std::move(jobs), saveFormat_, settle)) {
+        return true;
+    }
+
+    // Lost a race with another save: these shards are still unsaved.
+    MarkUnsaved(paths);
+    return false;
+}
+
+//  Sets the dirty flag again on the shards saved to paths.
+void AddressBook::MarkUnsaved(const std::vector<std::string>& paths) const {
+    std::lock_guard<std::mutex> lock(contactsMutex_);
+    for (size_t shard = 0; shard < shards_.size(); ++shard) {
+        if (std::find(paths.begin(), paths.end(), ShardPath(shard)) != paths.end()) {
+            shards_[shard].dirty = true;
+        }
+    }
+}
+
+//  Consistent point-in-time view of the book; O(n) pointer copies, no
+//  contact data is duplicated.
+std::vector<ContactPtr> AddressBook::Snapshot() const {
+    std::vector<ContactPtr> snapshot;
+    PendingWork work;
+    {
+        std::lock_guard<std::mutex> lock(contactsMutex_);
+        snapshot = contacts_;
+        CollectPending(snapshot, work);
+    }
+    ResolvePending(snapshot, work);
+    return snapshot;
+}
+
+SnapshotWriter::Status AddressBook::GetSaveStatus() const {
+    return snapshotWriter_.GetStatus();
+}
+
+void AddressBook::AcknowledgeSaveStatus() {
+    snapshotWriter_.Acknowledge();
+}
+
+void AddressBook::WaitForSave() const {
+    snapshotWriter_.Wait();
+}
+
+//  Lazy loading applies from the next LoadFromFile() / LoadShard().
+void AddressBook::SetLazyLoad(bool lazy) {
+    lazyLoad_ = lazy;
+}
+
+//  Stemming changes which words match, so an existing full-text index
+//  is dropped and rebuilt the new way on the next text search.
+void AddressBook::SetStemming(bool stem) {
+    std::lock_guard<std::mutex> lock(textIndexMutex_);
+    if (stem != stemWords_) {
+        stemWords_ = stem;
+        textIndex_.reset();
+    }
+}
+
+//  Chooses the on-disk format for every later save (manual or auto).
+void AddressBook::SetCompressedSaves(bool compressed) {
+    saveFormat_ = compressed ? SnapshotWriter::Format::Compressed : SnapshotWriter::Format::Csv;
+}
+
+/*
+==================== EnableAutosave() ============
+PURPOSE:
+Turns on automatic background saves after a number of edits or a
+period of time, whichever comes first.
+
+NOTES:
+- Every add, edit, delete, merge and tag/group change counts as one
+  edit; loading the file does not.
+- Saves go through SaveToFileAsync(), rate-limited by the policy's
+  minimum interval, so bulk changes cause one rewrite, not hundreds.
+  Edits covered by a save that fails count as unsaved again and are
+  retried.
+- Calling it again replaces the previous policy.
+=====================================================
+*/
+void AddressBook::EnableAutosave(const Autosaver::Policy& policy) {
+    autosaver_.reset();
+    autosaver_.reset(new Autosaver(policy, [this](Autosaver::Done done) {
+        return SaveToFileAsync(true, std::move(done));
+    }));
+}
+
+//============================= CHANGE DATA CAPTURE ====================================
+/*
+==================== GetChangeFeed() ============
+PURPOSE:
+Gives in-process consumers the stream of typed change events: register
+a callback with Subscribe() or read from any thread with Poll().
+
+NOTES:
+- Every add, edit, delete, merge, tag/group change, undo and redo is
+  published as it is stored; loading files and shards is not.
+- Contact ids are only stable for the session; events also carry the
+  name, and added / deleted events every non-empty field.
+=====================================================
+*/
+ChangeFeed& AddressBook::GetChangeFeed() {
+    return changeFeed_;
+}
+
+//  Appends every later event to path as NDJSON, from a writer thread.
+//  Calling it again switches to the new path.
+void AddressBook::StreamChangesTo(const std::string& path) {
+    changeStream_.reset();
+    changeStream_.reset(new ChangeStream(changeFeed_, path));
+}
+
+//============================= SHARDS ====================================
+/*
+==================== SetShardDirectory() ============
+PURPOSE:
+Makes the book a directory of shard files instead of one file. Every
+"*.csv" file in the directory (either format) is one shard; the next
+LoadFromFile() loads them all in parallel.
+
+NOTES:
+- Searches, filters and reports always cover every loaded shard: the
+  indexes hold all of them, so there is no per-shard query step.
+- An empty directory starts with one shard named "addressbook.csv".
+=====================================================
+*/
+void AddressBook::SetShardDirectory(const std::string& directory) {
+    shardDirectory_ = directory;
+    while (shardDirectory_.size() > 1 && (shardDirectory_.back() == '/' || shardDirectory_.back() == '\\')) {
+        shardDirectory_.pop_back();
+    }
+}
+
+bool AddressBook::IsSharded() const {
+    return !shardDirectory_.empty();
+}
+
+std::vector<AddressBook::ShardInfo> AddressBook::ListShards() const {
+    std::vector<ShardInfo> infos;
+    for (const auto& shard : shards_) {
+        infos.push_back(ShardInfo{shard.name, shard.loaded, shard.dirty, 0});
+    }
+    for (size_t shard : shardOfSlot_) {
+        ++infos[shard].contacts;
+    }
+    return infos;
+}
+
+/*
+==================== LoadShard() ============
+PURPOSE:
+Loads one more shard file from the shard directory into the running
+book; its contacts become searchable immediately.
+
+OUTPUT:
+Returns false if the book is not sharded, the shard is already loaded
+or the file cannot be read.
+=====================================================
+*/
+bool AddressBook::LoadShard(const std::string& name) {
+    size_t shard = FindShard(name);
+    if (!IsSharded() || !IsValidShardName(name) ||
+        (shard < shards_.size() && shards_[shard].loaded)) {
+        return false;
+    }
+
+    const std::string path = shardDirectory_ + "/" + name;
+    const size_t before = contacts_.size();
+    bool found = false;
+    BeginLoading();
+    RunLoadPipeline(std::vector<std::string>{path}, std::max(1u, std::thread::hardware_concurrency()),
+                    lazyLoad_ && !indexed_, [&](size_t, ParsedShard& batch) {
+                        if (!batch.found) {
+                            return false;
+                        }
+                        if (!found) {
+                            found = true;
+                            std::lock_guard<std::mutex> lock(contactsMutex_);
+                            if (shard == shards_.size()) {
+                                shards_.push_back(Shard{name, true, false});
+                            } else {
+                                shards_[shard].loaded = true;
+                            }
+                        }
+                        CommitParsedShard(batch, shard);
+                        return true;
+                    });
+    EndLoading();
+    if (!found) {
+        return false;
+    }
+    std::cout << "Loaded " << contacts_.size() - before << " contacts from " << name << "\n";
+    return true;
+}
+
+/*
+==================== UnloadShard() ============
+PURPOSE:
+Drops one shard's contacts from memory and from every index; the file
+stays on disk and can be loaded again later.
+
+OUTPUT:
+Returns false if the shard is not loaded, receives new contacts
+(choose another with SetActiveShard() first), or saving it failed.
+
+NOTES:
+- With saveFirst the shard is written to its file before it is
+  dropped; otherwise unsaved edits to it are discarded.
+=====================================================
+*/
+bool AddressBook::UnloadShard(const std::string& name, bool saveFirst) {
+    const size_t shard = FindShard(name);
+    if (shard >= shards_.size() || !shards_[shard].loaded || shard == activeShard_) {
+        return false;
+    }
+
+    if (saveFirst) {
+        SnapshotWriter::Job job;
+        job.path = ShardPath(shard);
+        for (size_t slot = 0; slot < contacts_.size(); ++slot) {
+            if (shardOfSlot_[slot] == shard) {
+                job.contacts.push_back(contacts_[slot]);
+            }
+        }
+        PendingWork work;
+        {
+            std::lock_guard<std::mutex> lock(contactsMutex_);
+            CollectPending(job.contacts, work);
+        }
+        ResolvePending(job.contacts, work);
+        std::string error;
+        if (!snapshotWriter_.WriteNow(std::vector<SnapshotWriter::Job>{job}, saveFormat_, error)) {
+            std::cout << "Error: Could not save " << name << " (" << error << ").\n";
+            return false;
+        }
+    }
+
+    for (size_t slot = 0; slot < contacts_.size(); ++slot) {
+        if (shardOfSlot_[slot] == shard) {
+            ForgetCached(contacts_[slot]->getId());
+            UnindexContact(*Full(contacts_[slot]));
+            positionById_.erase(contacts_[slot]->getId());
+        }
+    }
+
+    // Compact both parallel vectors in one pass instead of erasing one
+    // contact at a time.
+    {
+        std::lock_guard<std::mutex> lock(contactsMutex_);
+        size_t kept = 0;
+        for (size_t slot = 0; slot < contacts_.size(); ++slot) {
+            if (shardOfSlot_[slot] == shard) {
+                pending_.erase(contacts_[slot]->getId());
+            } else {
+                contacts_[kept] = std::move(contacts_[slot]);
+                shardOfSlot_[kept] = shardOfSlot_[slot];
+                ++kept;
+            }
+        }
+        contacts_.resize(kept);
+        shardOfSlot_.resize(kept);
+        shards_[shard].loaded = false;
+        shards_[shard].dirty = false;
+    }
+    RebuildPositions(0);
+    history_.Clear();                      // recorded positions no longer hold
+    return true;
+}
+
+/*
+==================== SetActiveShard() ============
+PURPOSE:
+Chooses the shard that new contacts are added to. A name that does not
+exist yet starts a new, empty shard (".csv" is appended if missing);
+its file is created by the next save.
+
+OUTPUT:
+Returns false if the book is not sharded, the name is invalid or the
+shard exists but is not loaded.
+=====================================================
+*/
+bool AddressBook::SetActiveShard(const std::string& name) {
+    if (!IsSharded() || !IsValidShardName(name)) {
+        return false;
+    }
+    const std::string fileName = EndsWith(name, ".csv") ? name : name + ".csv";
+    const size_t shard = FindShard(fileName);
+    if (shard == shards_.size()) {
+        std::lock_guard<std::mutex> lock(contactsMutex_);
+        shards_.push_back(Shard{fileName, true, false});
+    } else if (!shards_[shard].loaded) {
+        return false;
+    }
+    activeShard_ = shard;
+    return true;
+}
+
+
+//============================= SORTING ====================================
+/*
+==================== SortContacts() ============
+PURPOSE:
+Stable multi-key sort: orders by keys[0], breaks ties with keys[1],
+and so on; contacts equal on every key keep their input order.
+
+NOTES:
+Collation keys are computed once per contact and key, before the
+sort, rather than case-folding strings inside every comparison.
+=====================================================
+*/
+void AddressBook::SortContacts(std::vector<Contact>& contacts, const std::vector<SortKey>& keys) {
+    if (keys.empty() || contacts.size() < 2) {
+        return;
+    }
+    const size_t keyCount = keys.size();
+    std::vector<std::string> collation(contacts.size() * keyCount);   // contact-major
+    for (size_t i = 0; i < contacts.size(); ++i) {
+        for (size_t k = 0; k < keyCount; ++k) {
+            collation[i * keyCount + k] = OrderIndex::CollationKey(contacts[i], keys[k].field);
+        }
+    }
+
+    std::vector<size_t> order(contacts.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        for (size_t k = 0; k < keyCount; ++k) {
+            const int compared = (keys[k].field == SortField::Id)
+                ? (contacts[a].getId() > contacts[b].getId()) - (contacts[a].getId() < contacts[b].getId())
+                : collation[a * keyCount + k].compare(collation[b * keyCount + k]);
+            if (compared != 0) {
+                return keys[k].descending ? compared > 0 : compared < 0;
+            }
+        }
+        return false;
+    });
+
+    std::vector<Contact> sorted;
+    sorted.reserve(contacts.size());
+    for (size_t i : order) {
+        sorted.push_back(std::move(contacts[i]));
+    }
+    contacts.swap(sorted);
+}
+
+void AddressBook::SetResultOrder(const std::vector<SortKey>& keys) {
+    resultOrder_ = keys;
+}
+
+const std::vector<AddressBook::SortKey>& AddressBook::GetResultOrder() const {
+    return resultOrder_;
+}
+
+
+//============================= REPORTS ====================================
+/*
+==================== ReportMissingInfo() ============
+PURPOSE:
+This function scans through the contacts in the address book and sees whether
+they have an email or phone number.
+
+OUTPUT:
+Displays the ID/NAME/TYPE of each contacts missing an email or phone number
+as well as the total number of contacts.
+
+NOTES:
+- Uses a for loop that scans the contacts for the length of the contact list.
+  If getEmail() or getPhone() is empty it outputs the contact's ID/NAME/TYPE
+
+=====================================================
+*/
+void AddressBook::ReportMissingInfo(std::ostream& out) const
+{
+    EnsureIndexed();
+
+    out << "\n=== Contacts Missing Information ===\n\n";
+
+    // Collects the contacts missing email or phone, so they can be
+    // listed in the result order if one is set (SetResultOrder)
+    std::vector<Contact> missing;
+
+    // For loop running contact list length
+    for (const auto& stored : contacts_) {
+        const ContactPtr full = Full(stored);
+        const Contact& contact = *full;
+
+        // Conditional statement using empty() to see if retrieved email and phone
+        // for contact is empty and if so it runs.
+        if (contact.getEmail().empty() || contact.getPhone().empty())
+        {
+            missing.push_back(contact);
+        }
+    }
+    SortContacts(missing, resultOrder_);
+
+    for (const Contact& contact : missing)
+    {
+        //Displays the basic info
+        out << "ID: " << contact.getId()
+            << " | " << contact.getFullName()
+            << " | " << Contact::contactTypeToString(contact.getType())
+            << "\n";
+    }
+    const size_t count = missing.size();
+
+    // Displays the amount of contacts with missing info
+    out << "\nTotal: " << count << " contacts missing email or phone\n";
+}
+
+/*
+==================== ReportCountsByType() ============
+PURPOSE:
+This function counts how many contacts are categorized for each type.
+
+OUTPUT:
+Displays number of contacts per category/type.
+
+NOTES:
+- Uses map for better sorting
+- uses two for loops: one for loop runs through the contact list assigning
+  converted enum to string for the string type
+  - Type is then used inside the brackets of count to increment to the next index
+
+=====================================================
+*/
+
+void AddressBook::ReportCountsByType(std::ostream& out) const
+{
+    EnsureIndexed();
+    out << "\n=== Contact Counts by Type ===\n\n";
 
     // Map also organizes the output alphabetically
     std::map<std::string, int> counts;
 
     // First for loop counts each contact type
-    for (const auto& contact : contacts_)
+    for (const auto& stored : contacts_)
     {
+        const Contact& contact = *stored;
 
         // Converts the enum to string
         std::string type = Contact::contactTypeToString(contact.getType());
@@ -807,11 +2975,11 @@ void AddressBook::ReportCountsByType() const
 
         // Outputs pair.first (string containing the type)
         // then pair.second (int containing the count of contacts for the type)
-        std::cout << pair.first << ": " << pair.second << "\n";
+        out << pair.first << ": " << pair.second << "\n";
     }
 
     // Displays the total amount of contacts overall regardless of type
-    std::cout << "\nTotal contacts: " << contacts_.size() << "\n";
+    out << "\nTotal contacts: " << contacts_.size() << "\n";
 }
 
 
@@ -833,33 +3001,20 @@ NOTES:
 
 ================================================================
 */
-void AddressBook::ReportGroupSummary() const
+void AddressBook::ReportGroupSummary(std::ostream& out) const
 {
-    std::cout << "\n=== Group Summary ===\n\n";
-
-    // Uses map to sort the groupCounts dealing with duplicates
-    std::map<std::string, int> groupCounts;
-
-    // For loop runs through the contact list
-    for (const auto& contact : contacts_)
-    {
-        // Get reference to contacts groups vector
-        const auto& groups = contact.getGroups();
-
-        // Nested for loop runs through the groups of the contact list
-        for (const auto& group : groups)
-        {
-            // groupCounts get iterated for that group
-            groupCounts[group]++;
-        }
-    }
+    EnsureIndexed();
+    out << "\n=== Group Summary ===\n\n";
 
+    // Member counts come straight from the group posting lists,
+    // already sorted by group name
+    const auto groupCounts = labelIndex_.GroupCounts();
 
     // If the groupCounts is fully empty then there are no groups defined
     if (groupCounts.empty())
     {
         // Displays that no groups are defined
-        std::cout << "No groups defined.\n";
+        out << "No groups defined.\n";
         return;
     }
 
@@ -867,6 +3022,160 @@ void AddressBook::ReportGroupSummary() const
     for (const auto& pair : groupCounts)
     {
         // Displays pair.first (group name) and then pair.second (group member count)
-        std::cout << pair.first << ": " << pair.second << " members\n";
+        out << pair.first << ": " << pair.second << " members\n";
+    }
+}
+
+/*
+==================== ReportEmailDomains() ======================
+PURPOSE:
+Shows how many contacts use each email domain, largest first.
+
+OUTPUT:
+One line per distinct domain with its contact count, followed by the
+number of distinct domains.
+
+NOTES:
+- Counts come from the email index buckets, so the report costs one
+  step per domain rather than a pass over every contact.
+
+================================================================
+*/
+void AddressBook::ReportEmailDomains(std::ostream& out) const
+{
+    EnsureIndexed();
+    out << "\n=== Email Domains ===\n\n";
+
+    const auto counts = emailIndex_.DomainCounts();
+    if (counts.empty())
+    {
+        out << "No email addresses on file.\n";
+        return;
+    }
+
+    for (const auto& pair : counts)
+    {
+        out << pair.first << ": " << pair.second << " contacts\n";
+    }
+
+    out << "\nDistinct domains: " << counts.size() << "\n";
+}
+/*
+==================== ReportCacheStats() ======================
+PURPOSE:
+Shows how well the caches are working: the formatted-view cache and,
+for a lazily loaded book, how many records were parsed on demand.
+
+OUTPUT:
+Hit / miss counts, entries and bytes of the view cache, then the lazy
+loading figures (only while the book is still partly unparsed).
+
+================================================================
+*/
+void AddressBook::ReportCacheStats(std::ostream& out) const
+{
+    const RenderCache::Stats stats = renderCache_.GetStats();
+    const size_t lookups = stats.hits + stats.misses;
+
+    out << "\n=== Cache Statistics ===\n\n";
+    out << "Contact views: " << stats.hits << " hits, " << stats.misses << " misses";
+    if (lookups > 0)
+    {
+        out << " (" << (stats.hits * 100 / lookups) << "% hit rate)";
+    }
+    out << "\n";
+    out << "  cached: " << stats.entries << " views, " << stats.bytes << " of "
+              << stats.capacityBytes << " bytes; evicted: " << stats.evictions << "\n";
+
+    if (!indexed_)
+    {
+        out << "Lazy records: " << pending_.size() << " not parsed yet, "
+                  << resident_.Size() << " parsed and cached, "
+                  << lazyParses_ << " parsed on demand, "
+                  << resident_.Evictions() << " returned to preview\n";
+    }
+    else if (!pending_.empty())
+    {
+        out << "Lazy records: " << pending_.size() << " indexed, kept as previews and parsed per read\n";
+    }
+}
+
+/*
+==================== ReportWatchList() ======================
+PURPOSE:
+Runs a watch list of searches from a file against the whole book, for
+nightly jobs started with --watch-list.
+
+OUTPUT:
+A header with the query and match counts, then one line per matching
+contact: the watch-list line numbers it matched, joined by '|', a
+comma, and the contact's CSV record. Returns false (after printing the
+reason) if the file cannot be read or a line is not understood.
+
+NOTES:
+- One query per line: NAME, EMAIL or PHONE, a space, then the text to
+  look for anywhere in that field (case-insensitive). Blank lines and
+  lines starting with '#' are skipped.
+- Every query is answered in the same single pass; see ScanOnce().
+
+================================================================
+*/
+bool AddressBook::ReportWatchList(const std::string& path, std::ostream& out) const
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        out << "Error: could not open watch list " << path << "\n";
+        return false;
     }
-}
\ No newline at end of file
+
+    std::vector<BatchQuery> queries;
+    std::vector<size_t> lineOf;
+    std::string line;
+    for (size_t lineNumber = 1; std::getline(file, line); ++lineNumber)
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        const size_t space = line.find(' ');
+        const std::string field = TextUtils::FoldCase(line.substr(0, space));
+        BatchQuery query {BatchQuery::Kind::Name, space == std::string::npos ? "" : line.substr(space + 1)};
+        if (field == "email")
+        {
+            query.kind = BatchQuery::Kind::Email;
+        }
+        else if (field == "phone")
+        {
+            query.kind = BatchQuery::Kind::Phone;
+        }
+        else if (field != "name" || query.text.empty())
+        {
+            out << "Error: " << path << " line " << lineNumber << ": expected NAME, EMAIL or PHONE and a text\n";
+            return false;
+        }
+        queries.push_back(query);
+        lineOf.push_back(lineNumber);
+    }
+
+    const std::vector<WatchMatch> matches = MatchWatchList(queries);
+    out << "\n=== Watch List: " << queries.size() << " queries, " << matches.size() << " contacts matched ===\n\n";
+    for (const auto& match : matches)
+    {
+        for (size_t i = 0; i < match.queries.size(); ++i)
+        {
+            out << (i ? "|" : "") << lineOf[match.queries[i]];
+        }
+        out << "," << match.contact.toCSV() << "\n";
+    }
+    return true;
+}
+
+RenderCache::Stats AddressBook::GetRenderCacheStats() const
+{
+    return renderCache_.GetStats();
+}
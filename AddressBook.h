@@ -1,21 +1,236 @@
 #pragma once
 
 #include "Contact.h"
+#include "DuplicateFinder.h"
+#include "PrefixIndex.h"
+#include "FuzzyIndex.h"
+#include "PhoneticIndex.h"
+#include "PhoneIndex.h"
+#include "EmailIndex.h"
+#include "LocationIndex.h"
+#include "LabelIndex.h"
+#include "OrderIndex.h"
+#include "FullTextIndex.h"
+#include "Relevance.h"
+#include "SnapshotWriter.h"
+#include "Autosaver.h"
+#include "MappedFile.h"
+#include "RenderCache.h"
+#include "LruCache.h"
+#include "History.h"
+#include "ChangeFeed.h"
+#include "ChangeStream.h"
+#include "BoundedQueue.h"
+#include <array>
 #include <vector>
 #include <string>
 #include <iostream>
+#include <unordered_map>
+#include <mutex>
+#include <memory>
+#include <functional>
 
 class AddressBook {
+public:
+    // One file of a sharded book, as reported by ListShards().
+    struct ShardInfo {
+        std::string name;        // file name inside the shard directory
+        bool loaded;
+        bool dirty;              // edited since it was last saved
+        size_t contacts;         // contacts held in memory for it
+    };
+
+    // One lookup of a SearchBatch() call; kind picks the Search* method.
+    struct BatchQuery {
+        enum class Kind { Name, Email, Phone, PhoneSuffix, CallerId, EmailDomain, EmailLocalPart, SoundsLike, Prefix, Fuzzy };
+        Kind kind;
+        std::string text;
+        size_t limit {20};       // Prefix / Fuzzy
+        int maxDistance {2};     // Fuzzy
+    };
+
+    // One tag or group change for EditLabels(): Apply adds label,
+    // Remove drops it, Rename replaces it with newLabel in place (for
+    // every holder at once, when all of them are selected).
+    struct LabelEdit {
+        enum class Action { Apply, Remove, Rename };
+        Action action;
+        bool group {false};      // false: tag
+        std::string label;
+        std::string newLabel;    // Rename only
+    };
+
+    // One key of a sorted listing; SortContacts() takes several, most
+    // significant first.
+    typedef OrderIndex::Key SortField;
+    struct SortKey {
+        SortField field;
+        bool descending {false};
+    };
+
+    // One hit of SearchRanked(), with its relevance score.
+    struct RankedMatch {
+        Contact contact;
+        double score;
+    };
+
+    // A contact found by MatchWatchList(), with the queries it matched.
+    struct WatchMatch {
+        Contact contact;
+        std::vector<size_t> queries;   // indexes into the watch list, ascending
+    };
+
 private:
-    std::vector<Contact> contacts_;
+    // A shard is one CSV (or compressed) file. Single-file mode is a
+    // single shard named after DEFAULT_FILENAME.
+    struct Shard {
+        std::string name;
+        bool loaded;
+        bool dirty;
+    };
+
+    // One batch of records from a shard file, as the load pipeline hands
+    // it to the committing thread (a file is one or more batches, in
+    // order). A lazy scan fills contacts with previews and records where
+    // each one starts.
+    struct ParsedShard {
+        bool found {false};
+        bool compressed {false};
+        std::vector<Contact> contacts;
+        std::vector<std::string> messages;   // printed after the parallel phase
+        std::shared_ptr<const MappedFile> source;   // lazy scan only
+        std::vector<size_t> offsets;                // lazy scan only, parallel to contacts
+    };
+
+    // Where the full record for a preview-only contact can be parsed.
+    struct PendingRecord {
+        std::shared_ptr<const MappedFile> source;
+        size_t offset;
+    };
+    typedef std::vector<std::pair<size_t, PendingRecord>> PendingWork;   // (position, record)
+
+    // A lazily parsed contact that is still identical to its file record
+    // and can be turned back into its preview.
+    struct ResidentRecord {
+        ContactPtr preview;
+        PendingRecord record;
+    };
+
+
+    mutable std::vector<ContactPtr> contacts_;       // immutable records; edits (and lazy parses) swap in a copy
+    mutable std::mutex contactsMutex_;               // guards contacts_, shardOfSlot_ and shards_ against Snapshot()
+    std::vector<size_t> shardOfSlot_;                // parallel to contacts_: owning shard index
+    mutable std::vector<Shard> shards_;              // never reordered; const saves clear dirty flags
+    std::string shardDirectory_;                     // empty: single file (DEFAULT_FILENAME)
+    size_t activeShard_ {0};                         // shard that receives new contacts
+    std::unordered_map<int, size_t> positionById_;   // contact id -> index in contacts_
+    mutable std::unordered_map<int, PendingRecord> pending_;   // lazy: preview-only contacts by id
+    bool lazyLoad_ {false};                          // loads scan previews + offsets only
+    mutable bool indexed_ {true};                    // false until a lazy book is first searched
+    mutable LruCache<int, ResidentRecord> resident_; // lazy: clean parsed contacts, LRU-bounded
+    mutable size_t lazyParses_ {0};                  // lazy: records parsed on demand
+    mutable RenderCache renderCache_;                // formatted text of recently viewed contacts
+    History history_;                                // undo / redo journal of pointer deltas
+    bool replayingHistory_ {false};                  // undo / redo in progress: do not record
+    ChangeFeed changeFeed_;                          // typed change events for subscribers
+    std::unique_ptr<ChangeStream> changeStream_;     // NDJSON copy of changeFeed_, if enabled
+
+    // Indexes are mutable because a lazy book builds them on its first
+    // (const) search; see EnsureIndexed().
+    mutable PrefixIndex prefixIndex_;                // type-ahead name/email completion
+    mutable FuzzyIndex fuzzyIndex_;                  // BK-tree for typo-tolerant names
+    mutable PhoneticIndex phoneticIndex_;            // Soundex codes for sound-alike names
+    mutable PhoneIndex phoneIndex_;                  // canonical digits + suffix buckets
+    mutable EmailIndex emailIndex_;                  // domain / local-part split
+    mutable LocationIndex locationIndex_;            // state -> city -> ZIP
+    mutable LabelIndex labelIndex_;                  // tag / group id -> holders
+    // Sort orders are built on first use (most books are never browsed
+    // by city) and maintained from then on; orderMutex_ guards creation.
+    mutable std::array<std::unique_ptr<OrderIndex>, OrderIndex::KEY_COUNT> orderIndexes_;
+    mutable std::mutex orderMutex_;
+    // Likewise the full-text index: most books are never searched by
+    // note text, and tokenizing every note would slow each load.
+    mutable std::unique_ptr<FullTextIndex> textIndex_;
+    mutable std::mutex textIndexMutex_;
+    bool stemWords_ {true};                          // textIndex_ reduces words to stems
+    std::vector<SortKey> resultOrder_;               // DisplaySearchResults / reports; empty = as found
+    mutable SnapshotWriter snapshotWriter_;          // background / durable saves
+    SnapshotWriter::Format saveFormat_ {SnapshotWriter::Format::Csv};
+    bool loadingFile_ {false};                       // suppresses autosave counting during load
+    bool bulkEditing_ {false};                       // EditLabels(): autosave hears the total once
+    std::unique_ptr<Autosaver> autosaver_;           // declared last: its thread stops first
     static const std::string DEFAULT_FILENAME;
+    static const size_t CSV_FIELD_COUNT;             // columns per record in the file
+    static const size_t RENDER_CACHE_BYTES;          // budget for renderCache_
+    static const size_t RESIDENT_RECORD_LIMIT;       // parsed lazy contacts kept in full
+    static const size_t HISTORY_LIMIT;               // undoable revisions kept
+    static const size_t READ_CHUNK_BYTES;            // load pipeline: bytes per file read
+    static const size_t PIPELINE_DEPTH;              // load pipeline: items queued between stages
+    static const size_t MAX_RECORD_BYTES;            // load pipeline: longest record carried between reads
+    static const size_t SCAN_CHUNK_CONTACTS;         // one-pass scans: contacts per task
+    static const size_t CHANGE_FEED_CAPACITY;        // newest events kept for pollers
 
     // Private helper methods
-    Contact* FindContactById(int contactId);
-    const Contact* FindContactById(int contactId) const;
+    ContactPtr FindContactById(int contactId) const;
     static bool ContainsCaseInsensitive(const std::string& str, const std::string& substr);
 
+    // Index maintenance: every mutation unindexes the old state and
+    // indexes the new one so lookups never need a full scan.
+    void IndexContact(const Contact& contact) const;
+    void UnindexContact(const Contact& contact) const;
+    void ReindexLabels(const Contact& before, const Contact& after) const;
+    OrderIndex& OrderFor(SortField field) const;
+    const FullTextIndex& TextIndex() const;
+    void RebuildPositions(size_t fromPosition);
+    bool EraseContact(int contactId);
+    bool ReplaceContact(const Contact& updated);
+    size_t CommitLabelEdit(const std::vector<int>& contactIds, const LabelEdit& edit);
+    size_t CommitLabelRename(const LabelEdit& edit, size_t holders);
+    void RenameLabel(const History::Rename& rename, bool forward);
+    static std::string DescribeLabelEdit(const LabelEdit& edit, size_t contacts);
+    void InsertAt(size_t position, ContactPtr stored, size_t shard);
+    void RemoveAt(size_t position);
+    void ReplaceAt(size_t position, ContactPtr replacement);
+    void RecordChange(const History::Change& change, const std::string& verb);
+    std::vector<Contact> CopyAllContacts() const;
+    void NoteMutation();
+    void AddContactToShard(const Contact& contact, size_t shard);
+    size_t FindShard(const std::string& name) const;
+    std::string ShardPath(size_t shard) const;
+    std::vector<SnapshotWriter::Job> ShardJobs(bool changedOnly) const;
+    void MarkUnsaved(const std::vector<std::string>& paths) const;
+    void BeginLoading();
+    void EndLoading();
+    void CommitParsedShard(ParsedShard& parsed, size_t shard);
+    static void RunLoadPipeline(const std::vector<std::string>& paths, unsigned decodeThreads, bool lazy,
+                                const std::function<bool(size_t, ParsedShard&)>& commit);
+    static void StreamShardFile(const std::string& path, unsigned decodeThreads, bool lazy,
+                                BoundedQueue<ParsedShard>& batches);
+    static size_t ParseRecords(const char* data, size_t size, bool final, size_t& lineOffset,
+                               ParsedShard& parsed);
+    static void ScanPreviews(ParsedShard& parsed);
+    static void ApplyFields(Contact& contact, const std::vector<std::string>& fields);
+
+    // Lazy loading: previews become full contacts on first access
+    static ContactPtr Materialize(const Contact& preview, const PendingRecord& record);
+    ContactPtr Full(const ContactPtr& stored) const;
+    void ForgetCached(int contactId) const;
+    void CollectPending(const std::vector<ContactPtr>& contacts, PendingWork& work) const;
+    static void ResolvePending(std::vector<ContactPtr>& contacts, const PendingWork& work);
+    std::vector<Contact> ContactsFromIds(const std::vector<int>& contactIds) const;
+    void SortByPosition(std::vector<int>& contactIds) const;
+
+    // Substring queries answered together in one pass over contacts_:
+    // (position in contacts_, ids of the selected queries it matched),
+    // in storage order.
+    typedef std::vector<std::pair<size_t, std::vector<size_t>>> ScanMatches;
+    static bool NeedsScan(const BatchQuery& query);
+    ScanMatches ScanOnce(const std::vector<BatchQuery>& queries, const std::vector<bool>& selected,
+                         unsigned threadCount) const;
+
 public:
+    AddressBook();
+
     // Helper method used by search methods
     void DisplaySearchResults(const std::vector<Contact>& results, const std::string& searchType) const;
 
@@ -25,34 +240,110 @@ public:
     bool EditContact(int contactId);
     bool EditContact(int contactId, const Contact& updatedContact);
     bool DeleteContact(int contactId);
+    bool MergeContacts(int survivorId, int duplicateId);
+
+    // History
+    bool Undo(std::string& label);
+    bool Redo(std::string& label);
+
+    // Change data capture
+    ChangeFeed& GetChangeFeed();
+    void StreamChangesTo(const std::string& path);
 
     // View operations
     void ListAllPreviews() const;
+    size_t ContactCount() const;
+    std::vector<Contact> ListSorted(const SortKey& order, size_t offset, size_t count) const;
     bool ViewContact(int contactId) const;
+    bool RenderContact(int contactId, RenderCache::Format format, std::string& text) const;
+    static Contact ContactFromFields(std::vector<std::string> fields);
+
+    // Builds the indexes, parsing lazily loaded records a batch at a
+    // time; they stay previews afterwards and reads parse them again.
+    // After it returns, const methods no longer change the book, so they
+    // may run on several threads at once (as long as nothing mutates
+    // meanwhile).
+    void EnsureIndexed() const;
 
     // Search operations
     std::vector<Contact> SearchByName(const std::string& nameQuery) const;
     std::vector<Contact> SearchByEmail(const std::string& emailQuery) const;
     std::vector<Contact> SearchByPhone(const std::string& phoneQuery) const;
+    std::vector<Contact> SearchByPhoneSuffix(const std::string& digits) const;
+    ContactPtr FindByCallerId(const std::string& phoneNumber) const;
+    std::vector<Contact> SearchByEmailDomain(const std::string& domain, bool includeSubdomains) const;
+    std::vector<Contact> SearchByEmailLocalPart(const std::string& localPart) const;
+    std::vector<Contact> SuggestByPrefix(const std::string& prefix, size_t limit) const;
+    std::vector<Contact> SearchByNameFuzzy(const std::string& nameQuery, int maxDistance, size_t limit) const;
+    std::vector<Contact> SearchBySoundsLike(const std::string& nameQuery) const;
+    std::vector<Contact> SearchText(const std::string& query) const;
+    std::vector<RankedMatch> SearchRanked(const std::string& query, size_t limit,
+                                          const Relevance::Scorer& scorer = Relevance::DefaultScore,
+                                          unsigned threadCount = 0) const;
+    std::vector<std::vector<Contact>> SearchBatch(const std::vector<BatchQuery>& queries,
+                                                  unsigned threadCount = 0) const;
+    std::vector<WatchMatch> MatchWatchList(const std::vector<BatchQuery>& queries,
+                                           unsigned threadCount = 0) const;
+
+    // Duplicate detection
+    std::vector<DuplicateFinder::MergeProposal> FindDuplicates(double minScore) const;
 
     // Filter operations
     std::vector<Contact> FilterByType(const std::string& type) const;
     std::vector<Contact> FilterByCity(const std::string& city) const;
+    std::vector<Contact> FilterByState(const std::string& state) const;
+    std::vector<Contact> FilterByPostalRange(int lowZip, int highZip) const;
+    std::vector<Contact> FilterByRegion(const std::string& state, const std::string& city,
+                                        int lowZip, int highZip) const;
     std::vector<Contact> FilterByTag(const std::string& tag) const;
+    std::vector<Contact> FilterByGroup(const std::string& group) const;
 
     // Tag/Group operations
     bool AddTag(int contactId, const std::string& tag);
     bool RemoveTag(int contactId, const std::string& tag);
     bool AssignToGroup(int contactId, const std::string& group);
     bool RemoveFromGroup(int contactId, const std::string& group);
+    size_t RemoveTagFromAll(const std::string& tag);
+    size_t RemoveGroupFromAll(const std::string& group);
+
+    // Bulk tag/group edits; each call is one undoable revision
+    size_t EditLabels(const std::vector<int>& contactIds, const LabelEdit& edit);
+    size_t EditLabelsForAll(const LabelEdit& edit);
 
     // File operations
     void LoadFromFile();
     void SaveToFile() const;
+    bool SaveToFileAsync(bool changedOnly = false,
+                         std::function<void(bool succeeded)> finished = nullptr) const;
+    SnapshotWriter::Status GetSaveStatus() const;
+    void AcknowledgeSaveStatus();
+    void WaitForSave() const;
+    std::vector<ContactPtr> Snapshot() const;
+    void EnableAutosave(const Autosaver::Policy& policy);
+    void SetCompressedSaves(bool compressed);
+    void SetLazyLoad(bool lazy);
+    void SetStemming(bool stem);
+
+    // Sharded books (a directory of files searched as one book)
+    void SetShardDirectory(const std::string& directory);
+    std::vector<ShardInfo> ListShards() const;
+    bool LoadShard(const std::string& name);
+    bool UnloadShard(const std::string& name, bool saveFirst);
+    bool SetActiveShard(const std::string& name);
+    bool IsSharded() const;
+
+    // Sorting
+    static void SortContacts(std::vector<Contact>& contacts, const std::vector<SortKey>& keys);
+    void SetResultOrder(const std::vector<SortKey>& keys);
+    const std::vector<SortKey>& GetResultOrder() const;
 
     // Reports
-    void ReportMissingInfo() const;
-    void ReportCountsByType() const;
-    void ReportGroupSummary() const;
+    void ReportMissingInfo(std::ostream& out = std::cout) const;
+    void ReportCountsByType(std::ostream& out = std::cout) const;
+    void ReportGroupSummary(std::ostream& out = std::cout) const;
+    void ReportEmailDomains(std::ostream& out = std::cout) const;
+    void ReportCacheStats(std::ostream& out = std::cout) const;
+    bool ReportWatchList(const std::string& path, std::ostream& out = std::cout) const;
+    RenderCache::Stats GetRenderCacheStats() const;
 
 };
\ No newline at end of file
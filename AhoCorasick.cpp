@@ -0,0 +1,106 @@
+//======================================================================
+// Implementation File: AhoCorasick.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Trie + failure links, flattened into a DFA over character classes.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * Build() assigns columns first (both cases of a letter share one),
+//     then inserts the patterns into a trie whose rows are already
+//     table-shaped, then fills the missing transitions breadth-first
+//     from each state's failure state, which is complete by then.
+//   * Output links skip failure states that end no pattern, so
+//     reporting costs one step per pattern found, not per suffix.
+//======================================================================
+
+#include "AhoCorasick.h"
+#include "TextUtils.h"
+#include <algorithm>
+#include <deque>
+
+size_t AhoCorasick::Add(const std::string &pattern) {
+    patterns_.push_back(TextUtils::FoldCase(pattern));
+    return patterns_.size() - 1;
+}
+
+void AhoCorasick::Build() {
+    classOf_.assign(256, 0);
+    classes_ = 1;
+    for (const auto &pattern : patterns_) {
+        for (const char c : pattern) {
+            const unsigned char byte = static_cast<unsigned char>(c);
+            if (classOf_[byte] != 0) continue;
+            classOf_[byte] = static_cast<unsigned short>(classes_);
+            if (byte >= 'a' && byte <= 'z') classOf_[byte - 'a' + 'A'] = static_cast<unsigned short>(classes_);
+            ++classes_;
+        }
+    }
+
+    next_.assign(classes_, -1);
+    endsHere_.assign(1, std::vector<size_t>());
+    matchEverything_.clear();
+    for (size_t id = 0; id < patterns_.size(); ++id) {
+        if (patterns_[id].empty()) {
+            matchEverything_.push_back(id);
+            continue;
+        }
+        size_t state = 0;
+        for (const char c : patterns_[id]) {
+            const size_t slot = state * classes_ + classOf_[static_cast<unsigned char>(c)];
+            if (next_[slot] < 0) {
+                next_[slot] = static_cast<int>(endsHere_.size());
+                endsHere_.emplace_back();
+                next_.resize(next_.size() + classes_, -1);
+            }
+            state = static_cast<size_t>(next_[slot]);
+        }
+        endsHere_[state].push_back(id);
+    }
+
+    // Breadth-first, so a state's failure state is finished before it.
+    const size_t states = endsHere_.size();
+    std::vector<int> failure(states, 0);
+    outputLink_.assign(states, -1);
+    std::deque<size_t> queue;
+    for (size_t column = 0; column < classes_; ++column) {
+        int &child = next_[column];
+        if (child <= 0) {
+            child = 0;
+        } else {
+            queue.push_back(static_cast<size_t>(child));
+        }
+    }
+    while (!queue.empty()) {
+        const size_t state = queue.front();
+        queue.pop_front();
+        const size_t fail = static_cast<size_t>(failure[state]);
+        for (size_t column = 0; column < classes_; ++column) {
+            int &child = next_[state * classes_ + column];
+            const int viaFailure = next_[fail * classes_ + column];
+            if (child < 0) {
+                child = viaFailure;
+                continue;
+            }
+            failure[child] = viaFailure;
+            outputLink_[child] = !endsHere_[viaFailure].empty() ? viaFailure : outputLink_[viaFailure];
+            queue.push_back(static_cast<size_t>(child));
+        }
+    }
+}
+
+void AhoCorasick::FindAll(const std::string &text, std::vector<size_t> &matches) const {
+    const size_t first = matches.size();
+    matches.insert(matches.end(), matchEverything_.begin(), matchEverything_.end());
+    if (next_.empty()) return;
+
+    size_t state = 0;
+    for (const char c : text) {
+        state = static_cast<size_t>(next_[state * classes_ + classOf_[static_cast<unsigned char>(c)]]);
+        for (int out = endsHere_[state].empty() ? outputLink_[state] : static_cast<int>(state); out >= 0;
+             out = outputLink_[out]) {
+            matches.insert(matches.end(), endsHere_[out].begin(), endsHere_[out].end());
+        }
+    }
+    std::sort(matches.begin() + static_cast<std::ptrdiff_t>(first), matches.end());
+    matches.erase(std::unique(matches.begin() + static_cast<std::ptrdiff_t>(first), matches.end()), matches.end());
+}
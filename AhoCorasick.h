@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/****************************************************************
+ * CLASS: AhoCorasick
+ * --------------------------------------------------------------
+ * Case-insensitive multi-pattern substring matcher. Any number of
+ * patterns are compiled into one automaton, and a single pass over
+ * a text reports every pattern it contains, so K substring queries
+ * cost one scan of a field instead of K.
+ *
+ * The automaton is a full DFA: every (state, character) pair has
+ * a precomputed next state, so the scan is one table load per
+ * byte with no failure-link walking. Characters that appear in no
+ * pattern share one column, which keeps the table small (states x
+ * distinct pattern characters, not states x 256).
+ *
+ * Case folding is ASCII, matching AddressBook's substring search.
+ * An empty pattern matches every text. Add all patterns, call
+ * Build() once, then FindAll() may run on many threads at once.
+ ***************************************************************/
+class AhoCorasick {
+public:
+    /************************************************************
+     * Add
+     * ----------------------------------------------------------
+     * PURPOSE : Register a pattern (before Build()).
+     * RETURNS : (size_t) Its id: 0 for the first pattern, then 1...
+     ***********************************************************/
+    size_t Add(const std::string &pattern);
+
+    /************************************************************
+     * Build
+     * ----------------------------------------------------------
+     * PURPOSE : Compile the patterns added so far into the DFA.
+     ***********************************************************/
+    void Build();
+
+    /************************************************************
+     * FindAll
+     * ----------------------------------------------------------
+     * PURPOSE : Append to matches the id of every pattern that
+     *           occurs in text, each id once, in ascending order.
+     ***********************************************************/
+    void FindAll(const std::string &text, std::vector<size_t> &matches) const;
+
+    size_t Size() const { return patterns_.size(); }
+
+private:
+    std::vector<std::string> patterns_;              // case-folded
+    std::vector<unsigned short> classOf_;            // byte -> column; 0 = in no pattern
+    size_t classes_ {1};
+    std::vector<int> next_;                          // state * classes_ + column -> state
+    std::vector<std::vector<size_t>> endsHere_;      // state -> patterns that end exactly here
+    std::vector<int> outputLink_;                    // state -> nearest suffix state with endsHere_, or -1
+    std::vector<size_t> matchEverything_;            // empty patterns
+};
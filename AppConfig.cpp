@@ -0,0 +1,196 @@
+//======================================================================
+// Implementation File: AppConfig.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Parse the optional config file and command-line flags.
+//======================================================================
+
+#include "AppConfig.h"
+#include "TextUtils.h"
+#include <cctype>
+#include <fstream>
+
+namespace {
+
+    std::string TrimSpaces(const std::string &text) {
+        size_t first = 0;
+        size_t last = text.size();
+        while (first < last && std::isspace(static_cast<unsigned char>(text[first]))) ++first;
+        while (last > first && std::isspace(static_cast<unsigned char>(text[last - 1]))) --last;
+        return text.substr(first, last - first);
+    }
+
+    bool ParseCount(const std::string &value, long &out) {
+        if (value.empty()) return false;
+        long parsed = 0;
+        for (char ch : value) {
+            if (ch < '0' || ch > '9') return false;
+            parsed = parsed * 10 + (ch - '0');
+            if (parsed > 1000000000L) return false;
+        }
+        out = parsed;
+        return true;
+    }
+
+    bool ParseSwitch(const std::string &value, bool &out) {
+        const std::string folded = TextUtils::FoldCase(value);
+        if (folded == "on" || folded == "true" || folded == "yes" || folded == "1") {
+            out = true;
+            return true;
+        }
+        if (folded == "off" || folded == "false" || folded == "no" || folded == "0") {
+            out = false;
+            return true;
+        }
+        return false;
+    }
+}
+
+//**********************************************************************
+// Apply (private)
+//----------------------------------------------------------------------
+// PURPOSE : Shared by the file and the flags; flag "--autosave-seconds"
+//           is normalized to key "autosave_seconds" before it gets here.
+//**********************************************************************
+bool AppConfig::Apply(const std::string &key, const std::string &value, std::string &problem) {
+    long number = 0;
+    if (key == "autosave") {
+        if (ParseSwitch(value, autosaveEnabled)) return true;
+        problem = "expected on/off";
+        return false;
+    }
+    if (key == "compress") {
+        if (ParseSwitch(value, compressSaves)) return true;
+        problem = "expected on/off";
+        return false;
+    }
+    if (key == "lazy_load") {
+        if (ParseSwitch(value, lazyLoad)) return true;
+        problem = "expected on/off";
+        return false;
+    }
+    if (key == "stem_words") {
+        if (ParseSwitch(value, stemWords)) return true;
+        problem = "expected on/off";
+        return false;
+    }
+    if (key == "shard_dir") {
+        if (value.empty()) {
+            problem = "expected a directory";
+            return false;
+        }
+        shardDirectory = value;
+        return true;
+    }
+    if (key == "change_stream") {
+        if (value.empty()) {
+            problem = "expected a file path";
+            return false;
+        }
+        changeStream = value;
+        return true;
+    }
+    if (key == "serve") {
+        if (value.empty()) {
+            problem = "expected a socket path";
+            return false;
+        }
+        serveSocket = value;
+        return true;
+    }
+    if (key == "watch_list") {
+        if (value.empty()) {
+            problem = "expected a file path";
+            return false;
+        }
+        watchList = value;
+        return true;
+    }
+    if (key == "benchmark") {
+        if (value == "compression" || value == "batch" || value == "ranking") {
+            benchmark = value;
+            return true;
+        }
+        problem = "unknown benchmark (available: compression, batch, ranking)";
+        return false;
+    }
+    if (key == "autosave_mutations" || key == "autosave_seconds" || key == "autosave_min_interval" ||
+        key == "server_threads") {
+        if (!ParseCount(value, number)) {
+            problem = "expected a whole number";
+            return false;
+        }
+        if (key == "autosave_mutations") autosaveMutations = static_cast<size_t>(number);
+        else if (key == "autosave_seconds") autosaveSeconds = number;
+        else if (key == "server_threads") serverThreads = static_cast<size_t>(number);
+        else autosaveMinIntervalSeconds = number;
+        return true;
+    }
+    problem = "unknown setting";
+    return false;
+}
+
+void AppConfig::ReadFile(std::vector<std::string> &warnings) {
+    std::ifstream file(configPath);
+    if (!file.is_open()) return;          // the file is optional
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = TrimSpaces(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        const size_t equals = line.find('=');
+        std::string problem = "expected key = value";
+        if (equals != std::string::npos &&
+            Apply(TrimSpaces(line.substr(0, equals)), TrimSpaces(line.substr(equals + 1)), problem)) {
+            continue;
+        }
+        warnings.push_back(configPath + ":" + std::to_string(lineNumber) + ": " + problem);
+    }
+}
+
+AppConfig AppConfig::Load(int argc, char *argv[], std::vector<std::string> &warnings) {
+    AppConfig config;
+
+    // --config must be known before the file is read
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (TextUtils::StartsWith(arg, "--config=")) config.configPath = arg.substr(9);
+    }
+    config.ReadFile(warnings);
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (TextUtils::StartsWith(arg, "--config=")) continue;
+
+        std::string problem = "unknown option";
+        if (arg == "--autosave" || arg == "--no-autosave") {
+            config.autosaveEnabled = (arg == "--autosave");
+            continue;
+        }
+        if (arg == "--compress" || arg == "--no-compress") {
+            config.compressSaves = (arg == "--compress");
+            continue;
+        }
+        if (arg == "--lazy-load" || arg == "--no-lazy-load") {
+            config.lazyLoad = (arg == "--lazy-load");
+            continue;
+        }
+        if (arg == "--stem-words" || arg == "--no-stem-words") {
+            config.stemWords = (arg == "--stem-words");
+            continue;
+        }
+        if (TextUtils::StartsWith(arg, "--") && arg.find('=') != std::string::npos) {
+            const size_t equals = arg.find('=');
+            std::string key = arg.substr(2, equals - 2);
+            for (char &ch : key) {
+                if (ch == '-') ch = '_';
+            }
+            if (config.Apply(key, arg.substr(equals + 1), problem)) continue;
+        }
+        warnings.push_back(arg + ": " + problem);
+    }
+    return config;
+}
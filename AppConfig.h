@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/****************************************************************
+ * STRUCT: AppConfig
+ * --------------------------------------------------------------
+ * Start-up settings, read from an optional "key = value" file and
+ * then overridden by command-line flags.
+ *
+ *   | File key               | Flag                        | Default |
+ *   |------------------------|-----------------------------|---------|
+ *   | autosave               | --autosave / --no-autosave  | off     |
+ *   | autosave_mutations     | --autosave-mutations=N      | 25      |
+ *   | autosave_seconds       | --autosave-seconds=T        | 120     |
+ *   | autosave_min_interval  | --autosave-min-interval=S   | 15      |
+ *   | compress               | --compress / --no-compress  | off     |
+ *   | shard_dir              | --shard-dir=DIR             | (none)  |
+ *   | lazy_load              | --lazy-load / --no-lazy-load| off     |
+ *   | stem_words             | --stem-words / --no-stem-words | on   |
+ *   | change_stream          | --change-stream=PATH        | (none)  |
+ *   | serve                  | --serve=SOCKET              | (none)  |
+ *   | server_threads         | --server-threads=N          | 0 (= cores) |
+ *   | watch_list             | --watch-list=FILE           | (none)  |
+ *   | (n/a)                  | --benchmark=NAME            | (none)  |
+ *   | (n/a)                  | --config=PATH               | addressbook.conf |
+ *
+ * Loading always detects the file format itself; compress only
+ * chooses how saves are written. --benchmark=compression prints
+ * ratio / speed figures for the block format, --benchmark=batch
+ * batch-query throughput per thread count, --benchmark=ranking
+ * ranked-search (top-K) timings, instead of starting the menu.
+ * shard_dir makes the book a directory of "*.csv" shard files,
+ * loaded in parallel and searched as one book. lazy_load starts
+ * from record offsets and names only; see AddressBook::LoadFromFile.
+ * change_stream appends one JSON line per change to PATH (a file
+ * or a FIFO); see ChangeStream. serve runs the Unix-socket server
+ * (see BookServer) instead of the menu. watch_list prints the
+ * contacts matching a file of searches and exits; see
+ * AddressBook::ReportWatchList. stem_words lets full-text search
+ * match "deliveries" to "delivery"; see FullTextIndex.
+ *
+ * Lines starting with '#' are comments. A value of 0 turns the
+ * matching trigger off. Unknown keys and bad values are reported
+ * as warnings and otherwise ignored, so a typo never stops the
+ * program from starting.
+ ***************************************************************/
+struct AppConfig {
+    bool autosaveEnabled {false};
+    size_t autosaveMutations {25};
+    long autosaveSeconds {120};
+    long autosaveMinIntervalSeconds {15};
+    bool compressSaves {false};              // save as BlockCodec blocks
+    std::string shardDirectory;              // empty: single addressbook.csv
+    bool lazyLoad {false};                   // parse full records on first use
+    bool stemWords {true};                   // full-text search matches word stems
+    std::string changeStream;                // NDJSON change events go here
+    std::string serveSocket;                 // serve the book here instead of the menu
+    size_t serverThreads {0};                // server query workers; 0 = one per core
+    std::string watchList;                   // report matches for this file of searches and exit
+    std::string benchmark;                   // run this benchmark and exit
+    std::string configPath {"addressbook.conf"};
+
+    /************************************************************
+     * Load (static)
+     * ----------------------------------------------------------
+     * PURPOSE : Defaults <- config file <- command-line flags.
+     * PARAMS  : argc / argv (IN)  - as passed to main()
+     *           warnings    (OUT) - one line per ignored setting
+     * RETURNS : (AppConfig) The effective configuration.
+     ***********************************************************/
+    static AppConfig Load(int argc, char *argv[], std::vector<std::string> &warnings);
+
+private:
+    bool Apply(const std::string &key, const std::string &value, std::string &problem);
+    void ReadFile(std::vector<std::string> &warnings);
+};
@@ -0,0 +1,157 @@
+//======================================================================
+// Implementation File: Autosaver.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Count/age autosave triggers with a rate limit, on one timer thread.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * The timer thread sleeps on a condition variable until the next
+//     moment a trigger could fire; NoteMutation only wakes it when the
+//     first edit arrives (to arm the age trigger) or the count is hit.
+//   * The pending count is cleared before the save callback runs, since
+//     the snapshot taken inside the callback covers those edits. If the
+//     callback reports busy, the count is restored and retried shortly;
+//     a save that starts but fails restores it when it reports back.
+//======================================================================
+
+#include "Autosaver.h"
+#include <algorithm>
+
+namespace {
+    // How long to back off when a save is already in progress.
+    const std::chrono::seconds BUSY_RETRY_DELAY(1);
+}
+
+Autosaver::Autosaver(const Policy &policy, std::function<bool(Done)> save)
+    : policy_(policy), save_(std::move(save)) {
+    timer_ = std::thread(&Autosaver::Run, this);
+}
+
+Autosaver::~Autosaver() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (timer_.joinable()) timer_.join();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    settled_.wait(lock, [this] { return outstanding_ == 0; });
+}
+
+void Autosaver::NoteMutation(size_t count) {
+    if (count == 0) return;
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const size_t before = pending_;
+        pending_ += count;
+        if (before == 0) {
+            firstPending_ = Clock::now();
+            wake = true;
+        }
+        if (policy_.mutationThreshold > 0 && before < policy_.mutationThreshold &&
+            pending_ >= policy_.mutationThreshold) wake = true;
+    }
+    if (wake) wake_.notify_one();
+}
+
+void Autosaver::NoteSaved() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_ = 0;
+}
+
+size_t Autosaver::PendingMutations() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_;
+}
+
+size_t Autosaver::SavesTriggered() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return savesTriggered_;
+}
+
+//**********************************************************************
+// DueLocked (private)
+//----------------------------------------------------------------------
+// PURPOSE : true if a save should start now; otherwise wakeAt is the
+//           earliest time one could (max() = wait for a mutation).
+//           The rate limit only ever delays a trigger, never drops it.
+//**********************************************************************
+bool Autosaver::DueLocked(Clock::time_point now, Clock::time_point &wakeAt) const {
+    wakeAt = Clock::time_point::max();
+    if (pending_ == 0) return false;
+
+    Clock::time_point triggerAt = Clock::time_point::max();
+    if (policy_.mutationThreshold > 0 && pending_ >= policy_.mutationThreshold) {
+        triggerAt = now;
+    }
+    if (policy_.maxDelay.count() > 0) {
+        triggerAt = std::min(triggerAt, firstPending_ + policy_.maxDelay);
+    }
+    if (triggerAt == Clock::time_point::max()) return false;
+
+    triggerAt = std::max(triggerAt, nextAllowed_);
+    if (triggerAt <= now) return true;
+    wakeAt = triggerAt;
+    return false;
+}
+
+//  Puts edits a save did not write back in front of the pending ones.
+void Autosaver::RestoreLocked(size_t covered, Clock::time_point coveredSince) {
+    if (covered == 0) return;
+    if (pending_ == 0) firstPending_ = coveredSince;
+    else firstPending_ = std::min(firstPending_, coveredSince);
+    pending_ += covered;
+}
+
+//**********************************************************************
+// Run (private, timer thread)
+//----------------------------------------------------------------------
+// PURPOSE : nextAllowed_ is the earliest time the next save may start:
+//           minInterval after a started save, BUSY_RETRY_DELAY after a
+//           refused one. A started save carries the edits it covered to
+//           its Done, which only gives them back on failure; the retry
+//           then waits out the same minInterval.
+//**********************************************************************
+void Autosaver::Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        const Clock::time_point now = Clock::now();
+        Clock::time_point wakeAt;
+        if (!DueLocked(now, wakeAt)) {
+            if (wakeAt == Clock::time_point::max()) {
+                wake_.wait(lock);
+            } else {
+                wake_.wait_until(lock, wakeAt);
+            }
+            continue;
+        }
+
+        const size_t covered = pending_;
+        const Clock::time_point coveredSince = firstPending_;
+        pending_ = 0;
+        ++outstanding_;
+
+        lock.unlock();
+        const bool started = save_([this, covered, coveredSince](bool succeeded) {
+            // Notified under the lock: once outstanding_ reaches zero
+            // the destructor may finish as soon as the lock is free.
+            std::lock_guard<std::mutex> guard(mutex_);
+            if (!succeeded) RestoreLocked(covered, coveredSince);
+            --outstanding_;
+            wake_.notify_one();
+            settled_.notify_all();
+        });
+        lock.lock();
+
+        if (started) {
+            ++savesTriggered_;
+            nextAllowed_ = Clock::now() + policy_.minInterval;
+        } else {
+            --outstanding_;
+            RestoreLocked(covered, coveredSince);
+            nextAllowed_ = Clock::now() + BUSY_RETRY_DELAY;
+        }
+    }
+}
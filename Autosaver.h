@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/****************************************************************
+ * CLASS: Autosaver
+ * --------------------------------------------------------------
+ * Decides when to save. Mutations are counted; a timer thread
+ * fires a save when either
+ *
+ *   | Trigger   | Condition                                     |
+ *   |-----------|-----------------------------------------------|
+ *   | count     | mutationThreshold edits are pending           |
+ *   | age       | the oldest unsaved edit is maxDelay old       |
+ *
+ * whichever comes first, but never sooner than minInterval after
+ * the previous autosave. A burst of edits (an import, a bulk tag
+ * change) therefore coalesces into one save per minInterval
+ * instead of one full rewrite per edit.
+ *
+ * The save itself is a callback (the address book's background
+ * save), so this class knows nothing about files. If the save is
+ * busy the callback returns false and the edits stay pending; if
+ * it starts but later fails, the edits it covered are pending
+ * again.
+ ***************************************************************/
+class Autosaver {
+public:
+    struct Policy {
+        size_t mutationThreshold;             // 0 = count trigger off
+        std::chrono::seconds maxDelay;        // 0 = age trigger off
+        std::chrono::seconds minInterval;     // rate limit between saves
+    };
+
+    typedef std::function<void(bool succeeded)> Done;
+
+    /************************************************************
+     * Autosaver
+     * ----------------------------------------------------------
+     * PARAMS  : policy (IN) - trigger thresholds
+     *           save   (IN) - starts a save and calls its Done
+     *                         argument once with the outcome (from
+     *                         any thread, possibly before returning);
+     *                         false if it could not start, and then
+     *                         Done is not called (runs on the timer
+     *                         thread)
+     ***********************************************************/
+    Autosaver(const Policy &policy, std::function<bool(Done)> save);
+
+    /************************************************************
+     * ~Autosaver
+     * ----------------------------------------------------------
+     * PURPOSE : Stops the timer and waits for started saves to
+     *           report back, so no Done outlives the object.
+     ***********************************************************/
+    ~Autosaver();
+
+    Autosaver(const Autosaver &) = delete;
+    Autosaver &operator=(const Autosaver &) = delete;
+
+    /************************************************************
+     * NoteMutation
+     * ----------------------------------------------------------
+     * PURPOSE : Record count edits (a bulk edit reports its total
+     *           once); wakes the timer thread when the count
+     *           trigger is reached.
+     ***********************************************************/
+    void NoteMutation(size_t count = 1);
+
+    /************************************************************
+     * NoteSaved
+     * ----------------------------------------------------------
+     * PURPOSE : A manual save covered every pending edit.
+     ***********************************************************/
+    void NoteSaved();
+
+    size_t PendingMutations() const;
+    size_t SavesTriggered() const;
+    const Policy &GetPolicy() const { return policy_; }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    void Run();
+    bool DueLocked(Clock::time_point now, Clock::time_point &wakeAt) const;
+    void RestoreLocked(size_t covered, Clock::time_point coveredSince);
+
+    const Policy policy_;
+    const std::function<bool(Done)> save_;
+
+    mutable std::mutex mutex_;              // guards everything below
+    std::condition_variable wake_;
+    std::condition_variable settled_;       // a started save reported back
+    size_t pending_ {0};
+    size_t outstanding_ {0};                // started saves not yet reported
+    size_t savesTriggered_ {0};
+    Clock::time_point firstPending_;
+    Clock::time_point nextAllowed_;
+    bool stopping_ {false};
+    std::thread timer_;                     // started last, joined first
+};
@@ -0,0 +1,423 @@
+//======================================================================
+// Implementation File: Benchmarks.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   --benchmark=compression: ratio and speed of the block format.
+//   --benchmark=batch: SearchBatch throughput per thread count.
+//   --benchmark=ranking: ranked search, top-K vs. sorting every match.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * Every figure is the best of a few repetitions, which keeps the
+//     numbers stable on a busy machine.
+//   * "load" = decompress (all cores) + CSV parse, i.e. the part of
+//     LoadFromFile that the file format affects; index building is
+//     the same for both formats and is left out.
+//   * The batch and ranking benchmarks build their book in memory
+//     from generated records, so they never depend on (or touch)
+//     addressbook.csv.
+//======================================================================
+
+#include "Benchmarks.h"
+#include "AddressBook.h"
+#include "BlockCodec.h"
+#include "Contact.h"
+#include "CsvCodec.h"
+#include "Relevance.h"
+#include "TextUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    const int REPETITIONS = 3;
+    const size_t GENERATED_RECORDS = 200000;
+    const size_t BLOCK_SIZES[] = { 64 * 1024, 256 * 1024, 1024 * 1024 };
+    const size_t BATCH_BOOK_RECORDS = 20000;
+    const size_t BATCH_QUERIES = 20000;
+    const size_t SKEWED_SCAN_EVERY = 1000;       // one full name scan per 1000 queries
+    const size_t RANKING_BOOK_RECORDS = 20000;
+    const size_t RANKING_LIMITS[] = { 10, 100 };
+    const char *const RANKING_QUERIES[] = { "smith", "john", "mi", "conference", "maria garcia" };
+
+    typedef std::chrono::steady_clock Clock;
+
+    template <typename Work>
+    double BestMilliseconds(Work work) {
+        double best = 0.0;
+        for (int r = 0; r < REPETITIONS; ++r) {
+            const Clock::time_point start = Clock::now();
+            work();
+            const double elapsed =
+                std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if (r == 0 || elapsed < best) best = elapsed;
+        }
+        return best;
+    }
+
+    // Address-book-shaped data: few cities/states/domains/tags, unique
+    // names, emails and phone numbers.
+    std::string GenerateBook(size_t records) {
+        static const char *FIRST[] = { "James", "Mary", "Robert", "Patricia", "John", "Jennifer",
+                                       "Michael", "Linda", "David", "Elizabeth", "Maria", "Wei" };
+        static const char *LAST[] = { "Smith", "Johnson", "Williams", "Brown", "Jones", "Garcia",
+                                      "Miller", "Davis", "Rodriguez", "Martinez", "Nguyen", "Kim" };
+        static const char *CITY[][3] = { { "Irvine", "CA", "926" }, { "Mission Viejo", "CA", "926" },
+                                         { "Austin", "TX", "787" }, { "Seattle", "WA", "981" },
+                                         { "Portland", "OR", "972" }, { "Denver", "CO", "802" } };
+        static const char *DOMAIN[] = { "gmail.com", "yahoo.com", "outlook.com", "acme-corp.com",
+                                        "saddleback.edu" };
+        static const char *TAG[] = { "vip", "newsletter", "customer", "lead", "" };
+        static const char *GROUP[] = { "Family", "Work", "Friends", "Vendors" };
+
+        std::string csv;
+        unsigned state = 12345;
+        auto next = [&state]() { state = state * 1103515245u + 12345u; return (state >> 8) & 0xFFFF; };
+
+        for (size_t i = 0; i < records; ++i) {
+            const char *first = FIRST[next() % 12];
+            const char *last = LAST[next() % 12];
+            const char *const *place = CITY[next() % 6];
+            std::ostringstream email, phone, street, zip;
+            email << first[0] << last << i << "@" << DOMAIN[next() % 5];
+            phone << "(" << (200 + next() % 800) << ") 555-" << std::setw(4) << std::setfill('0') << next() % 10000;
+            street << (100 + next() % 9900) << " Main St";
+            zip << place[2] << std::setw(2) << std::setfill('0') << next() % 100;
+
+            Contact contact(static_cast<ContactType>(next() % 4), first, last, email.str(), phone.str(),
+                            street.str(), place[0], place[1], zip.str(),
+                            (i % 7 == 0) ? "Met at the conference, follow up" : "");
+            contact.addGroup(GROUP[next() % 4]);
+            contact.addTag(TAG[next() % 5]);
+            csv += contact.toCSV();
+            csv += '\n';
+        }
+        return csv;
+    }
+
+    // Existing book (either format) if there is one, else generated.
+    std::string LoadSample(std::string &source) {
+        std::ifstream file("addressbook.csv", std::ios::binary);
+        std::string bytes;
+        if (file.is_open()) {
+            bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        if (BlockCodec::HasMagic(bytes.data(), bytes.size())) {
+            std::istringstream in(bytes.substr(BlockCodec::MAGIC_SIZE));
+            BlockCodec::FrameReader reader(in);
+            std::vector<BlockCodec::Frame> frames;
+            BlockCodec::Frame frame;
+            while (reader.Next(frame)) frames.push_back(std::move(frame));
+            std::vector<std::string> blocks;
+            std::string error;
+            if (reader.Error().empty() && BlockCodec::DecodeFrames(frames, blocks, 0, error)) {
+                std::string csv;
+                for (const auto &block : blocks) csv += block;
+                source = "addressbook.csv (compressed)";
+                return csv;
+            }
+        } else if (!bytes.empty()) {
+            source = "addressbook.csv";
+            return bytes;
+        }
+        source = "generated";
+        return GenerateBook(GENERATED_RECORDS);
+    }
+
+    size_t ParseAll(const std::string &text) {
+        Csv::Reader reader(text.data(), text.size());
+        std::vector<std::string> fields;
+        size_t records = 0;
+        while (reader.Next(fields)) ++records;
+        return records;
+    }
+
+    // Cuts the text into blocks of whole records, as SnapshotWriter does.
+    std::string EncodeFile(const std::string &csv, size_t blockSize) {
+        std::string file(BlockCodec::MAGIC, BlockCodec::MAGIC_SIZE);
+        Csv::Reader reader(csv.data(), csv.size());
+        std::vector<std::string> fields;
+        size_t blockStart = 0;
+        while (reader.Next(fields)) {
+            if (reader.Offset() - blockStart >= blockSize) {
+                BlockCodec::AppendFrame(file, csv.data() + blockStart, reader.Offset() - blockStart);
+                blockStart = reader.Offset();
+            }
+        }
+        if (blockStart < csv.size()) {
+            BlockCodec::AppendFrame(file, csv.data() + blockStart, csv.size() - blockStart);
+        }
+        BlockCodec::AppendEndFrame(file);
+        return file;
+    }
+
+    // Generated records added one by one, as if typed in; the phone
+    // numbers are returned for building caller-id queries.
+    void BuildBook(AddressBook &book, size_t records, std::vector<std::string> &phones) {
+        const std::string csv = GenerateBook(records);
+        Csv::Reader reader(csv.data(), csv.size());
+        std::vector<std::string> fields;
+        while (reader.Next(fields)) {
+            fields.erase(fields.begin());             // id: a fresh one is assigned
+            phones.push_back(fields.size() > 4 ? fields[4] : std::string());
+            book.AddContact(AddressBook::ContactFromFields(fields));
+        }
+    }
+
+    bool SameResults(const std::vector<std::vector<Contact>> &a, const std::vector<std::vector<Contact>> &b) {
+        if (a.size() != b.size()) return false;
+        for (size_t q = 0; q < a.size(); ++q) {
+            if (a[q].size() != b[q].size()) return false;
+            for (size_t r = 0; r < a[q].size(); ++r) {
+                if (a[q][r].getId() != b[q][r].getId()) return false;
+            }
+        }
+        return true;
+    }
+
+    // The straightforward ranking: score everyone, sort every match.
+    std::vector<Relevance::TopK::Hit> SortAllMatches(const std::vector<ContactPtr> &contacts,
+                                                     const Relevance::Query &query,
+                                                     const Relevance::Scorer &scorer) {
+        std::vector<Relevance::TopK::Hit> hits;
+        for (size_t i = 0; i < contacts.size(); ++i) {
+            const double score = scorer(*contacts[i], query);
+            if (score > 0.0) hits.push_back(Relevance::TopK::Hit { score, i });
+        }
+        std::sort(hits.begin(), hits.end(), [](const Relevance::TopK::Hit &a, const Relevance::TopK::Hit &b) {
+            return a.score != b.score ? a.score > b.score : a.item < b.item;
+        });
+        return hits;
+    }
+
+    bool SameRanking(const std::vector<AddressBook::RankedMatch> &ranked,
+                     const std::vector<Relevance::TopK::Hit> &sorted, const std::vector<ContactPtr> &contacts,
+                     size_t limit) {
+        if (ranked.size() != std::min(limit, sorted.size())) return false;
+        for (size_t r = 0; r < ranked.size(); ++r) {
+            if (ranked[r].contact.getId() != contacts[sorted[r].item]->getId() ||
+                ranked[r].score != sorted[r].score) return false;
+        }
+        return true;
+    }
+
+    std::vector<BlockCodec::Frame> ReadFrames(const std::string &file) {
+        std::istringstream in(file.substr(BlockCodec::MAGIC_SIZE));
+        BlockCodec::FrameReader reader(in);
+        std::vector<BlockCodec::Frame> frames;
+        BlockCodec::Frame frame;
+        while (reader.Next(frame)) frames.push_back(std::move(frame));
+        return frames;
+    }
+}
+
+namespace Benchmarks {
+
+int RunCompression(std::ostream &out) {
+    std::string source;
+    const std::string csv = LoadSample(source);
+    const size_t records = ParseAll(csv);
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    out << "\n=== Compression Benchmark ===\n"
+        << "Source: " << source << " (" << records << " records, " << csv.size() << " bytes)\n"
+        << "Decode threads: " << cores << "; best of " << REPETITIONS << " runs\n\n";
+
+    out << std::left << std::setw(12) << "format" << std::right
+        << std::setw(12) << "bytes" << std::setw(8) << "ratio"
+        << std::setw(12) << "save ms" << std::setw(14) << "decode 1T ms"
+        << std::setw(14) << "decode NT ms" << std::setw(12) << "load ms" << "\n";
+    out << std::fixed << std::setprecision(1);
+
+    const double csvParse = BestMilliseconds([&]() { ParseAll(csv); });
+    out << std::left << std::setw(12) << "csv" << std::right
+        << std::setw(12) << csv.size() << std::setw(8) << 1.0
+        << std::setw(12) << "-" << std::setw(14) << "-" << std::setw(14) << "-"
+        << std::setw(12) << csvParse << "\n";
+
+    int status = 0;
+    for (size_t blockSize : BLOCK_SIZES) {
+        std::string file;
+        const double saveMs = BestMilliseconds([&]() { file = EncodeFile(csv, blockSize); });
+        const std::vector<BlockCodec::Frame> frames = ReadFrames(file);
+
+        std::vector<std::string> blocks;
+        std::string error;
+        bool ok = true;
+        const double decodeOne = BestMilliseconds([&]() {
+            ok = BlockCodec::DecodeFrames(frames, blocks, 1, error) && ok;
+        });
+        const double decodeAll = BestMilliseconds([&]() {
+            ok = BlockCodec::DecodeFrames(frames, blocks, cores, error) && ok;
+        });
+        size_t loaded = 0;
+        const double loadMs = BestMilliseconds([&]() {
+            ok = BlockCodec::DecodeFrames(frames, blocks, cores, error) && ok;
+            loaded = 0;
+            for (const auto &block : blocks) loaded += ParseAll(block);
+        });
+
+        std::string roundTrip;
+        for (const auto &block : blocks) roundTrip += block;
+        if (!ok || loaded != records || roundTrip != csv) {
+            out << "Round trip FAILED at block size " << blockSize << ": " << error << "\n";
+            status = 1;
+            continue;
+        }
+
+        std::ostringstream label;
+        label << "abz " << blockSize / 1024 << "K";
+        out << std::left << std::setw(12) << label.str() << std::right
+            << std::setw(12) << file.size()
+            << std::setw(8) << static_cast<double>(csv.size()) / static_cast<double>(file.size())
+            << std::setw(12) << saveMs << std::setw(14) << decodeOne
+            << std::setw(14) << decodeAll << std::setw(12) << loadMs << "\n";
+    }
+
+    out << "\nratio = csv bytes / compressed bytes; load = decode on all threads + parse.\n";
+    return status;
+}
+
+int RunBatchQueries(std::ostream &out) {
+    AddressBook book;
+    std::vector<std::string> phones;
+    BuildBook(book, BATCH_BOOK_RECORDS, phones);
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    // Uniform: caller-id probes, every fourth one for an unknown number.
+    // Skewed: the same, except that every SKEWED_SCAN_EVERY-th query is
+    // a substring name search, which scans the whole book.
+    typedef AddressBook::BatchQuery Query;
+    std::vector<Query> uniform;
+    std::vector<Query> skewed;
+    for (size_t q = 0; q < BATCH_QUERIES; ++q) {
+        const Query probe { Query::Kind::CallerId,
+                            q % 4 == 3 ? "(199) 555-" + std::to_string(1000 + q % 9000) : phones[q % phones.size()] };
+        uniform.push_back(probe);
+        skewed.push_back(q % SKEWED_SCAN_EVERY == 0 ? Query { Query::Kind::Name, "wei kim" } : probe);
+    }
+
+    std::vector<unsigned> threadCounts;
+    for (unsigned t = 1; t < cores; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(cores);
+
+    out << "\n=== Batch Query Benchmark ===\n"
+        << "Book: generated (" << book.Snapshot().size() << " contacts); "
+        << BATCH_QUERIES << " queries per batch; best of " << REPETITIONS << " runs\n"
+        << "skewed = caller-id probes with one full name scan per " << SKEWED_SCAN_EVERY << " queries\n\n";
+
+    out << std::left << std::setw(10) << "threads" << std::right
+        << std::setw(14) << "uniform ms" << std::setw(12) << "speedup"
+        << std::setw(14) << "skewed ms" << std::setw(12) << "speedup" << "\n";
+    out << std::fixed << std::setprecision(1);
+
+    int status = 0;
+    std::vector<std::vector<Contact>> uniformExpected;
+    std::vector<std::vector<Contact>> skewedExpected;
+    double uniformBase = 0.0;
+    double skewedBase = 0.0;
+    for (unsigned threads : threadCounts) {
+        std::vector<std::vector<Contact>> uniformResults;
+        std::vector<std::vector<Contact>> skewedResults;
+        const double uniformMs = BestMilliseconds([&]() { uniformResults = book.SearchBatch(uniform, threads); });
+        const double skewedMs = BestMilliseconds([&]() { skewedResults = book.SearchBatch(skewed, threads); });
+        if (threads == 1) {
+            uniformExpected = uniformResults;
+            skewedExpected = skewedResults;
+            uniformBase = uniformMs;
+            skewedBase = skewedMs;
+        } else if (!SameResults(uniformResults, uniformExpected) || !SameResults(skewedResults, skewedExpected)) {
+            out << "Results at " << threads << " threads differ from 1 thread\n";
+            status = 1;
+        }
+        out << std::left << std::setw(10) << threads << std::right
+            << std::setw(14) << uniformMs << std::setw(11) << uniformBase / uniformMs << "x"
+            << std::setw(14) << skewedMs << std::setw(11) << skewedBase / skewedMs << "x\n";
+    }
+
+    out << "\nspeedup = time at 1 thread / time at N threads.\n";
+    return status;
+}
+
+int RunRanking(std::ostream &out) {
+    AddressBook book;
+    std::vector<std::string> phones;
+    BuildBook(book, RANKING_BOOK_RECORDS, phones);
+    const std::vector<ContactPtr> contacts = book.Snapshot();
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    out << "\n=== Ranked Search Benchmark ===\n"
+        << "Book: generated (" << contacts.size() << " contacts); " << cores
+        << " threads; best of " << REPETITIONS << " runs\n\n";
+
+    out << std::left << std::setw(14) << "query" << std::right
+        << std::setw(10) << "matches" << std::setw(14) << "sort all ms";
+    for (size_t limit : RANKING_LIMITS) {
+        out << std::setw(11) << ("top-" + std::to_string(limit)) << " 1T"
+            << std::setw(11) << ("top-" + std::to_string(limit)) << " NT";
+    }
+    out << "\n" << std::fixed << std::setprecision(2);
+
+    int status = 0;
+    for (const char *text : RANKING_QUERIES) {
+        const Relevance::Query query = Relevance::ParseQuery(text);
+        std::vector<Relevance::TopK::Hit> sorted;
+        const double sortMs = BestMilliseconds([&]() {
+            sorted = SortAllMatches(contacts, query, Relevance::DefaultScore);
+        });
+        out << std::left << std::setw(14) << text << std::right
+            << std::setw(10) << sorted.size() << std::setw(14) << sortMs;
+        for (size_t limit : RANKING_LIMITS) {
+            for (unsigned threads : { 1u, cores }) {
+                std::vector<AddressBook::RankedMatch> ranked;
+                const double rankMs = BestMilliseconds([&]() {
+                    ranked = book.SearchRanked(text, limit, Relevance::DefaultScore, threads);
+                });
+                if (!SameRanking(ranked, sorted, contacts, limit)) {
+                    status = 1;
+                }
+                out << std::setw(14) << rankMs;
+            }
+        }
+        out << "\n";
+    }
+    if (status != 0) {
+        out << "Top-K results differ from sorting every match\n";
+    }
+
+    // Pluggable scorers: the same top-10 search under other rules.
+    Relevance::Weights nameOnly;
+    nameOnly.email = 0.0;
+    nameOnly.notes = 0.0;
+    const Relevance::Scorer scorers[] = {
+        Relevance::DefaultScore,
+        Relevance::FieldScorer(nameOnly),
+        [](const Contact &contact, const Relevance::Query &query) {   // substring anywhere in the name
+            double score = 0.0;
+            for (const std::string &term : query.terms) {
+                if (TextUtils::FoldCase(contact.getFullName()).find(term) != std::string::npos) score += 1.0;
+            }
+            return score;
+        },
+    };
+    const char *const SCORER_NAMES[] = { "default", "name only", "name contains" };
+
+    out << "\n" << std::left << std::setw(16) << "scorer" << std::right
+        << std::setw(14) << "\"mi\" top-10 NT" << "\n";
+    for (size_t s = 0; s < sizeof(scorers) / sizeof(scorers[0]); ++s) {
+        const double ms = BestMilliseconds([&]() { book.SearchRanked("mi", 10, scorers[s], cores); });
+        out << std::left << std::setw(16) << SCORER_NAMES[s] << std::right << std::setw(14) << ms << "\n";
+    }
+
+    out << "\nsort all = score every contact and sort all matches (1 thread); "
+        << "top-K = AddressBook::SearchRanked at 1 / N threads (ms).\n";
+    return status;
+}
+
+}
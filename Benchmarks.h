@@ -0,0 +1,48 @@
+#pragma once
+
+#include <ostream>
+
+/****************************************************************
+ * NAMESPACE: Benchmarks
+ * --------------------------------------------------------------
+ * Self-contained measurements selected with --benchmark=NAME.
+ * They print a table and return a process exit code; the menu is
+ * never started and addressbook.csv is never written.
+ ***************************************************************/
+namespace Benchmarks {
+
+    /************************************************************
+     * RunCompression
+     * ----------------------------------------------------------
+     * PURPOSE : Compression ratio vs. load cost of the block
+     *           format at several block sizes, against plain CSV.
+     *           Uses the records in addressbook.csv when present,
+     *           otherwise a generated book.
+     * RETURNS : (int) 0 on success, 1 if a round trip failed.
+     ***********************************************************/
+    int RunCompression(std::ostream &out);
+
+    /************************************************************
+     * RunBatchQueries
+     * ----------------------------------------------------------
+     * PURPOSE : AddressBook::SearchBatch throughput at 1, 2, 4 ...
+     *           threads on a generated book, for a uniform batch
+     *           (caller-id probes) and a skewed one (the same with
+     *           a few full name scans mixed in).
+     * RETURNS : (int) 0 on success, 1 if any thread count gave
+     *           different results from one thread.
+     ***********************************************************/
+    int RunBatchQueries(std::ostream &out);
+
+    /************************************************************
+     * RunRanking
+     * ----------------------------------------------------------
+     * PURPOSE : AddressBook::SearchRanked time for top-10 and
+     *           top-100 at 1 and N threads, against scoring every
+     *           contact and sorting all matches, on a generated
+     *           book; then the same search under other scorers.
+     * RETURNS : (int) 0 on success, 1 if a top-K result differs
+     *           from the head of the fully sorted matches.
+     ***********************************************************/
+    int RunRanking(std::ostream &out);
+}
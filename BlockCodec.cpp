@@ -0,0 +1,278 @@
+//======================================================================
+// Implementation File: BlockCodec.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Greedy hash-chain-free LZ77 (one candidate per 4-byte hash) with an
+//   LZ4-style sequence format, plus the framed block container.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * One hash probe per position keeps compression fast; address book
+//     text is repetitive enough (cities, states, domains, tags) that a
+//     single candidate finds most of the matches.
+//   * The last MATCH_GUARD bytes of a block are always literals, so the
+//     match extension loop never needs a separate end check for reads.
+//   * Decompression writes into a pre-sized buffer and checks every
+//     length and offset against it; corrupt files fail cleanly.
+//======================================================================
+
+#include "BlockCodec.h"
+#include "WorkStealing.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace BlockCodec {
+
+const char MAGIC[4] = { 'A', 'B', 'Z', '1' };
+
+}
+
+namespace {
+
+    const size_t MIN_MATCH = 4;
+    const size_t MATCH_GUARD = 5;
+    const size_t MAX_OFFSET = 65535;
+    const unsigned HASH_BITS = 14;
+    const std::uint32_t STORED_FLAG = 0x80000000u;
+
+    inline std::uint32_t Read32(const char *p) {
+        std::uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline std::uint32_t HashOf(std::uint32_t sequence) {
+        return (sequence * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    void PutLength(std::string &out, size_t length) {
+        while (length >= 255) {
+            out.push_back(static_cast<char>(255));
+            length -= 255;
+        }
+        out.push_back(static_cast<char>(length));
+    }
+
+    void PutU32(std::string &out, std::uint32_t value) {
+        for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+
+    std::uint32_t GetU32(const unsigned char *p) {
+        return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+               (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+    }
+
+    std::uint32_t Fnv1a(const char *data, size_t size) {
+        std::uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    void EmitSequence(std::string &out, const char *literals, size_t literalCount,
+                      size_t offset, size_t matchLength) {
+        const size_t matchCode = matchLength ? matchLength - MIN_MATCH : 0;
+        const unsigned char token = static_cast<unsigned char>(
+            (std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(matchCode, 15));
+        out.push_back(static_cast<char>(token));
+        if (literalCount >= 15) PutLength(out, literalCount - 15);
+        out.append(literals, literalCount);
+        if (matchLength == 0) return;          // final, literals-only sequence
+        out.push_back(static_cast<char>(offset & 0xFF));
+        out.push_back(static_cast<char>(offset >> 8));
+        if (matchCode >= 15) PutLength(out, matchCode - 15);
+    }
+
+    // Reads a 15-extended length; false if the input runs out.
+    bool GetLength(const unsigned char *&in, const unsigned char *end, size_t &length) {
+        if (length != 15) return true;
+        unsigned char byte;
+        do {
+            if (in >= end) return false;
+            byte = *in++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+}
+
+namespace BlockCodec {
+
+void Compress(const char *data, size_t size, std::string &out) {
+    std::vector<std::int32_t> table(static_cast<size_t>(1) << HASH_BITS, -1);
+    size_t anchor = 0;
+    size_t i = 0;
+
+    if (size > MATCH_GUARD + MIN_MATCH) {
+        const size_t limit = size - MATCH_GUARD;
+        while (i + MIN_MATCH <= limit) {
+            const std::uint32_t sequence = Read32(data + i);
+            const std::uint32_t slot = HashOf(sequence);
+            const std::int32_t candidate = table[slot];
+            table[slot] = static_cast<std::int32_t>(i);
+
+            if (candidate < 0 || i - static_cast<size_t>(candidate) > MAX_OFFSET ||
+                Read32(data + candidate) != sequence) {
+                ++i;
+                continue;
+            }
+
+            size_t length = MIN_MATCH;
+            while (i + length < limit && data[candidate + length] == data[i + length]) ++length;
+
+            EmitSequence(out, data + anchor, i - anchor, i - static_cast<size_t>(candidate), length);
+            i += length;
+            anchor = i;
+            // Seed the table at the end of the match so the next probe
+            // can chain onto it.
+            if (i + MIN_MATCH <= limit) table[HashOf(Read32(data + i - 2))] = static_cast<std::int32_t>(i - 2);
+        }
+    }
+    EmitSequence(out, data + anchor, size - anchor, 0, 0);
+}
+
+bool Decompress(const char *data, size_t size, size_t rawSize, std::string &out) {
+    out.assign(rawSize, '\0');
+    char *const base = rawSize ? &out[0] : nullptr;
+    size_t written = 0;
+
+    const unsigned char *in = reinterpret_cast<const unsigned char *>(data);
+    const unsigned char *const end = in + size;
+
+    while (in < end) {
+        const unsigned char token = *in++;
+
+        size_t literals = token >> 4;
+        if (!GetLength(in, end, literals)) return false;
+        if (literals > static_cast<size_t>(end - in) || literals > rawSize - written) return false;
+        if (literals) std::memcpy(base + written, in, literals);
+        in += literals;
+        written += literals;
+
+        if (in == end) break;                  // final sequence has no match
+
+        if (end - in < 2) return false;
+        const size_t offset = static_cast<size_t>(in[0]) | (static_cast<size_t>(in[1]) << 8);
+        in += 2;
+        size_t length = token & 0x0F;
+        if (!GetLength(in, end, length)) return false;
+        length += MIN_MATCH;
+
+        if (offset == 0 || offset > written || length > rawSize - written) return false;
+        const char *from = base + written - offset;
+        char *to = base + written;
+        if (offset >= length) {
+            std::memcpy(to, from, length);
+        } else {
+            for (size_t k = 0; k < length; ++k) to[k] = from[k];   // overlapping run
+        }
+        written += length;
+    }
+    return written == rawSize;
+}
+
+void AppendFrame(std::string &out, const char *data, size_t size) {
+    std::string packed;
+    packed.reserve(size / 2 + 16);
+    Compress(data, size, packed);
+
+    const bool stored = packed.size() >= size;
+    const size_t payloadSize = stored ? size : packed.size();
+    PutU32(out, static_cast<std::uint32_t>(size));
+    PutU32(out, static_cast<std::uint32_t>(payloadSize) | (stored ? STORED_FLAG : 0));
+    PutU32(out, Fnv1a(data, size));
+    if (stored) {
+        out.append(data, size);
+    } else {
+        out += packed;
+    }
+}
+
+void AppendEndFrame(std::string &out) {
+    PutU32(out, 0);
+    PutU32(out, 0);
+    PutU32(out, 0);
+}
+
+bool HasMagic(const char *data, size_t size) {
+    return size >= MAGIC_SIZE && std::memcmp(data, MAGIC, MAGIC_SIZE) == 0;
+}
+
+bool DecodeFrame(const Frame &frame, std::string &raw, std::string &error) {
+    if (frame.stored) {
+        if (frame.payload.size() != frame.rawSize) {
+            error = "stored block size mismatch";
+            return false;
+        }
+        raw = frame.payload;
+    } else if (!Decompress(frame.payload.data(), frame.payload.size(), frame.rawSize, raw)) {
+        error = "corrupt compressed block";
+        return false;
+    }
+    if (Fnv1a(raw.data(), raw.size()) != frame.checksum) {
+        error = "block checksum mismatch";
+        return false;
+    }
+    return true;
+}
+
+//**********************************************************************
+// DecodeFrames
+//----------------------------------------------------------------------
+// PURPOSE : One task per frame; after a failure the remaining frames
+//           are skipped.
+//**********************************************************************
+bool DecodeFrames(const std::vector<Frame> &frames, std::vector<std::string> &raws,
+                  unsigned threadCount, std::string &error) {
+    raws.assign(frames.size(), std::string());
+    std::atomic<bool> failed(false);
+    std::vector<std::string> errors(frames.size());
+
+    WorkStealing::ParallelFor(frames.size(), threadCount, [&](size_t f) {
+        if (failed.load()) return;
+        if (!DecodeFrame(frames[f], raws[f], errors[f])) failed.store(true);
+    });
+
+    if (!failed.load()) return true;
+    for (size_t f = 0; f < errors.size(); ++f) {
+        if (!errors[f].empty()) {
+            error = errors[f];
+            return false;
+        }
+    }
+    error = "decode failed";
+    return false;
+}
+
+bool FrameReader::Next(Frame &frame) {
+    unsigned char header[FRAME_HEADER_SIZE];
+    if (!in_.read(reinterpret_cast<char *>(header), FRAME_HEADER_SIZE)) {
+        error_ = "file is truncated (no end marker)";
+        return false;
+    }
+    ++index_;
+
+    const std::uint32_t rawSize = GetU32(header);
+    const std::uint32_t storedWord = GetU32(header + 4);
+    if (rawSize == 0 && storedWord == 0) return false;     // end frame
+
+    frame.rawSize = rawSize;
+    frame.stored = (storedWord & STORED_FLAG) != 0;
+    frame.checksum = GetU32(header + 8);
+    const size_t payloadSize = storedWord & ~STORED_FLAG;
+    if (rawSize > MAX_BLOCK_SIZE || payloadSize > MAX_BLOCK_SIZE) {
+        error_ = "block " + std::to_string(index_) + " has an invalid size";
+        return false;
+    }
+
+    frame.payload.resize(payloadSize);
+    if (payloadSize && !in_.read(&frame.payload[0], static_cast<std::streamsize>(payloadSize))) {
+        error_ = "block " + std::to_string(index_) + " is truncated";
+        return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+/****************************************************************
+ * NAMESPACE: BlockCodec
+ * --------------------------------------------------------------
+ * Built-in LZ77 compressor (LZ4-style byte format, no external
+ * dependency) and the block container used for compressed
+ * address book files.
+ *
+ * FILE LAYOUT:
+ *   "ABZ1"                                  4-byte magic
+ *   frame*                                  one per block
+ *   end frame (all header fields zero)
+ *
+ * FRAME:
+ *   | Field      | Size | Meaning                                  |
+ *   |------------|------|------------------------------------------|
+ *   | rawSize    | u32  | bytes after decompression                |
+ *   | storedSize | u32  | payload bytes; top bit = stored raw      |
+ *   | checksum   | u32  | FNV-1a of the raw bytes                  |
+ *   | payload    | ...  | LZ sequences, or raw bytes if incompressible |
+ *
+ * Integers are little-endian. Every block holds whole CSV records
+ * and starts a fresh match window, so blocks can be decompressed
+ * and parsed independently (and therefore in parallel).
+ *
+ * LZ SEQUENCE:
+ *   token (hi nibble = literal count, lo nibble = match length - 4;
+ *   15 means "more length bytes follow", each 255 adds and continues),
+ *   literals, 16-bit back offset, extra match-length bytes. The last
+ *   sequence of a block is literals only.
+ ***************************************************************/
+namespace BlockCodec {
+
+    extern const char MAGIC[4];
+    const size_t MAGIC_SIZE = 4;
+    const size_t FRAME_HEADER_SIZE = 12;
+    const size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+    const size_t MAX_BLOCK_SIZE = 64 * 1024 * 1024;   // sanity bound when reading
+
+    /************************************************************
+     * Frame
+     * ----------------------------------------------------------
+     * PURPOSE : One block as stored on disk (still compressed).
+     ***********************************************************/
+    struct Frame {
+        std::uint32_t rawSize {0};
+        std::uint32_t checksum {0};
+        bool stored {false};         // payload is the raw bytes
+        std::string payload;
+    };
+
+    /************************************************************
+     * Compress / Decompress
+     * ----------------------------------------------------------
+     * PURPOSE : Raw LZ sequences with no framing. Decompress
+     *           validates every length and offset and returns
+     *           false on corrupt input instead of overrunning.
+     ***********************************************************/
+    void Compress(const char *data, size_t size, std::string &out);
+    bool Decompress(const char *data, size_t size, size_t rawSize, std::string &out);
+
+    /************************************************************
+     * AppendFrame / AppendEndFrame
+     * ----------------------------------------------------------
+     * PURPOSE : Encode one block (falls back to stored when LZ
+     *           does not shrink it) / the terminating frame.
+     ***********************************************************/
+    void AppendFrame(std::string &out, const char *data, size_t size);
+    void AppendEndFrame(std::string &out);
+
+    /************************************************************
+     * HasMagic
+     * ----------------------------------------------------------
+     * PURPOSE : Format sniffing: true if the bytes start a
+     *           compressed file.
+     ***********************************************************/
+    bool HasMagic(const char *data, size_t size);
+
+    /************************************************************
+     * DecodeFrame
+     * ----------------------------------------------------------
+     * PURPOSE : Decompress and checksum one frame.
+     * RETURNS : (bool) false with error set on corruption.
+     ***********************************************************/
+    bool DecodeFrame(const Frame &frame, std::string &raw, std::string &error);
+
+    /************************************************************
+     * DecodeFrames
+     * ----------------------------------------------------------
+     * PURPOSE : Decode a batch of frames on up to threadCount
+     *           threads (0 = hardware concurrency). raws[i] is the
+     *           output of frames[i].
+     * RETURNS : (bool) false if any frame failed; error names it.
+     ***********************************************************/
+    bool DecodeFrames(const std::vector<Frame> &frames, std::vector<std::string> &raws,
+                      unsigned threadCount, std::string &error);
+
+    /************************************************************
+     * CLASS: FrameReader
+     * ----------------------------------------------------------
+     * Streams frames from a file positioned just after the magic,
+     * so only the frames currently being decoded are in memory.
+     ***********************************************************/
+    class FrameReader {
+    public:
+        explicit FrameReader(std::istream &in) : in_(in) {}
+
+        /********************************************************
+         * Next
+         * ------------------------------------------------------
+         * RETURNS : true and fills frame; false at the end frame
+         *           or on error (then Error() is non-empty).
+         *******************************************************/
+        bool Next(Frame &frame);
+        const std::string &Error() const { return error_; }
+
+    private:
+        std::istream &in_;
+        std::string error_;
+        size_t index_ {0};
+    };
+}
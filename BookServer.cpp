@@ -0,0 +1,619 @@
+//======================================================================
+// Implementation File: BookServer.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Unix-socket server mode: request parsing, the reader/writer lock
+//   around the book, an epoll event loop and a worker pool.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * Only the loop thread touches sockets. Workers get a request
+//     string and hand back a response string through a completion
+//     queue; an eventfd wakes the loop to send it.
+//   * A connection has at most one request with the workers at a time
+//     and later lines wait in its input buffer, which keeps answers in
+//     request order without sequence numbers.
+//   * The book is fully parsed and indexed before the first request,
+//     so concurrent queries never trigger lazy loading (which would
+//     change the book from inside a const method).
+//======================================================================
+
+#include "BookServer.h"
+#include "CsvCodec.h"
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#define BOOK_SERVER_USE_EPOLL 1
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    const size_t MAX_REQUEST_BYTES = 64 * 1024;   // longer lines are refused
+    const size_t MAX_PENDING_BYTES = 4 * MAX_REQUEST_BYTES;   // unanswered input read ahead per connection
+    const size_t RESULT_LIMIT = 20;               // PREFIX / FUZZY / RANKED answers
+    const int FUZZY_DISTANCE = 2;
+
+    std::string Ok(const std::string &payload) {
+        return "OK " + std::to_string(payload.size()) + "\n" + payload;
+    }
+
+    std::string Error(const std::string &message) {
+        return "ERR " + message + "\n";
+    }
+
+    std::string Records(const std::vector<Contact> &contacts) {
+        std::string payload;
+        for (const auto &contact : contacts) {
+            payload += contact.toCSV();
+            payload += '\n';
+        }
+        return payload;
+    }
+
+    // Removes and returns the first space-separated word of text.
+    std::string NextWord(std::string &text) {
+        size_t start = 0;
+        while (start < text.size() && text[start] == ' ') ++start;
+        size_t end = start;
+        while (end < text.size() && text[end] != ' ') ++end;
+        const std::string word = text.substr(start, end - start);
+        while (end < text.size() && text[end] == ' ') ++end;
+        text.erase(0, end);
+        return word;
+    }
+
+    std::string UpperCase(std::string text) {
+        for (char &ch : text) ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+        return text;
+    }
+
+    bool ParseId(const std::string &word, int &id) {
+        if (word.empty() || word.size() > 9) return false;
+        id = 0;
+        for (char ch : word) {
+            if (ch < '0' || ch > '9') return false;
+            id = id * 10 + (ch - '0');
+        }
+        return true;
+    }
+
+    bool IsMutation(const std::string &verb) {
+        return verb == "ADD" || verb == "EDIT" || verb == "DELETE" || verb == "TAG" ||
+               verb == "GROUP" || verb == "UNDO" || verb == "REDO";
+    }
+
+    //  Fixed set of threads running queued tasks in FIFO order. Stop()
+    //  finishes the queued tasks before joining.
+    class WorkerPool {
+    public:
+        explicit WorkerPool(size_t threads) {
+            for (size_t t = 0; t < threads; ++t) threads_.emplace_back(&WorkerPool::Run, this);
+        }
+        ~WorkerPool() { Stop(); }
+
+        void Submit(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                tasks_.push_back(std::move(task));
+            }
+            wake_.notify_one();
+        }
+
+        void Stop() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            for (auto &thread : threads_) {
+                if (thread.joinable()) thread.join();
+            }
+        }
+
+    private:
+        void Run() {
+            for (;;) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    wake_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+                    if (tasks_.empty()) return;
+                    task = std::move(tasks_.front());
+                    tasks_.pop_front();
+                }
+                task();
+            }
+        }
+
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::deque<std::function<void()>> tasks_;
+        bool stopping_ {false};
+        std::vector<std::thread> threads_;
+    };
+}
+
+BookServer::BookServer(AddressBook &book, const std::string &socketPath, size_t workers)
+    : book_(book), socketPath_(socketPath),
+      workers_(workers ? workers : std::max(1u, std::thread::hardware_concurrency())) {}
+
+std::string BookServer::Execute(const std::string &request) {
+    std::string arguments = request;
+    if (!arguments.empty() && arguments.back() == '\r') arguments.pop_back();
+    const std::string verb = UpperCase(NextWord(arguments));
+
+    if (IsMutation(verb)) {
+        std::unique_lock<std::shared_timed_mutex> lock(bookMutex_);
+        return ExecuteMutation(verb, arguments);
+    }
+    std::shared_lock<std::shared_timed_mutex> lock(bookMutex_);
+    return ExecuteQuery(verb, arguments);
+}
+
+std::string BookServer::ExecuteQuery(const std::string &verb, std::string &arguments) const {
+    if (verb == "PING") return Ok("");
+    if (verb == "COUNT") return Ok(std::to_string(book_.Snapshot().size()) + "\n");
+    if (verb == "LIST") {
+        std::string payload;
+        for (const auto &stored : book_.Snapshot()) {
+            payload += stored->toCSV();
+            payload += '\n';
+        }
+        return Ok(payload);
+    }
+
+    if (verb == "PAGE") {
+        const std::string by = UpperCase(NextWord(arguments));
+        AddressBook::SortKey order;
+        if (by == "LAST") order.field = AddressBook::SortField::LastName;
+        else if (by == "FIRST") order.field = AddressBook::SortField::FirstName;
+        else if (by == "CITY") order.field = AddressBook::SortField::City;
+        else if (by == "TYPE") order.field = AddressBook::SortField::Type;
+        else if (by == "ID") order.field = AddressBook::SortField::Id;
+        else return Error("unknown sort '" + by + "'");
+        std::string word = NextWord(arguments);
+        if (UpperCase(word) == "DESC") {
+            order.descending = true;
+            word = NextWord(arguments);
+        }
+        int offset = 0;
+        int count = 0;
+        if (!ParseId(word, offset) || !ParseId(NextWord(arguments), count)) {
+            return Error("expected <offset> <count>");
+        }
+        return Ok(Records(book_.ListSorted(order, static_cast<size_t>(offset), static_cast<size_t>(count))));
+    }
+
+    if (verb == "GET" || verb == "VIEW") {
+        int id = 0;
+        std::string text;
+        if (!ParseId(NextWord(arguments), id)) return Error("expected a contact id");
+        const RenderCache::Format format = (verb == "GET") ? RenderCache::Format::Csv : RenderCache::Format::Detail;
+        if (!book_.RenderContact(id, format, text)) return Error("no contact " + std::to_string(id));
+        if (text.empty() || text.back() != '\n') text += '\n';
+        return Ok(text);
+    }
+
+    if (verb == "SEARCH") {
+        const std::string how = UpperCase(NextWord(arguments));
+        if (arguments.empty()) return Error("expected a query");
+        if (how == "NAME") return Ok(Records(book_.SearchByName(arguments)));
+        if (how == "EMAIL") return Ok(Records(book_.SearchByEmail(arguments)));
+        if (how == "PHONE") return Ok(Records(book_.SearchByPhone(arguments)));
+        if (how == "DOMAIN") return Ok(Records(book_.SearchByEmailDomain(arguments, true)));
+        if (how == "LOCAL") return Ok(Records(book_.SearchByEmailLocalPart(arguments)));
+        if (how == "SOUNDS") return Ok(Records(book_.SearchBySoundsLike(arguments)));
+        if (how == "PREFIX") return Ok(Records(book_.SuggestByPrefix(arguments, RESULT_LIMIT)));
+        if (how == "FUZZY") return Ok(Records(book_.SearchByNameFuzzy(arguments, FUZZY_DISTANCE, RESULT_LIMIT)));
+        if (how == "TEXT") return Ok(Records(book_.SearchText(arguments)));
+        if (how == "RANKED") {
+            // One thread: the worker pool already runs queries side by side.
+            std::vector<Contact> ranked;
+            for (auto &match : book_.SearchRanked(arguments, RESULT_LIMIT, Relevance::DefaultScore, 1)) {
+                ranked.push_back(std::move(match.contact));
+            }
+            return Ok(Records(ranked));
+        }
+        return Error("unknown search '" + how + "'");
+    }
+
+    if (verb == "FILTER") {
+        const std::string how = UpperCase(NextWord(arguments));
+        if (how == "TYPE") return Ok(Records(book_.FilterByType(arguments)));
+        if (how == "CITY") return Ok(Records(book_.FilterByCity(arguments)));
+        if (how == "STATE") return Ok(Records(book_.FilterByState(arguments)));
+        if (how == "TAG") return Ok(Records(book_.FilterByTag(arguments)));
+        if (how == "ZIP") {
+            int low = 0;
+            int high = 0;
+            const size_t dash = arguments.find('-');
+            if (!ParseId(arguments.substr(0, dash), low) ||
+                !ParseId(dash == std::string::npos ? arguments : arguments.substr(dash + 1), high)) {
+                return Error("expected <low>-<high>");
+            }
+            return Ok(Records(book_.FilterByPostalRange(low, high)));
+        }
+        return Error("unknown filter '" + how + "'");
+    }
+
+    if (verb == "REPORT") {
+        const std::string which = UpperCase(NextWord(arguments));
+        std::ostringstream out;
+        if (which == "MISSING") book_.ReportMissingInfo(out);
+        else if (which == "TYPES") book_.ReportCountsByType(out);
+        else if (which == "GROUPS") book_.ReportGroupSummary(out);
+        else if (which == "DOMAINS") book_.ReportEmailDomains(out);
+        else if (which == "CACHE") book_.ReportCacheStats(out);
+        else return Error("unknown report '" + which + "'");
+        return Ok(out.str());
+    }
+
+    if (verb == "SAVE") {
+        // Only the mutations this save covers are cleared; any made while
+        // it writes still count toward the shutdown save.
+        const size_t covered = mutations_.load();
+        const bool started = book_.SaveToFileAsync(false, [this, covered](bool succeeded) {
+            if (succeeded) mutations_ -= covered;
+        });
+        if (!started) return Error("a save is already running");
+        return Ok("");
+    }
+    return Error(verb.empty() ? "empty request" : "unknown request '" + verb + "'");
+}
+
+std::string BookServer::ExecuteMutation(const std::string &verb, std::string &arguments) {
+    int id = 0;
+    if (verb == "ADD") {
+        if (arguments.empty()) return Error("expected contact fields");
+        const Contact contact = AddressBook::ContactFromFields(Csv::SplitRecord(arguments));
+        book_.AddContact(contact);
+        ++mutations_;
+        return Ok(std::to_string(contact.getId()) + "\n");
+    }
+
+    if (verb == "UNDO" || verb == "REDO") {
+        std::string label;
+        if (!(verb == "UNDO" ? book_.Undo(label) : book_.Redo(label))) {
+            return Error(verb == "UNDO" ? "nothing to undo" : "nothing to redo");
+        }
+        ++mutations_;
+        return Ok(label + "\n");
+    }
+
+    // The remaining requests name a contact: [ADD|REMOVE] <id> <value>
+    std::string action;
+    if (verb == "TAG" || verb == "GROUP") {
+        action = UpperCase(NextWord(arguments));
+        if (action != "ADD" && action != "REMOVE") return Error("expected ADD or REMOVE");
+    }
+    if (!ParseId(NextWord(arguments), id)) return Error("expected a contact id");
+
+    bool done = false;
+    if (verb == "EDIT") {
+        done = book_.EditContact(id, AddressBook::ContactFromFields(Csv::SplitRecord(arguments)));
+    } else if (verb == "DELETE") {
+        done = book_.DeleteContact(id);
+    } else if (arguments.empty()) {
+        return Error(verb == "TAG" ? "expected a tag" : "expected a group");
+    } else if (verb == "TAG") {
+        done = (action == "ADD") ? book_.AddTag(id, arguments) : book_.RemoveTag(id, arguments);
+    } else {
+        done = (action == "ADD") ? book_.AssignToGroup(id, arguments) : book_.RemoveFromGroup(id, arguments);
+    }
+    if (!done) {
+        std::string problem = "no contact " + std::to_string(id);
+        if (verb == "TAG" || verb == "GROUP") {
+            problem += (action == "ADD") ? ", or it already has that " : ", or it has no such ";
+            problem += (verb == "TAG") ? "tag" : "group";
+        }
+        return Error(problem);
+    }
+    ++mutations_;
+    return Ok("");
+}
+
+#if defined(BOOK_SERVER_USE_EPOLL)
+
+namespace {
+
+    // epoll user data: fixed ids for the three internal descriptors,
+    // connections are numbered from FIRST_CONNECTION up.
+    const std::uint64_t LISTEN_ID = 0;
+    const std::uint64_t WAKE_ID = 1;
+    const std::uint64_t SIGNAL_ID = 2;
+    const std::uint64_t FIRST_CONNECTION = 3;
+    const int MAX_EVENTS = 64;
+    const int LISTEN_BACKLOG = 64;
+
+    struct Connection {
+        int fd;
+        std::string in;          // received, not yet answered
+        std::string out;         // answered, not yet sent
+        bool busy {false};       // a request is with the workers
+        bool eof {false};        // peer finished sending
+        bool quit {false};       // QUIT received or protocol error
+        std::uint32_t events {EPOLLIN | EPOLLRDHUP};   // as registered with epoll
+    };
+
+    // Worker -> loop hand-off.
+    struct Completions {
+        std::mutex mutex;
+        std::vector<std::pair<std::uint64_t, std::string>> ready;
+        int wakeFd;
+    };
+
+    void Watch(int epollFd, int op, int fd, std::uint64_t id, std::uint32_t events) {
+        epoll_event event {};
+        event.events = events;
+        event.data.u64 = id;
+        epoll_ctl(epollFd, op, fd, &event);
+    }
+
+    // A pipelining client is read ahead of the answers only up to
+    // MAX_PENDING_BYTES; past that the connection stops reading until
+    // its queued requests have been answered.
+    bool InputFull(const Connection &conn) {
+        return conn.in.size() >= MAX_PENDING_BYTES;
+    }
+
+    // Sends as much of conn.out as the socket takes and re-registers
+    // the connection for what it now waits on; false on a dead peer.
+    bool Flush(int epollFd, std::uint64_t id, Connection &conn) {
+        while (!conn.out.empty()) {
+            const ssize_t sent = send(conn.fd, conn.out.data(), conn.out.size(), MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                return false;
+            }
+            conn.out.erase(0, static_cast<size_t>(sent));
+        }
+        // Once the peer has finished sending, only wait for writability
+        // (a half-closed socket would otherwise report EPOLLRDHUP forever);
+        // with a full input buffer, not for input either.
+        std::uint32_t wanted = conn.eof || InputFull(conn) ? 0 : EPOLLIN | EPOLLRDHUP;
+        if (!conn.out.empty()) wanted |= EPOLLOUT;
+        if (wanted != conn.events) {
+            conn.events = wanted;
+            Watch(epollFd, EPOLL_CTL_MOD, conn.fd, id, wanted);
+        }
+        return true;
+    }
+
+    bool OpenListener(const std::string &path, int &listenFd) {
+        sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            std::cout << "Error: socket path is too long.\n";
+            return false;
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0) {
+            std::cout << "Error: could not create socket (" << std::strerror(errno) << ").\n";
+            return false;
+        }
+        // A leftover socket file from a server that died is replaced;
+        // one that still accepts connections belongs to a live server.
+        const int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const bool live = probe >= 0 &&
+                          connect(probe, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0;
+        if (probe >= 0) close(probe);
+        if (live) {
+            std::cout << "Error: another server is already listening on " << path << ".\n";
+            return false;
+        }
+        unlink(path.c_str());
+
+        if (bind(listenFd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 ||
+            listen(listenFd, LISTEN_BACKLOG) != 0) {
+            std::cout << "Error: could not listen on " << path << " (" << std::strerror(errno) << ").\n";
+            return false;
+        }
+        return true;
+    }
+}
+
+/*
+==================== Run() ============
+PURPOSE:
+Event loop: accepts clients, splits their input into request lines,
+hands each line to the worker pool and sends back the answers.
+
+NOTES:
+- SIGINT / SIGTERM are blocked on every thread and read from a
+  signalfd, so shutdown happens on the loop thread between events.
+- On shutdown, requests already with the workers are finished, the
+  book is saved if any request changed it, and the socket is removed.
+- A connection is read at most MAX_PENDING_BYTES ahead of its answers;
+  EPOLLIN is dropped from its registration until the backlog drains.
+=====================================================
+*/
+int BookServer::Run() {
+    book_.EnsureIndexed();
+
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);   // before any worker starts
+
+    int listenFd = -1;
+    if (!OpenListener(socketPath_, listenFd)) {
+        if (listenFd >= 0) close(listenFd);
+        return 1;
+    }
+    const int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    const int signalFd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    Completions completions;
+    completions.wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    Watch(epollFd, EPOLL_CTL_ADD, listenFd, LISTEN_ID, EPOLLIN);
+    Watch(epollFd, EPOLL_CTL_ADD, completions.wakeFd, WAKE_ID, EPOLLIN);
+    Watch(epollFd, EPOLL_CTL_ADD, signalFd, SIGNAL_ID, EPOLLIN);
+
+    std::unordered_map<std::uint64_t, Connection> connections;
+    std::uint64_t nextId = FIRST_CONNECTION;
+    WorkerPool pool(workers_);
+
+    // Starts the next complete request of an idle connection.
+    auto dispatch = [&](std::uint64_t id, Connection &conn) {
+        while (!conn.busy && !conn.quit) {
+            const size_t newline = conn.in.find('\n');
+            if (newline == std::string::npos) {
+                if (conn.in.size() > MAX_REQUEST_BYTES) {
+                    conn.out += Error("request too long");
+                    conn.quit = true;
+                }
+                return;
+            }
+            std::string request = conn.in.substr(0, newline);
+            conn.in.erase(0, newline + 1);
+            if (!request.empty() && request.back() == '\r') request.pop_back();
+            if (request.empty()) continue;
+            if (UpperCase(request) == "QUIT") {
+                conn.out += Ok("");
+                conn.quit = true;
+                return;
+            }
+            conn.busy = true;
+            pool.Submit([this, id, request, &completions]() {
+                std::string response = Execute(request);
+                {
+                    std::lock_guard<std::mutex> lock(completions.mutex);
+                    completions.ready.emplace_back(id, std::move(response));
+                }
+                const std::uint64_t one = 1;
+                if (write(completions.wakeFd, &one, sizeof(one)) < 0) {
+                    // the counter is already non-zero; the loop will wake
+                }
+            });
+        }
+    };
+
+    // Sends what it can, then closes the connection once it is done.
+    auto settle = [&](std::uint64_t id) {
+        auto found = connections.find(id);
+        if (found == connections.end()) return;
+        Connection &conn = found->second;
+        bool alive = Flush(epollFd, id, conn);
+        const bool finished = conn.quit || (conn.eof && conn.in.find('\n') == std::string::npos);
+        if (alive && !(finished && !conn.busy && conn.out.empty())) return;
+        if (conn.busy) {
+            conn.quit = true;              // close once the worker answers
+            return;
+        }
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, conn.fd, nullptr);
+        close(conn.fd);
+        connections.erase(found);
+    };
+
+    std::cout << "Serving " << socketPath_ << " with " << workers_
+              << " worker threads (Ctrl+C to stop).\n" << std::flush;
+
+    epoll_event events[MAX_EVENTS];
+    bool stopping = false;
+    while (!stopping) {
+        const int count = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int e = 0; e < count; ++e) {
+            const std::uint64_t id = events[e].data.u64;
+
+            if (id == SIGNAL_ID) {
+                stopping = true;
+            } else if (id == LISTEN_ID) {
+                for (;;) {
+                    const int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (fd < 0) break;
+                    Connection conn;
+                    conn.fd = fd;
+                    connections.emplace(nextId, std::move(conn));
+                    Watch(epollFd, EPOLL_CTL_ADD, fd, nextId, EPOLLIN | EPOLLRDHUP);
+                    ++nextId;
+                }
+            } else if (id == WAKE_ID) {
+                std::uint64_t counter;
+                while (read(completions.wakeFd, &counter, sizeof(counter)) > 0) {}
+                std::vector<std::pair<std::uint64_t, std::string>> ready;
+                {
+                    std::lock_guard<std::mutex> lock(completions.mutex);
+                    ready.swap(completions.ready);
+                }
+                for (auto &answer : ready) {
+                    auto found = connections.find(answer.first);
+                    if (found == connections.end()) continue;
+                    found->second.busy = false;
+                    found->second.out += answer.second;
+                    dispatch(answer.first, found->second);
+                    settle(answer.first);
+                }
+            } else {
+                auto found = connections.find(id);
+                if (found == connections.end()) continue;
+                Connection &conn = found->second;
+                if (events[e].events & EPOLLIN) {
+                    char buffer[16 * 1024];
+                    while (!InputFull(conn)) {
+                        const ssize_t received = recv(conn.fd, buffer, sizeof(buffer), 0);
+                        if (received > 0) {
+                            conn.in.append(buffer, static_cast<size_t>(received));
+                            continue;
+                        }
+                        if (received == 0) conn.eof = true;
+                        else if (errno == EINTR) continue;
+                        else if (errno != EAGAIN && errno != EWOULDBLOCK) conn.quit = true;
+                        break;
+                    }
+                    dispatch(id, conn);
+                }
+                if (events[e].events & (EPOLLERR | EPOLLHUP)) conn.quit = true;
+                settle(id);
+            }
+        }
+    }
+
+    std::cout << "\nStopping server...\n";
+    pool.Stop();
+    for (auto &entry : connections) close(entry.second.fd);
+    close(listenFd);
+    close(signalFd);
+    close(completions.wakeFd);
+    close(epollFd);
+    unlink(socketPath_.c_str());
+    book_.WaitForSave();
+    if (mutations_.load() > 0) {
+        book_.SaveToFile();
+    }
+    return 0;
+}
+
+#else
+
+int BookServer::Run() {
+    std::cout << "Error: server mode needs Linux (epoll and Unix domain sockets).\n";
+    return 1;
+}
+
+#endif
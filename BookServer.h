@@ -0,0 +1,98 @@
+#pragma once
+
+#include "AddressBook.h"
+#include <atomic>
+#include <cstddef>
+#include <shared_mutex>
+#include <string>
+
+/****************************************************************
+ * CLASS: BookServer
+ * --------------------------------------------------------------
+ * Serves one resident AddressBook to local tools over a Unix
+ * domain socket, so they share the warm indexes instead of each
+ * reloading the CSV. Started with --serve=PATH; runs until
+ * SIGINT / SIGTERM.
+ *
+ * Line protocol: one request per line, answered by either
+ *
+ *   OK <bytes>\n      followed by exactly <bytes> bytes of payload
+ *                     (zero or more newline-terminated lines), or
+ *   ERR <message>\n
+ *
+ *   | Request                                   | Payload         |
+ *   |-------------------------------------------|-----------------|
+ *   | PING / QUIT                               | none            |
+ *   | COUNT                                     | contact count   |
+ *   | LIST                                      | CSV records     |
+ *   | PAGE <by> [DESC] <offset> <count>         | CSV records     |
+ *   |   by: LAST FIRST CITY TYPE ID (sorted, maintained order)    |
+ *   | GET <id>                                  | CSV record      |
+ *   | VIEW <id>                                 | detail text     |
+ *   | SEARCH <how> <query>                      | CSV records     |
+ *   |   how: NAME EMAIL PHONE DOMAIN LOCAL SOUNDS PREFIX FUZZY    |
+ *   |        RANKED (best 20 by relevance, best first)            |
+ *   |        TEXT (words in name/address/notes, "phrases" too)    |
+ *   |        PHONE *1234 matches numbers ending in 1234           |
+ *   | FILTER TYPE|CITY|STATE|TAG <value>        | CSV records     |
+ *   | FILTER ZIP <low>-<high>                   | CSV records     |
+ *   | REPORT MISSING|TYPES|GROUPS|DOMAINS|CACHE | report text     |
+ *   | ADD <type,first,last,...,groups,tags>     | new id          |
+ *   | EDIT <id> <type,first,last,...,notes>     | none            |
+ *   | DELETE <id>                               | none            |
+ *   | TAG ADD|REMOVE <id> <tag>                 | none            |
+ *   | GROUP ADD|REMOVE <id> <group>             | none            |
+ *   | UNDO / REDO                               | revision label  |
+ *   | SAVE                                      | none            |
+ *
+ * Records are CSV in the file's column order (id first); ADD and
+ * EDIT take the columns after the id. A byte count rather than a
+ * line count is sent because quoted notes may span lines. Clients
+ * may pipeline requests; answers come back in request order.
+ *
+ * One epoll thread does all socket I/O; complete request lines go
+ * to a pool of worker threads. Queries run concurrently under a
+ * shared lock, mutations one at a time under the exclusive lock,
+ * so every query sees a whole number of mutations.
+ ***************************************************************/
+class BookServer {
+public:
+    /************************************************************
+     * BookServer
+     * ----------------------------------------------------------
+     * PARAMS  : book        (IN) - loaded book to serve
+     *           socketPath  (IN) - filesystem path of the socket
+     *           workers     (IN) - query threads (0 = one per core)
+     ***********************************************************/
+    BookServer(AddressBook &book, const std::string &socketPath, size_t workers);
+
+    /************************************************************
+     * Run
+     * ----------------------------------------------------------
+     * PURPOSE : Serve until SIGINT / SIGTERM, then save the book
+     *           if it was changed and remove the socket.
+     * RETURNS : (int) Process exit code (1 if the socket could not
+     *           be set up or the platform has no epoll).
+     ***********************************************************/
+    int Run();
+
+    /************************************************************
+     * Execute
+     * ----------------------------------------------------------
+     * PURPOSE : Answer one request line (without its newline),
+     *           taking the shared or exclusive lock as needed.
+     *           Thread-safe; used by the workers.
+     * RETURNS : (std::string) The full response, newline-ended.
+     ***********************************************************/
+    std::string Execute(const std::string &request);
+
+private:
+    std::string ExecuteQuery(const std::string &verb, std::string &arguments) const;
+    std::string ExecuteMutation(const std::string &verb, std::string &arguments);
+
+    AddressBook &book_;
+    const std::string socketPath_;
+    const size_t workers_;
+    mutable std::shared_timed_mutex bookMutex_;   // shared: queries; exclusive: mutations
+    mutable std::atomic<size_t> mutations_ {0};   // unsaved edits; SAVE clears, shutdown saves if non-zero
+};
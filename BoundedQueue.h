@@ -0,0 +1,80 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/****************************************************************
+ * CLASS TEMPLATE: BoundedQueue<T>
+ * --------------------------------------------------------------
+ * Blocking FIFO with a fixed capacity, used between the stages
+ * of the load and save pipelines. A full queue makes Push wait,
+ * so a fast stage is held back by the slower one behind it and
+ * memory stays bounded by capacity x item size, not file size.
+ *
+ * Close() ends the stream: later Pushes fail, and Pop returns the
+ * items already queued and then false. Either side may close it,
+ * so a consumer that gives up (an error) also releases a producer
+ * blocked in Push.
+ ***************************************************************/
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity ? capacity : 1) {}
+
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+    /************************************************************
+     * Push
+     * ----------------------------------------------------------
+     * PURPOSE : Append item, waiting while the queue is full.
+     * RETURNS : (bool) false if the queue was closed (the item is
+     *           dropped).
+     ***********************************************************/
+    bool Push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this]() { return closed_ || items_.size() < capacity_; });
+        if (closed_) return false;
+        items_.push_back(std::move(item));
+        lock.unlock();
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    /************************************************************
+     * Pop
+     * ----------------------------------------------------------
+     * PURPOSE : Take the oldest item, waiting while none is queued.
+     * RETURNS : (bool) false once the queue is closed and empty.
+     ***********************************************************/
+    bool Pop(T &item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this]() { return closed_ || !items_.empty(); });
+        if (items_.empty()) return false;
+        item = std::move(items_.front());
+        items_.pop_front();
+        lock.unlock();
+        notFull_.notify_one();
+        return true;
+    }
+
+    void Close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        notFull_.notify_all();
+        notEmpty_.notify_all();
+    }
+
+private:
+    const size_t capacity_;
+    std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+    std::deque<T> items_;
+    bool closed_ {false};
+};
@@ -0,0 +1,310 @@
+//======================================================================
+// Implementation File: ChangeFeed.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Contact diffs -> typed change events, a single-producer ring of
+//   the newest events, and the NDJSON encoding.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * Publishing stores the event in its slot first and then advances
+//     head_ with release order, so a reader that sees the new head
+//     also sees the slot. A reader checks each event's own sequence:
+//     if the producer lapped it while it was reading, the slot holds
+//     a newer event and the old one is counted as missed.
+//   * Slots hold immutable shared events, so a reader copies a pointer
+//     and never a string that the producer could be rewriting. The
+//     slot mutex covers only those pointer copies: events are built
+//     before it is taken and the overwritten one is freed after.
+//======================================================================
+
+#include "ChangeFeed.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+    std::string JoinLabels(const std::vector<std::string> &labels) {
+        std::string joined;
+        for (const auto &label : labels) {
+            if (!joined.empty()) joined += '|';
+            joined += label;
+        }
+        return joined;
+    }
+
+    // Contact fields in CSV column order, as named in the events. Edits
+    // report tag / group changes as their own events, so the label
+    // columns are only included for whole-contact events.
+    struct Field {
+        const char *name;
+        std::string value;
+    };
+
+    std::vector<Field> FieldsOf(const Contact &contact, bool withLabels) {
+        std::vector<Field> fields {
+            { "type", Contact::contactTypeToString(contact.getType()) },
+            { "first_name", contact.getFirstName() },
+            { "last_name", contact.getLastName() },
+            { "email", contact.getEmail() },
+            { "phone", contact.getPhone() },
+            { "address", contact.getAddressLine() },
+            { "city", contact.getCity() },
+            { "state", contact.getState() },
+            { "postal_code", contact.getPostalCode() },
+            { "notes", contact.getNotes() },
+        };
+        if (withLabels) {
+            fields.push_back(Field{ "groups", JoinLabels(contact.getGroups()) });
+            fields.push_back(Field{ "tags", JoinLabels(contact.getTags()) });
+        }
+        return fields;
+    }
+
+    // Labels in `from` that are not in `to`, in their stored order.
+    std::vector<std::string> Missing(const std::vector<std::string> &from, const std::vector<std::string> &to) {
+        std::vector<std::string> missing;
+        for (const auto &label : from) {
+            if (std::find(to.begin(), to.end(), label) == to.end()) missing.push_back(label);
+        }
+        return missing;
+    }
+
+    void AppendJsonString(std::string &out, const std::string &text) {
+        out += '"';
+        for (char ch : text) {
+            switch (ch) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(ch));
+                    out += escaped;
+                } else {
+                    out += ch;                 // UTF-8 passes through unchanged
+                }
+            }
+        }
+        out += '"';
+    }
+
+    size_t RoundUpToPowerOfTwo(size_t value) {
+        size_t power = 1;
+        while (power < value) power <<= 1;
+        return power;
+    }
+}
+
+ChangeFeed::ChangeFeed(size_t capacity)
+    : slots_(RoundUpToPowerOfTwo(std::max<size_t>(capacity, 2))), mask_(slots_.size() - 1) {}
+
+void ChangeFeed::PublishChange(const ContactPtr &before, const ContactPtr &after) {
+    const Contact &subject = after ? *after : *before;
+    Event event;
+    event.contactId = subject.getId();
+    event.name = subject.getFullName();
+
+    if (!before || !after) {
+        event.kind = after ? Kind::Added : Kind::Deleted;
+        for (auto &field : FieldsOf(subject, true)) {
+            if (field.value.empty()) continue;
+            FieldChange change {field.name, std::string(), std::string()};
+            (after ? change.after : change.before) = std::move(field.value);
+            event.fields.push_back(std::move(change));
+        }
+        Publish(std::move(event));
+        return;
+    }
+
+    const std::vector<Field> old = FieldsOf(*before, false);
+    const std::vector<Field> now = FieldsOf(*after, false);
+    for (size_t f = 0; f < old.size(); ++f) {
+        if (old[f].value != now[f].value) {
+            event.fields.push_back(FieldChange{old[f].name, old[f].value, now[f].value});
+        }
+    }
+    if (!event.fields.empty()) {
+        event.kind = Kind::Edited;
+        Publish(event);
+        event.fields.clear();
+    }
+
+    const struct {
+        std::vector<std::string> before;
+        std::vector<std::string> after;
+        Kind added;
+        Kind removed;
+    } sets[] = {
+        { before->getTags(), after->getTags(), Kind::TagAdded, Kind::TagRemoved },
+        { before->getGroups(), after->getGroups(), Kind::GroupAdded, Kind::GroupRemoved },
+    };
+    for (const auto &set : sets) {
+        for (const auto &label : Missing(set.before, set.after)) {
+            event.kind = set.removed;
+            event.label = label;
+            Publish(event);
+        }
+        for (const auto &label : Missing(set.after, set.before)) {
+            event.kind = set.added;
+            event.label = label;
+            Publish(event);
+        }
+    }
+}
+
+void ChangeFeed::PublishRename(bool group, const std::string &from, const std::string &to) {
+    Event event;
+    event.kind = group ? Kind::GroupRenamed : Kind::TagRenamed;
+    event.contactId = 0;
+    event.label = from;
+    event.newLabel = to;
+    Publish(std::move(event));
+}
+
+void ChangeFeed::Publish(Event event) {
+    const std::uint64_t sequence = head_.load(std::memory_order_relaxed);
+    event.sequence = sequence;
+    EventPtr stored = std::make_shared<const Event>(std::move(event));
+    const Event &published = *stored;           // kept alive by its slot: only this thread overwrites slots
+    {
+        std::lock_guard<std::mutex> lock(slotsMutex_);
+        slots_[sequence & mask_].swap(stored);   // stored now holds the overwritten event
+    }
+    head_.store(sequence + 1, std::memory_order_release);
+    stored.reset();
+
+    std::vector<Callback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(subscribersMutex_);
+        for (const auto &subscriber : subscribers_) callbacks.push_back(subscriber.second);
+    }
+    for (const auto &callback : callbacks) callback(published);
+}
+
+size_t ChangeFeed::Poll(Cursor &cursor, std::vector<EventPtr> &out, size_t maxEvents) const {
+    const std::uint64_t head = head_.load(std::memory_order_acquire);
+    if (head - cursor.next > slots_.size()) {
+        cursor.missed += head - slots_.size() - cursor.next;
+        cursor.next = head - slots_.size();
+    }
+    if (cursor.next == head || maxEvents == 0) return 0;
+
+    size_t appended = 0;
+    std::lock_guard<std::mutex> lock(slotsMutex_);
+    for (; cursor.next < head && appended < maxEvents; ++cursor.next) {
+        const EventPtr &event = slots_[cursor.next & mask_];
+        if (!event || event->sequence != cursor.next) {
+            ++cursor.missed;                   // lapped since head was read
+            continue;
+        }
+        out.push_back(event);
+        ++appended;
+    }
+    return appended;
+}
+
+ChangeFeed::Cursor ChangeFeed::OpenCursor() const {
+    Cursor cursor;
+    cursor.next = Published();
+    return cursor;
+}
+
+int ChangeFeed::Subscribe(Callback callback) {
+    std::lock_guard<std::mutex> lock(subscribersMutex_);
+    subscribers_.emplace_back(nextHandle_, std::move(callback));
+    return nextHandle_++;
+}
+
+void ChangeFeed::Unsubscribe(int handle) {
+    std::lock_guard<std::mutex> lock(subscribersMutex_);
+    subscribers_.erase(std::remove_if(subscribers_.begin(), subscribers_.end(),
+                                      [handle](const std::pair<int, Callback> &subscriber) {
+                                          return subscriber.first == handle;
+                                      }),
+                       subscribers_.end());
+}
+
+const char *ChangeFeed::KindName(Kind kind) {
+    switch (kind) {
+    case Kind::Added: return "added";
+    case Kind::Edited: return "edited";
+    case Kind::Deleted: return "deleted";
+    case Kind::TagAdded: return "tag_added";
+    case Kind::TagRemoved: return "tag_removed";
+    case Kind::GroupAdded: return "group_added";
+    case Kind::GroupRemoved: return "group_removed";
+    case Kind::TagRenamed: return "tag_renamed";
+    case Kind::GroupRenamed: return "group_renamed";
+    }
+    return "unknown";
+}
+
+//**********************************************************************
+// ToJson
+//----------------------------------------------------------------------
+// PURPOSE : {"seq":7,"event":"edited","id":12,"name":"Ann Lee",
+//            "changes":{"email":{"old":"a@x.com","new":"ann@x.com"}}}
+//           Added / deleted events carry "contact":{field:value}; tag
+//           and group events carry "tag" or "group". Renames name no
+//           contact: {"seq":9,"event":"tag_renamed","old":"vip","new":"gold"}
+//**********************************************************************
+std::string ChangeFeed::ToJson(const Event &event) {
+    if (event.kind == Kind::TagRenamed || event.kind == Kind::GroupRenamed) {
+        std::string json = "{\"seq\":" + std::to_string(event.sequence) + ",\"event\":\"" +
+                           KindName(event.kind) + "\",\"old\":";
+        AppendJsonString(json, event.label);
+        json += ",\"new\":";
+        AppendJsonString(json, event.newLabel);
+        json += '}';
+        return json;
+    }
+    std::string json = "{\"seq\":" + std::to_string(event.sequence) + ",\"event\":\"" +
+                       KindName(event.kind) + "\",\"id\":" + std::to_string(event.contactId) +
+                       ",\"name\":";
+    AppendJsonString(json, event.name);
+
+    switch (event.kind) {
+    case Kind::Added:
+    case Kind::Deleted:
+        json += ",\"contact\":{";
+        for (size_t f = 0; f < event.fields.size(); ++f) {
+            if (f) json += ',';
+            AppendJsonString(json, event.fields[f].field);
+            json += ':';
+            AppendJsonString(json, event.kind == Kind::Added ? event.fields[f].after : event.fields[f].before);
+        }
+        json += '}';
+        break;
+    case Kind::Edited:
+        json += ",\"changes\":{";
+        for (size_t f = 0; f < event.fields.size(); ++f) {
+            if (f) json += ',';
+            AppendJsonString(json, event.fields[f].field);
+            json += ":{\"old\":";
+            AppendJsonString(json, event.fields[f].before);
+            json += ",\"new\":";
+            AppendJsonString(json, event.fields[f].after);
+            json += '}';
+        }
+        json += '}';
+        break;
+    case Kind::TagAdded:
+    case Kind::TagRemoved:
+        json += ",\"tag\":";
+        AppendJsonString(json, event.label);
+        break;
+    case Kind::GroupAdded:
+    case Kind::GroupRemoved:
+        json += ",\"group\":";
+        AppendJsonString(json, event.label);
+        break;
+    case Kind::TagRenamed:
+    case Kind::GroupRenamed:
+        break;
+    }
+    json += '}';
+    return json;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Contact.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/****************************************************************
+ * CLASS: ChangeFeed
+ * --------------------------------------------------------------
+ * Change-data-capture stream of the address book: every stored
+ * change becomes one or more typed events
+ *
+ *   | Kind                      | Carries                         |
+ *   |---------------------------|---------------------------------|
+ *   | Added / Deleted           | every non-empty field           |
+ *   | Edited                    | field name, old and new value   |
+ *   | TagAdded / TagRemoved     | the tag                         |
+ *   | GroupAdded / GroupRemoved | the group                       |
+ *   | TagRenamed / GroupRenamed | old and new name (no contact)   |
+ *
+ * numbered by a sequence that never repeats. Events are kept in a
+ * fixed ring of the newest `capacity`; consumers either register a
+ * callback (run on the publishing thread, right after the event is
+ * visible) or Poll() with their own Cursor from any thread.
+ *
+ * There is one producer (the thread that edits the book). Each
+ * event is built and allocated as an immutable shared event before
+ * the ring is touched; the slots are guarded by one mutex that is
+ * held only to swap a pointer in (producer) or copy pointers out
+ * (Poll, at most maxEvents of them). So the producer waits at most
+ * for a few reference-count updates, never for a slow consumer,
+ * and a consumer that falls a whole ring behind is told how many
+ * events it missed instead of holding the producer back.
+ ***************************************************************/
+class ChangeFeed {
+public:
+    enum class Kind { Added, Edited, Deleted, TagAdded, TagRemoved, GroupAdded, GroupRemoved, TagRenamed, GroupRenamed };
+
+    struct FieldChange {
+        std::string field;       // e.g. "email", "first_name"
+        std::string before;      // empty for Added
+        std::string after;       // empty for Deleted
+    };
+
+    struct Event {
+        std::uint64_t sequence;
+        Kind kind;
+        int contactId;           // 0 for a rename
+        std::string name;        // full name after the change (before, for Deleted)
+        std::string label;       // the tag or group of a tag / group event (old name, for a rename)
+        std::string newLabel;    // rename only
+        std::vector<FieldChange> fields;
+    };
+    typedef std::shared_ptr<const Event> EventPtr;
+    typedef std::function<void(const Event &)> Callback;
+
+    // A consumer's read position; start one with OpenCursor().
+    struct Cursor {
+        std::uint64_t next {0};      // sequence of the next event to read
+        std::uint64_t missed {0};    // events overwritten before they were read
+    };
+
+    explicit ChangeFeed(size_t capacity);
+
+    ChangeFeed(const ChangeFeed &) = delete;
+    ChangeFeed &operator=(const ChangeFeed &) = delete;
+
+    /************************************************************
+     * PublishChange
+     * ----------------------------------------------------------
+     * PURPOSE : Turn one stored change into events and publish
+     *           them. before is null for an add, after for a
+     *           delete. A change that only touches tags / groups
+     *           publishes no Edited event. Producer thread only.
+     ***********************************************************/
+    void PublishChange(const ContactPtr &before, const ContactPtr &after);
+
+    /************************************************************
+     * PublishRename
+     * ----------------------------------------------------------
+     * PURPOSE : One event for a tag or group renamed on every
+     *           contact at once. Producer thread only.
+     ***********************************************************/
+    void PublishRename(bool group, const std::string &from, const std::string &to);
+
+    /************************************************************
+     * Poll
+     * ----------------------------------------------------------
+     * PURPOSE : Append up to maxEvents events at or after the
+     *           cursor to out, oldest first, and advance it.
+     * RETURNS : (size_t) Number of events appended.
+     * NOTES   : Safe from any thread, concurrently with the
+     *           producer. Events lost to the ring wrapping are
+     *           added to cursor.missed and skipped.
+     ***********************************************************/
+    size_t Poll(Cursor &cursor, std::vector<EventPtr> &out, size_t maxEvents) const;
+
+    // A cursor that sees only events published after this call.
+    Cursor OpenCursor() const;
+
+    /************************************************************
+     * Subscribe / Unsubscribe
+     * ----------------------------------------------------------
+     * PURPOSE : Run callback for every event published from now
+     *           on. Keep callbacks short (wake a thread, count,
+     *           queue): they run on the editing thread.
+     * RETURNS : (int) Handle for Unsubscribe.
+     ***********************************************************/
+    int Subscribe(Callback callback);
+    void Unsubscribe(int handle);
+
+    std::uint64_t Published() const { return head_.load(std::memory_order_acquire); }
+    size_t Capacity() const { return slots_.size(); }
+
+    // Stable lower-case token ("added", "tag_removed", ...).
+    static const char *KindName(Kind kind);
+
+    // One NDJSON line (no trailing newline).
+    static std::string ToJson(const Event &event);
+
+private:
+    void Publish(Event event);
+
+    mutable std::mutex slotsMutex_;          // guards slots_ for pointer swaps and copies only
+    std::vector<EventPtr> slots_;
+    size_t mask_;                            // capacity - 1 (capacity is a power of two)
+    std::atomic<std::uint64_t> head_ {0};    // sequence of the next event
+
+    mutable std::mutex subscribersMutex_;    // guards subscribers_ (not the ring)
+    std::vector<std::pair<int, Callback>> subscribers_;
+    int nextHandle_ {1};
+};
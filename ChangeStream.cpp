@@ -0,0 +1,91 @@
+//======================================================================
+// Implementation File: ChangeStream.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   NDJSON writer thread for --change-stream.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * The feed callback only sets a flag and wakes the thread; all
+//     formatting and I/O happen here, off the editing thread.
+//   * The cursor is opened in the constructor, before the callback is
+//     registered, so no event published after construction is lost
+//     even if the file takes a while to open.
+//======================================================================
+
+#include "ChangeStream.h"
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace {
+    const size_t BATCH_EVENTS = 256;
+}
+
+ChangeStream::ChangeStream(ChangeFeed &feed, const std::string &path)
+    : feed_(feed), path_(path), cursor_(feed.OpenCursor()) {
+    subscription_ = feed_.Subscribe([this](const ChangeFeed::Event &) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            published_ = true;
+        }
+        wake_.notify_one();
+    });
+    writer_ = std::thread(&ChangeStream::Run, this);
+}
+
+ChangeStream::~ChangeStream() {
+    feed_.Unsubscribe(subscription_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (writer_.joinable()) writer_.join();
+}
+
+std::uint64_t ChangeStream::LinesWritten() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return linesWritten_;
+}
+
+void ChangeStream::Run() {
+    std::ofstream out(path_, std::ios::app);
+    if (!out.is_open()) {
+        std::cerr << "Warning: change stream " << path_ << " could not be opened; events are not streamed.\n";
+        return;
+    }
+
+    std::vector<ChangeFeed::EventPtr> batch;
+    std::uint64_t missedReported = 0;
+    for (;;) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return published_ || stopping_; });
+            published_ = false;
+            stopping = stopping_;
+        }
+
+        size_t lines = 0;
+        do {
+            batch.clear();
+            feed_.Poll(cursor_, batch, BATCH_EVENTS);
+            if (cursor_.missed != missedReported) {
+                out << "{\"event\":\"gap\",\"missed\":" << cursor_.missed - missedReported << "}\n";
+                missedReported = cursor_.missed;
+                ++lines;
+            }
+            for (const auto &event : batch) {
+                out << ChangeFeed::ToJson(*event) << '\n';
+                ++lines;
+            }
+        } while (!batch.empty());
+        out.flush();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            linesWritten_ += lines;
+        }
+        if (stopping) return;
+    }
+}
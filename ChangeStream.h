@@ -0,0 +1,58 @@
+#pragma once
+
+#include "ChangeFeed.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/****************************************************************
+ * CLASS: ChangeStream
+ * --------------------------------------------------------------
+ * Writes a ChangeFeed to a file or named pipe as NDJSON, one event
+ * per line, from its own thread, so a sync job can tail the file
+ * (or read the FIFO) and apply only the deltas:
+ *
+ *   {"seq":3,"event":"tag_added","id":41,"name":"Ann Lee","tag":"vip"}
+ *
+ * The file is opened for append on the writer thread (opening a
+ * FIFO waits for its reader without holding up the book). If the
+ * writer falls a whole ring behind, a {"event":"gap","missed":N}
+ * line tells the consumer to resynchronize from the saved file.
+ * Lines are flushed after every batch; the destructor drains what
+ * is left before it returns.
+ ***************************************************************/
+class ChangeStream {
+public:
+    /************************************************************
+     * ChangeStream
+     * ----------------------------------------------------------
+     * PARAMS  : feed (IN) - must outlive the stream
+     *           path (IN) - file or FIFO, appended to
+     ***********************************************************/
+    ChangeStream(ChangeFeed &feed, const std::string &path);
+    ~ChangeStream();
+
+    ChangeStream(const ChangeStream &) = delete;
+    ChangeStream &operator=(const ChangeStream &) = delete;
+
+    std::uint64_t LinesWritten() const;
+    const std::string &Path() const { return path_; }
+
+private:
+    void Run();
+
+    ChangeFeed &feed_;
+    const std::string path_;
+    ChangeFeed::Cursor cursor_;             // writer thread only
+    int subscription_ {0};
+
+    mutable std::mutex mutex_;              // guards everything below
+    std::condition_variable wake_;
+    bool published_ {false};
+    bool stopping_ {false};
+    std::uint64_t linesWritten_ {0};
+    std::thread writer_;                    // started last, joined first
+};
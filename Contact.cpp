@@ -7,29 +7,29 @@
 //   and type-to-string conversion.
 //----------------------------------------------------------------------
 // DESIGN NOTES:
-//   * All mutating operations are simple O(n) scans (vector) because
-//     expected list sizes for groups/tags are small. If performance
-//     becomes an issue, switch to unordered_set and keep a stable
-//     iteration order structure if needed for display.
-//   * toCSV currently does NOT escape delimiters; this is called out
-//     explicitly so future developers can improve without surprises.
+//   * Groups and tags are LabelSet ids over the global dictionaries;
+//     add/remove/has resolve the name once and then scan a handful
+//     of integers. Names are only materialized for display and CSV.
+//   * toCSV quotes fields per RFC 4180 (see CsvCodec) so commas and
+//     quotes inside notes round-trip through the file.
 //======================================================================
 
 #include "Contact.h"
+#include "CsvCodec.h"
 #include <sstream>
 
 // Static starting value for auto-incremented ids.
-int Contact::nextId_ = 1;
+std::atomic<int> Contact::nextId_(1);
 
 //**********************************************************************
 // generateId (private static)
 //----------------------------------------------------------------------
 // PURPOSE : Supplies a unique sequential id for each new Contact.
 // RETURNS : (int) next available id value.
-// NOTE    : Simple increment; thread-unsafe (acceptable for this
-//           console app). Could be replaced with atomic if needed.
+// NOTE    : Atomic, because shard files are parsed on several threads
+//           at once; ids stay unique across every loaded shard.
 //**********************************************************************
-int Contact::generateId() { return nextId_++; }
+int Contact::generateId() { return nextId_.fetch_add(1, std::memory_order_relaxed); }
 
 //**********************************************************************
 // Contact (default constructor)
@@ -81,6 +81,39 @@ std::string Contact::getFullName() const {
     return firstName_ + " " + lastName_;        // Both present
 }
 
+namespace {
+    std::vector<std::string> LabelNames(const LabelSet &labels, const LabelDictionary &dictionary) {
+        std::vector<std::string> names;
+        names.reserve(labels.size());
+        for (LabelSet::Id id : labels) names.push_back(dictionary.Name(id));
+        return names;
+    }
+
+    // Joins label names with a separator (", " for display, "|" for CSV).
+    std::string JoinLabels(const LabelSet &labels, const LabelDictionary &dictionary,
+                           const char *separator) {
+        std::string joined;
+        for (const LabelSet::Id *it = labels.begin(); it != labels.end(); ++it) {
+            if (it != labels.begin()) joined += separator;
+            joined += dictionary.Name(*it);
+        }
+        return joined;
+    }
+}
+
+//**********************************************************************
+// getGroups / getTags
+//----------------------------------------------------------------------
+// PURPOSE : Resolve the stored ids back to names, in insertion order.
+//**********************************************************************
+std::vector<std::string> Contact::getGroups() const {
+    return LabelNames(groups_, LabelDictionary::Groups());
+}
+
+std::vector<std::string> Contact::getTags() const {
+    return LabelNames(tags_, LabelDictionary::Tags());
+}
+
 //**********************************************************************
 // addGroup
 //----------------------------------------------------------------------
@@ -89,8 +122,8 @@ std::string Contact::getFullName() const {
 //**********************************************************************
 bool Contact::addGroup(const std::string &group) {
     if (group.empty()) return false; // Reject empty labels
-    if (std::find(groups_.begin(), groups_.end(), group) != groups_.end()) return false; // Already there
-    groups_.push_back(group);
+    if (!groups_.Insert(LabelDictionary::Groups().Intern(group))) return false; // Already there
+    ++version_;
     return true;
 }
 
@@ -101,9 +134,9 @@ bool Contact::addGroup(const std::string &group) {
 // RETURNS : true if a removal occurred; false if not found.
 //**********************************************************************
 bool Contact::removeGroup(const std::string &group) {
-    auto it = std::remove(groups_.begin(), groups_.end(), group); // move matches to end
-    if (it == groups_.end()) return false; // Not found
-    groups_.erase(it, groups_.end());
+    LabelSet::Id id;
+    if (!LabelDictionary::Groups().Find(group, id) || !groups_.Erase(id)) return false; // Not found
+    ++version_;
     return true;
 }
 
@@ -114,7 +147,22 @@ bool Contact::removeGroup(const std::string &group) {
 // RETURNS : true if found; false otherwise.
 //**********************************************************************
 bool Contact::hasGroup(const std::string &group) const {
-    return std::find(groups_.begin(), groups_.end(), group) != groups_.end();
+    LabelSet::Id id;
+    return LabelDictionary::Groups().Find(group, id) && groups_.Contains(id);
+}
+
+//**********************************************************************
+// renameGroup
+//----------------------------------------------------------------------
+// PURPOSE : Replaces group 'from' with 'to' in place.
+// RETURNS : true if the contact was in 'from'; false otherwise.
+//**********************************************************************
+bool Contact::renameGroup(const std::string &from, const std::string &to) {
+    LabelSet::Id id;
+    if (to.empty() || from == to || !LabelDictionary::Groups().Find(from, id) || !groups_.Contains(id)) return false;
+    groups_.Replace(id, LabelDictionary::Groups().Intern(to));
+    ++version_;
+    return true;
 }
 
 //**********************************************************************
@@ -124,8 +172,8 @@ bool Contact::hasGroup(const std::string &group) const {
 //**********************************************************************
 bool Contact::addTag(const std::string &tag) {
     if (tag.empty()) return false; // Reject empty tags
-    if (std::find(tags_.begin(), tags_.end(), tag) != tags_.end()) return false; // Already exists
-    tags_.push_back(tag);
+    if (!tags_.Insert(LabelDictionary::Tags().Intern(tag))) return false; // Already exists
+    ++version_;
     return true;
 }
 
@@ -135,9 +183,9 @@ bool Contact::addTag(const std::string &tag) {
 // PURPOSE : Removes a tag if found.
 //**********************************************************************
 bool Contact::removeTag(const std::string &tag) {
-    auto it = std::remove(tags_.begin(), tags_.end(), tag);
-    if (it == tags_.end()) return false; // Nothing to remove
-    tags_.erase(it, tags_.end());
+    LabelSet::Id id;
+    if (!LabelDictionary::Tags().Find(tag, id) || !tags_.Erase(id)) return false; // Nothing to remove
+    ++version_;
     return true;
 }
 
@@ -147,7 +195,21 @@ bool Contact::removeTag(const std::string &tag) {
 // PURPOSE : Checks whether a tag exists.
 //**********************************************************************
 bool Contact::hasTag(const std::string &tag) const {
-    return std::find(tags_.begin(), tags_.end(), tag) != tags_.end();
+    LabelSet::Id id;
+    return LabelDictionary::Tags().Find(tag, id) && tags_.Contains(id);
+}
+
+//**********************************************************************
+// renameTag
+//----------------------------------------------------------------------
+// PURPOSE : Replaces tag 'from' with 'to' in place.
+//**********************************************************************
+bool Contact::renameTag(const std::string &from, const std::string &to) {
+    LabelSet::Id id;
+    if (to.empty() || from == to || !LabelDictionary::Tags().Find(from, id) || !tags_.Contains(id)) return false;
+    tags_.Replace(id, LabelDictionary::Tags().Intern(to));
+    ++version_;
+    return true;
 }
 
 //**********************************************************************
@@ -178,22 +240,10 @@ std::string Contact::toString(bool includeEmptyFields) const {
         oss << "Postal: " << postalCode_ << '\n';
     if (!notes_.empty() || includeEmptyFields)
         oss << "Notes: " << notes_ << '\n';
-    if (!groups_.empty() || includeEmptyFields) {
-        oss << "Groups: ";
-        for (size_t i = 0; i < groups_.size(); ++i) {
-            if (i) oss << ", ";
-            oss << groups_[i];
-        }
-        oss << '\n';
-    }
-    if (!tags_.empty() || includeEmptyFields) {
-        oss << "Tags: ";
-        for (size_t i = 0; i < tags_.size(); ++i) {
-            if (i) oss << ", ";
-            oss << tags_[i];
-        }
-        oss << '\n';
-    }
+    if (!groups_.empty() || includeEmptyFields)
+        oss << "Groups: " << JoinLabels(groups_, LabelDictionary::Groups(), ", ") << '\n';
+    if (!tags_.empty() || includeEmptyFields)
+        oss << "Tags: " << JoinLabels(tags_, LabelDictionary::Tags(), ", ") << '\n';
     return oss.str();
 }
 
@@ -203,34 +253,23 @@ std::string Contact::toString(bool includeEmptyFields) const {
 // PURPOSE : Serialize the contact into a single comma-separated
 //           record. Groups and tags are pipe-delimited internally
 //           to keep them as single columns.
-// WARNING : No escaping of commas/quotes inside field values.
-//           Future improvement: implement RFC 4180 style quoting.
+// NOTE    : Each field goes through Csv::AppendField, which quotes
+//           it only when it contains a comma, quote or line break.
 //**********************************************************************
 std::string Contact::toCSV() const {
-    std::ostringstream oss;
-    oss << id_ << ','
-        << contactTypeToString(type_) << ','
-        << firstName_ << ','
-        << lastName_ << ','
-        << email_ << ','
-        << phone_ << ','
-        << addressLine_ << ','
-        << city_ << ','
-        << state_ << ','
-        << postalCode_ << ','
-        << notes_ << ',';
-    // groups joined by '|'
-    for (size_t i = 0; i < groups_.size(); ++i) {
-        if (i) oss << '|';
-        oss << groups_[i];
-    }
-    oss << ',';
-    // tags joined by '|'
-    for (size_t i = 0; i < tags_.size(); ++i) {
-        if (i) oss << '|';
-        oss << tags_[i];
+    const std::string groups = JoinLabels(groups_, LabelDictionary::Groups(), "|");
+    const std::string tags = JoinLabels(tags_, LabelDictionary::Tags(), "|");
+
+    const std::string type = contactTypeToString(type_);
+    std::string line = std::to_string(id_);
+    const std::string *fields[] = { &type, &firstName_, &lastName_, &email_, &phone_,
+                                    &addressLine_, &city_, &state_, &postalCode_,
+                                    &notes_, &groups, &tags };
+    for (const std::string *field : fields) {
+        line += ',';
+        Csv::AppendField(line, *field);
     }
-    return oss.str();
+    return line;
 }
 
 //**********************************************************************
@@ -4,6 +4,9 @@
 #include <vector>
 #include <ostream>
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include "LabelDictionary.h"
 
 /****************************************************************
  * ENUM: ContactType
@@ -33,7 +36,6 @@ enum class ContactType { Person, Business, Vendor, Emergency };
  *   - Provide simple string / CSV serialization helpers.
  *
  * LIMITATIONS / FUTURE WORK:
- *   - CSV currently does NOT escape commas or quotes.
  *   - No validation of email / phone formatting yet.
  ***************************************************************/
 class Contact {
@@ -90,6 +92,7 @@ public:
      * NOTE    : All getters are O(1) trivial inline operations.
      ***********************************************************/
     int getId() const { return id_; }
+    unsigned getVersion() const { return version_; }
     ContactType getType() const { return type_; }
     const std::string & getFirstName() const { return firstName_; }
     const std::string & getLastName() const { return lastName_; }
@@ -100,8 +103,18 @@ public:
     const std::string & getState() const { return state_; }
     const std::string & getPostalCode() const { return postalCode_; }
     const std::string & getNotes() const { return notes_; }
-    const std::vector<std::string> & getGroups() const { return groups_; }
-    const std::vector<std::string> & getTags() const { return tags_; }
+    const LabelSet & getGroupIds() const { return groups_; }
+    const LabelSet & getTagIds() const { return tags_; }
+
+    /************************************************************
+     * getGroups / getTags
+     * ----------------------------------------------------------
+     * PURPOSE : Label names in the order they were added.
+     * NOTE    : Builds the list from the dictionary each call;
+     *           use getGroupIds / getTagIds in hot loops.
+     ***********************************************************/
+    std::vector<std::string> getGroups() const;
+    std::vector<std::string> getTags() const;
 
     /************************************************************
      * getFullName
@@ -117,42 +130,48 @@ public:
      * ----------------------------------------------------------
      * PURPOSE : Mutate individual fields; each returns *this to
      *           allow chaining (e.g., c.setFirstName(...).setLastName(...)).
+     *           Every mutation bumps the version (see getVersion).
      * RETURNS : (Contact&) Reference to self.
      ***********************************************************/
-    Contact & setType(ContactType t) { type_ = t; return *this; }
-    Contact & setFirstName(const std::string &v) { firstName_ = v; return *this; }
-    Contact & setLastName(const std::string &v) { lastName_ = v; return *this; }
-    Contact & setEmail(const std::string &v) { email_ = v; return *this; }
-    Contact & setPhone(const std::string &v) { phone_ = v; return *this; }
-    Contact & setAddressLine(const std::string &v) { addressLine_ = v; return *this; }
-    Contact & setCity(const std::string &v) { city_ = v; return *this; }
-    Contact & setState(const std::string &v) { state_ = v; return *this; }
-    Contact & setPostalCode(const std::string &v) { postalCode_ = v; return *this; }
-    Contact & setNotes(const std::string &v) { notes_ = v; return *this; }
+    Contact & setType(ContactType t) { type_ = t; ++version_; return *this; }
+    Contact & setFirstName(const std::string &v) { firstName_ = v; ++version_; return *this; }
+    Contact & setLastName(const std::string &v) { lastName_ = v; ++version_; return *this; }
+    Contact & setEmail(const std::string &v) { email_ = v; ++version_; return *this; }
+    Contact & setPhone(const std::string &v) { phone_ = v; ++version_; return *this; }
+    Contact & setAddressLine(const std::string &v) { addressLine_ = v; ++version_; return *this; }
+    Contact & setCity(const std::string &v) { city_ = v; ++version_; return *this; }
+    Contact & setState(const std::string &v) { state_ = v; ++version_; return *this; }
+    Contact & setPostalCode(const std::string &v) { postalCode_ = v; ++version_; return *this; }
+    Contact & setNotes(const std::string &v) { notes_ = v; ++version_; return *this; }
 
     /************************************************************
      * addGroup / removeGroup / hasGroup
      * ----------------------------------------------------------
      * PURPOSE : Manage membership in a textual group list.
-     * RETURNS : add/remove -> true if a modification occurred.
+     * RETURNS : add/remove/rename -> true if a modification occurred.
      *            hasGroup  -> true if group present.
      * NOTE    : addGroup ignores empty strings & duplicates.
+     *           renameGroup keeps the group's position in the list;
+     *           if the contact is already in 'to' it just leaves 'from'.
      ***********************************************************/
     bool addGroup(const std::string &group);
     bool removeGroup(const std::string &group);
     bool hasGroup(const std::string &group) const;
+    bool renameGroup(const std::string &from, const std::string &to);
 
     /************************************************************
      * addTag / removeTag / hasTag
      * ----------------------------------------------------------
      * PURPOSE : Manage free-form tags for flexible filtering.
-     * RETURNS : add/remove -> true if a modification occurred.
+     * RETURNS : add/remove/rename -> true if a modification occurred.
      *            hasTag    -> true if tag present.
-     * NOTE    : addTag ignores empty strings & duplicates.
+     * NOTE    : addTag ignores empty strings & duplicates; renameTag
+     *           behaves like renameGroup.
      ***********************************************************/
     bool addTag(const std::string &tag);
     bool removeTag(const std::string &tag);
     bool hasTag(const std::string &tag) const;
+    bool renameTag(const std::string &from, const std::string &to);
 
     /************************************************************
      * toString
@@ -167,9 +186,9 @@ public:
     /************************************************************
      * toCSV
      * ----------------------------------------------------------
-     * PURPOSE : Serialize to a simple comma-separated line.
-     * RETURNS : (string) CSV-formatted record.
-     * WARNING : Commas / quotes in field values are NOT escaped.
+     * PURPOSE : Serialize to a comma-separated line.
+     * RETURNS : (string) RFC 4180 CSV record; fields containing
+     *           commas, quotes or line breaks are quoted.
      ***********************************************************/
     virtual std::string toCSV() const;
 
@@ -198,14 +217,14 @@ protected:
      * | state_       | std::string              | State / region                                |
      * | postalCode_  | std::string              | Postal / ZIP code                             |
      * | notes_       | std::string              | Free-form notes                               |
-     * | groups_      | vector<string>           | Named group memberships (unique entries)      |
-     * | tags_        | vector<string>           | Free-form tags (unique entries)               |
+     * | groups_      | LabelSet                 | Group ids in LabelDictionary::Groups()        |
+     * | tags_        | LabelSet                 | Tag ids in LabelDictionary::Tags()            |
+     * | version_     | unsigned                 | Bumped by every mutation; render cache key    |
      * ----------------------------------------------------------
      * DESIGN NOTES:
-     *   - groups_ and tags_ intentionally stored as vectors for
-     *     predictable iteration order; if performance of lookup
-     *     becomes critical, consider unordered_set and export
-     *     order separately.
+     *   - groups_ and tags_ hold dictionary ids in insertion
+     *     order; up to four of each live inline in the contact,
+     *     so copying a contact on edit allocates nothing for them.
      *   - id_ intentionally simple int; could migrate to UUID if
      *     merging multiple address books later.
      ***********************************************************/
@@ -221,11 +240,12 @@ protected:
     std::string state_;
     std::string postalCode_;
     std::string notes_;
-    std::vector<std::string> groups_;
-    std::vector<std::string> tags_;
+    LabelSet groups_;
+    LabelSet tags_;
+    unsigned version_ {0};
 
 private:
-    static int nextId_; // auto-increment id source.
+    static std::atomic<int> nextId_; // auto-increment id source (thread-safe).
     static int generateId();
 };
 
@@ -236,3 +256,15 @@ private:
     * RETURNS : (ostream&) reference to the passed stream.
     **************************************************************/
 std::ostream & operator<<(std::ostream &os, const Contact &c);
+
+ /***************************************************************
+    * ContactPtr
+    * -------------------------------------------------------------
+    * PURPOSE : Shared, immutable handle to a stored contact. The
+    *           address book never edits a stored contact in place;
+    *           an edit commits a new copy, so anyone still holding
+    *           the old handle (e.g. a save snapshot) keeps a
+    *           consistent view.
+    **************************************************************/
+using ContactPtr = std::shared_ptr<const Contact>;
+
@@ -0,0 +1,192 @@
+//======================================================================
+// Implementation File: CsvCodec.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   RFC 4180 field quoting and a vectorized record reader.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * Most bytes in an address book are plain text. The reader only
+//     stops on structural bytes, found 16 at a time with SSE2: four
+//     byte-compares are OR-ed into one mask, and the lowest set bit is
+//     the next stop. Everything before it is appended in bulk.
+//   * Inside a quoted field only '"' is structural, so a separate
+//     single-needle scan is used there.
+//   * Malformed input (stray quotes in unquoted fields, text after a
+//     closing quote, unterminated quotes) is accepted leniently rather
+//     than rejected, matching how spreadsheet tools behave.
+//======================================================================
+
+#include "CsvCodec.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CSV_USE_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace {
+
+#if defined(CSV_USE_SSE2)
+    // Index of the lowest set bit of a non-zero mask.
+    inline unsigned LowestSetBit(unsigned mask) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+#endif
+
+    inline bool IsStructural(char ch) {
+        return ch == ',' || ch == '"' || ch == '\n' || ch == '\r';
+    }
+}
+
+namespace Csv {
+
+//**********************************************************************
+// AppendField
+//----------------------------------------------------------------------
+// PURPOSE : Quote only when required so typical records stay identical
+//           to the old unquoted format.
+//**********************************************************************
+void AppendField(std::string &out, const std::string &value) {
+    if (value.find_first_of(",\"\r\n") == std::string::npos) {
+        out += value;
+        return;
+    }
+    out.reserve(out.size() + value.size() + 2);
+    out.push_back('"');
+    for (char ch : value) {
+        if (ch == '"') out.push_back('"');
+        out.push_back(ch);
+    }
+    out.push_back('"');
+}
+
+Reader::Reader(const char *data, size_t size) : data_(data), size_(size) {}
+
+//**********************************************************************
+// FindStructural (private)
+//----------------------------------------------------------------------
+// PURPOSE : First ',', '"', CR or LF at or after `from`; size_ if none.
+//**********************************************************************
+size_t Reader::FindStructural(size_t from) const {
+    size_t i = from;
+#if defined(CSV_USE_SSE2)
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i lf    = _mm_set1_epi8('\n');
+    const __m128i cr    = _mm_set1_epi8('\r');
+    for (; i + 16 <= size_; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data_ + i));
+        const __m128i hits  = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, comma),
+                                                        _mm_cmpeq_epi8(chunk, quote)),
+                                           _mm_or_si128(_mm_cmpeq_epi8(chunk, lf),
+                                                        _mm_cmpeq_epi8(chunk, cr)));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+        if (mask != 0) return i + LowestSetBit(mask);
+    }
+#endif
+    for (; i < size_; ++i) {
+        if (IsStructural(data_[i])) return i;
+    }
+    return size_;
+}
+
+//**********************************************************************
+// FindQuote (private)
+//----------------------------------------------------------------------
+// PURPOSE : First '"' at or after `from`; size_ if none.
+//**********************************************************************
+size_t Reader::FindQuote(size_t from) const {
+    if (from >= size_) return size_;
+    const void *hit = std::memchr(data_ + from, '"', size_ - from);
+    return hit ? static_cast<size_t>(static_cast<const char *>(hit) - data_) : size_;
+}
+
+//**********************************************************************
+// Next
+//----------------------------------------------------------------------
+// PURPOSE : Field-at-a-time state machine driven by the two scanners.
+//**********************************************************************
+bool Reader::Next(std::vector<std::string> &fields) {
+    fields.clear();
+
+    // Skip blank lines between records
+    while (pos_ < size_ && (data_[pos_] == '\n' || data_[pos_] == '\r')) {
+        if (data_[pos_] == '\n') ++line_;
+        ++pos_;
+    }
+    if (pos_ >= size_) return false;
+    recordLine_ = line_;
+
+    while (true) {
+        std::string field;
+
+        if (data_[pos_] == '"') {
+            // Quoted field: runs to the next quote not followed by another
+            ++pos_;
+            while (true) {
+                const size_t q = FindQuote(pos_);
+                for (size_t i = pos_; i < q; ++i) {
+                    if (data_[i] == '\n') ++line_;
+                }
+                field.append(data_ + pos_, q - pos_);
+                if (q >= size_) {          // unterminated: take the rest
+                    pos_ = size_;
+                    break;
+                }
+                if (q + 1 < size_ && data_[q + 1] == '"') {
+                    field.push_back('"');
+                    pos_ = q + 2;
+                    continue;
+                }
+                pos_ = q + 1;
+                break;
+            }
+        }
+
+        // Unquoted field, or stray text after a closing quote
+        while (pos_ < size_) {
+            const size_t stop = FindStructural(pos_);
+            field.append(data_ + pos_, stop - pos_);
+            pos_ = stop;
+            if (pos_ < size_ && data_[pos_] == '"') {
+                field.push_back('"');      // literal quote mid-field
+                ++pos_;
+                continue;
+            }
+            break;
+        }
+
+        fields.push_back(std::move(field));
+
+        if (pos_ >= size_) return true;
+        const char delimiter = data_[pos_++];
+        if (delimiter == ',') {
+            if (pos_ >= size_) {           // trailing comma at end of buffer
+                fields.emplace_back();
+                return true;
+            }
+            continue;
+        }
+        if (delimiter == '\r' && pos_ < size_ && data_[pos_] == '\n') ++pos_;
+        ++line_;
+        return true;
+    }
+}
+
+std::vector<std::string> SplitRecord(const std::string &line) {
+    std::vector<std::string> fields;
+    Reader reader(line.data(), line.size());
+    reader.Next(fields);
+    return fields;
+}
+
+}
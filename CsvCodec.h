@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/****************************************************************
+ * NAMESPACE: Csv
+ * --------------------------------------------------------------
+ * RFC 4180 CSV writing and reading.
+ *
+ * WRITING : A field is wrapped in double quotes when it contains
+ *           a comma, quote, CR or LF; embedded quotes are doubled.
+ * READING : Quoted fields may contain commas, doubled quotes and
+ *           line breaks. Both LF and CRLF end a record. Blank
+ *           lines are skipped.
+ ***************************************************************/
+namespace Csv {
+
+    /************************************************************
+     * AppendField
+     * ----------------------------------------------------------
+     * PURPOSE : Append one field to out, quoting only if needed.
+     ***********************************************************/
+    void AppendField(std::string &out, const std::string &value);
+
+    /************************************************************
+     * CLASS: Reader
+     * ----------------------------------------------------------
+     * Zero-copy cursor over an in-memory CSV buffer. The hot loop
+     * locates the next structural byte (',', '"', CR, LF) sixteen
+     * bytes at a time with SSE2 compare + movemask bitmasks, and
+     * copies the plain bytes in between in one append. Platforms
+     * without SSE2 use the scalar loop.
+     *
+     * NOTE    : The buffer must outlive the Reader.
+     ***********************************************************/
+    class Reader {
+    public:
+        Reader(const char *data, size_t size);
+
+        /********************************************************
+         * Next
+         * ------------------------------------------------------
+         * PURPOSE : Parse the next record into fields (cleared
+         *           first).
+         * RETURNS : false once the buffer is exhausted.
+         *******************************************************/
+        bool Next(std::vector<std::string> &fields);
+
+        /********************************************************
+         * LineNumber
+         * ------------------------------------------------------
+         * PURPOSE : 1-based physical line on which the most
+         *           recently returned record started.
+         *******************************************************/
+        size_t LineNumber() const { return recordLine_; }
+
+        /********************************************************
+         * Offset
+         * ------------------------------------------------------
+         * PURPOSE : Byte offset of the next unread record.
+         *******************************************************/
+        size_t Offset() const { return pos_; }
+
+    private:
+        size_t FindStructural(size_t from) const;
+        size_t FindQuote(size_t from) const;
+
+        const char *data_;
+        size_t size_;
+        size_t pos_ {0};
+        size_t line_ {1};        // physical line at pos_
+        size_t recordLine_ {0};
+    };
+
+    /************************************************************
+     * SplitRecord
+     * ----------------------------------------------------------
+     * PURPOSE : Convenience: parse a single record from text.
+     ***********************************************************/
+    std::vector<std::string> SplitRecord(const std::string &line);
+}
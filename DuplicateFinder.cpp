@@ -0,0 +1,198 @@
+//======================================================================
+// Implementation File: DuplicateFinder.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Blocking-key duplicate detection with parallel pair scoring.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * A pair that shares several blocks (same phone AND same email) is
+//     scored once per block; results are de-duplicated at the end by
+//     sorting on the (survivor, duplicate) pair.
+//   * Tasks only read the contact vector and write to their own
+//     block's result vector, so no locking is needed while scoring.
+//======================================================================
+
+#include "DuplicateFinder.h"
+#include "FuzzyIndex.h"
+#include "LocationIndex.h"
+#include "PhoneIndex.h"
+#include "PhoneticIndex.h"
+#include "TextUtils.h"
+#include "WorkStealing.h"
+#include <algorithm>
+#include <unordered_map>
+
+const size_t DuplicateFinder::MAX_BLOCK_SIZE;
+
+namespace {
+
+    // Relative score weights.
+    const double WEIGHT_PHONE  = 0.30;
+    const double WEIGHT_EMAIL  = 0.30;
+    const double WEIGHT_NAME   = 0.30;
+    const double WEIGHT_POSTAL = 0.10;
+
+    // Number of non-empty fields; used to pick the merge survivor.
+    int PopulatedFieldCount(const Contact &contact) {
+        int count = 0;
+        for (const std::string *field : { &contact.getFirstName(), &contact.getLastName(),
+                                          &contact.getEmail(), &contact.getPhone(),
+                                          &contact.getAddressLine(), &contact.getCity(),
+                                          &contact.getState(), &contact.getPostalCode(),
+                                          &contact.getNotes() }) {
+            if (!field->empty()) ++count;
+        }
+        return count + static_cast<int>(contact.getGroupIds().size() + contact.getTagIds().size());
+    }
+
+    void AppendReason(std::string &reasons, const char *reason) {
+        if (!reasons.empty()) reasons += ", ";
+        reasons += reason;
+    }
+}
+
+//**********************************************************************
+// Score (static)
+//----------------------------------------------------------------------
+// PURPOSE : Exact agreement on phone digits / email / ZIP plus a graded
+//           name similarity (1 - edit distance / longer length).
+//           A field only counts when both sides have it, and the sum is
+//           normalized by the weight that was actually comparable, so a
+//           record missing its email is not penalized for it. Pairs
+//           with less than a name's worth of comparable data score 0.
+//**********************************************************************
+double DuplicateFinder::Score(const Contact &lhs, const Contact &rhs, std::string &reasons) {
+    double score = 0.0;
+    double comparable = 0.0;
+    reasons.clear();
+
+    const std::uint64_t phoneA = PhoneIndex::Canonicalize(lhs.getPhone());
+    const std::uint64_t phoneB = PhoneIndex::Canonicalize(rhs.getPhone());
+    if (phoneA != 0 && phoneB != 0) {
+        comparable += WEIGHT_PHONE;
+        if (phoneA == phoneB) {
+            score += WEIGHT_PHONE;
+            AppendReason(reasons, "phone");
+        }
+    }
+
+    const std::string emailA = TextUtils::FoldCase(lhs.getEmail());
+    const std::string emailB = TextUtils::FoldCase(rhs.getEmail());
+    if (!emailA.empty() && !emailB.empty()) {
+        comparable += WEIGHT_EMAIL;
+        if (emailA == emailB) {
+            score += WEIGHT_EMAIL;
+            AppendReason(reasons, "email");
+        }
+    }
+
+    const std::string nameA = TextUtils::FoldCase(lhs.getFullName());
+    const std::string nameB = TextUtils::FoldCase(rhs.getFullName());
+    if (!nameA.empty() && !nameB.empty()) {
+        comparable += WEIGHT_NAME;
+        const size_t longer = std::max(nameA.size(), nameB.size());
+        const double similarity =
+            1.0 - static_cast<double>(FuzzyIndex::EditDistance(nameA, nameB)) / static_cast<double>(longer);
+        if (similarity > 0.0) score += WEIGHT_NAME * similarity;
+        if (similarity >= 1.0) {
+            AppendReason(reasons, "name");
+        } else if (similarity >= 0.75) {
+            AppendReason(reasons, "name~");
+        }
+    }
+
+    const int zipA = LocationIndex::ParsePostal(lhs.getPostalCode());
+    const int zipB = LocationIndex::ParsePostal(rhs.getPostalCode());
+    if (zipA >= 0 && zipB >= 0) {
+        comparable += WEIGHT_POSTAL;
+        if (zipA == zipB) {
+            score += WEIGHT_POSTAL;
+            AppendReason(reasons, "zip");
+        }
+    }
+
+    if (comparable < WEIGHT_NAME) return 0.0;
+    return score / comparable;
+}
+
+//**********************************************************************
+// Find (static)
+//----------------------------------------------------------------------
+// PURPOSE : 1) build blocks, 2) score blocks in parallel, 3) merge the
+//           per-thread results, drop repeats, rank by score.
+//**********************************************************************
+std::vector<DuplicateFinder::MergeProposal> DuplicateFinder::Find(const std::vector<ContactPtr> &contacts,
+                                                                  double minScore,
+                                                                  unsigned threadCount) {
+    // 1) Blocking
+    std::unordered_map<std::string, std::vector<size_t>> blockMap;
+    for (size_t i = 0; i < contacts.size(); ++i) {
+        const Contact &contact = *contacts[i];
+
+        const std::uint64_t phone = PhoneIndex::Canonicalize(contact.getPhone());
+        if (phone != 0) blockMap["p:" + std::to_string(phone)].push_back(i);
+
+        const std::string email = TextUtils::FoldCase(contact.getEmail());
+        if (!email.empty()) blockMap["e:" + email].push_back(i);
+
+        const int zip = LocationIndex::ParsePostal(contact.getPostalCode());
+        const std::string last = PhoneticIndex::Soundex(contact.getLastName());
+        if (zip >= 0 && !last.empty()) {
+            blockMap["n:" + last + PhoneticIndex::Soundex(contact.getFirstName()) + std::to_string(zip)]
+                .push_back(i);
+        }
+    }
+
+    std::vector<const std::vector<size_t> *> blocks;
+    for (const auto &entry : blockMap) {
+        if (entry.second.size() >= 2 && entry.second.size() <= MAX_BLOCK_SIZE) {
+            blocks.push_back(&entry.second);
+        }
+    }
+
+    // 2) Parallel scoring, one task per block.
+    std::vector<std::vector<MergeProposal>> perBlock(blocks.size());
+    WorkStealing::ParallelFor(blocks.size(), threadCount, [&](size_t b) {
+        std::string reasons;
+        const std::vector<size_t> &members = *blocks[b];
+        for (size_t x = 0; x < members.size(); ++x) {
+            for (size_t y = x + 1; y < members.size(); ++y) {
+                const Contact &a = *contacts[members[x]];
+                const Contact &c = *contacts[members[y]];
+                const double score = Score(a, c, reasons);
+                if (score < minScore) continue;
+
+                const int fieldsA = PopulatedFieldCount(a);
+                const int fieldsC = PopulatedFieldCount(c);
+                const bool keepA = fieldsA > fieldsC || (fieldsA == fieldsC && a.getId() < c.getId());
+                perBlock[b].push_back(MergeProposal {
+                    keepA ? a.getId() : c.getId(),
+                    keepA ? c.getId() : a.getId(),
+                    score, reasons });
+            }
+        }
+    });
+
+    // 3) Merge, de-duplicate, rank
+    std::vector<MergeProposal> proposals;
+    for (auto &local : perBlock) {
+        proposals.insert(proposals.end(),
+                         std::make_move_iterator(local.begin()),
+                         std::make_move_iterator(local.end()));
+    }
+    std::sort(proposals.begin(), proposals.end(),
+              [](const MergeProposal &a, const MergeProposal &b) {
+                  if (a.survivorId != b.survivorId) return a.survivorId < b.survivorId;
+                  return a.duplicateId < b.duplicateId;
+              });
+    proposals.erase(std::unique(proposals.begin(), proposals.end(),
+                                [](const MergeProposal &a, const MergeProposal &b) {
+                                    return a.survivorId == b.survivorId && a.duplicateId == b.duplicateId;
+                                }),
+                    proposals.end());
+    std::stable_sort(proposals.begin(), proposals.end(),
+                     [](const MergeProposal &a, const MergeProposal &b) {
+                         return a.score > b.score;
+                     });
+    return proposals;
+}
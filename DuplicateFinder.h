@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Contact.h"
+#include <string>
+#include <vector>
+
+/****************************************************************
+ * CLASS: DuplicateFinder
+ * --------------------------------------------------------------
+ * Finds likely duplicate contacts without comparing every pair.
+ * Each contact is dropped into a few "blocks" keyed by cheap,
+ * normalized values; only contacts sharing a block are scored.
+ *
+ *   | Blocking key | Built from                                 |
+ *   |--------------|--------------------------------------------|
+ *   | phone        | canonical digits of the phone number       |
+ *   | email        | case-folded email address                  |
+ *   | name+zip     | Soundex(last) + Soundex(first) + 5-digit ZIP|
+ *
+ * Blocks are scored in parallel (WorkStealing::ParallelFor), so
+ * one very large block does not leave the other threads idle.
+ ***************************************************************/
+class DuplicateFinder {
+public:
+    /************************************************************
+     * MergeProposal
+     * ----------------------------------------------------------
+     * PURPOSE : One candidate pair. survivorId is the record with
+     *           more populated fields (ties -> lower id).
+     ***********************************************************/
+    struct MergeProposal {
+        int survivorId;
+        int duplicateId;
+        double score;          // 0.0 - 1.0
+        std::string reasons;   // e.g. "phone, email, name~"
+    };
+
+    /************************************************************
+     * Find (static)
+     * ----------------------------------------------------------
+     * PURPOSE : Block, score and rank candidate duplicate pairs.
+     * PARAMS  : contacts    (IN) - the whole book
+     *           minScore    (IN) - pairs below this are dropped
+     *           threadCount (IN) - 0 = hardware concurrency
+     * RETURNS : (vector<MergeProposal>) Highest score first.
+     ***********************************************************/
+    static std::vector<MergeProposal> Find(const std::vector<ContactPtr> &contacts,
+                                           double minScore,
+                                           unsigned threadCount = 0);
+
+    /************************************************************
+     * Score (static)
+     * ----------------------------------------------------------
+     * PURPOSE : Weighted similarity of two contacts.
+     * RETURNS : (double) 0.0 - 1.0; reasons lists what agreed.
+     ***********************************************************/
+    static double Score(const Contact &lhs, const Contact &rhs, std::string &reasons);
+
+    /************************************************************
+     * MAX_BLOCK_SIZE
+     * ----------------------------------------------------------
+     * Blocks larger than this (placeholder numbers like
+     * 555-0000, shared office lines) are skipped: they carry
+     * little signal and would reintroduce quadratic work.
+     ***********************************************************/
+    static const size_t MAX_BLOCK_SIZE = 256;
+};
@@ -0,0 +1,152 @@
+//======================================================================
+// Implementation File: EmailIndex.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Domain / local-part split index for email lookups and reports.
+//======================================================================
+
+#include "EmailIndex.h"
+#include "TextUtils.h"
+#include <algorithm>
+
+//**********************************************************************
+// Split (private static)
+//----------------------------------------------------------------------
+// PURPOSE : Case-folds and splits at the LAST '@' (quoted local parts
+//           may legally contain '@'). Fails when either side is empty.
+//**********************************************************************
+bool EmailIndex::Split(const std::string &email, Parts &parts) {
+    const std::string folded = TextUtils::FoldCase(email);
+    const size_t at = folded.rfind('@');
+    if (at == std::string::npos || at == 0 || at + 1 == folded.size()) return false;
+    parts.local = folded.substr(0, at);
+    parts.domain = folded.substr(at + 1);
+    return true;
+}
+
+std::string EmailIndex::ReverseDomain(const std::string &domain) {
+    std::vector<std::string> labels;
+    size_t start = 0;
+    while (true) {
+        const size_t dot = domain.find('.', start);
+        labels.push_back(domain.substr(start, dot - start));
+        if (dot == std::string::npos) break;
+        start = dot + 1;
+    }
+
+    std::string reversed;
+    reversed.reserve(domain.size());
+    for (auto label = labels.rbegin(); label != labels.rend(); ++label) {
+        if (!reversed.empty()) reversed.push_back('.');
+        reversed += *label;
+    }
+    return reversed;
+}
+
+void EmailIndex::Erase(std::vector<int> &ids, int contactId) {
+    ids.erase(std::remove(ids.begin(), ids.end(), contactId), ids.end());
+}
+
+void EmailIndex::Add(const Contact &contact) {
+    Parts parts;
+    if (!Split(contact.getEmail(), parts)) return;
+
+    const int id = contact.getId();
+    domainIndex_[parts.domain].push_back(id);
+    reversedIndex_[ReverseDomain(parts.domain)].push_back(id);
+    localIndex_[parts.local].push_back(id);
+    partsById_[id] = std::move(parts);
+}
+
+void EmailIndex::Remove(const Contact &contact) {
+    auto stored = partsById_.find(contact.getId());
+    if (stored == partsById_.end()) return;
+
+    const int id = contact.getId();
+    const Parts &parts = stored->second;
+
+    auto domain = domainIndex_.find(parts.domain);
+    if (domain != domainIndex_.end()) {
+        Erase(domain->second, id);
+        if (domain->second.empty()) domainIndex_.erase(domain);
+    }
+    auto reversed = reversedIndex_.find(ReverseDomain(parts.domain));
+    if (reversed != reversedIndex_.end()) {
+        Erase(reversed->second, id);
+        if (reversed->second.empty()) reversedIndex_.erase(reversed);
+    }
+    auto local = localIndex_.find(parts.local);
+    if (local != localIndex_.end()) {
+        Erase(local->second, id);
+        if (local->second.empty()) localIndex_.erase(local);
+    }
+    partsById_.erase(stored);
+}
+
+void EmailIndex::Clear() {
+    domainIndex_.clear();
+    reversedIndex_.clear();
+    localIndex_.clear();
+    partsById_.clear();
+}
+
+//**********************************************************************
+// ByDomain
+//----------------------------------------------------------------------
+// PURPOSE : Exact domain -> one hash probe. With subdomains, add the
+//           contiguous range of reversed keys beginning "com.acme.".
+//**********************************************************************
+std::vector<int> EmailIndex::ByDomain(const std::string &domain, bool includeSubdomains) const {
+    std::string folded = TextUtils::FoldCase(domain);
+    if (!folded.empty() && folded[0] == '@') folded.erase(0, 1);
+
+    std::vector<int> ids;
+    if (folded.empty()) return ids;
+
+    if (!includeSubdomains) {
+        auto found = domainIndex_.find(folded);
+        if (found != domainIndex_.end()) ids = found->second;
+        return ids;
+    }
+
+    // The root and its children are probed separately: keys such as
+    // "com.acme-corp" sort between "com.acme" and "com.acme.".
+    const std::string root = ReverseDomain(folded);
+    auto exact = reversedIndex_.find(root);
+    if (exact != reversedIndex_.end()) ids = exact->second;
+
+    const std::string childPrefix = root + ".";
+    for (auto it = reversedIndex_.lower_bound(childPrefix); it != reversedIndex_.end(); ++it) {
+        if (!TextUtils::StartsWith(it->first, childPrefix)) break;
+        ids.insert(ids.end(), it->second.begin(), it->second.end());
+    }
+    return ids;
+}
+
+std::vector<int> EmailIndex::ByLocalPart(const std::string &localPart) const {
+    std::string folded = TextUtils::FoldCase(localPart);
+    if (!folded.empty() && folded.back() == '@') folded.pop_back();
+
+    auto found = localIndex_.find(folded);
+    return found == localIndex_.end() ? std::vector<int>() : found->second;
+}
+
+//**********************************************************************
+// DomainCounts
+//----------------------------------------------------------------------
+// PURPOSE : One entry per distinct domain, largest first (ties sorted
+//           by name). Cost is proportional to the number of domains.
+//**********************************************************************
+std::vector<std::pair<std::string, size_t>> EmailIndex::DomainCounts() const {
+    std::vector<std::pair<std::string, size_t>> counts;
+    counts.reserve(domainIndex_.size());
+    for (const auto &entry : domainIndex_) {
+        counts.emplace_back(entry.first, entry.second.size());
+    }
+    std::sort(counts.begin(), counts.end(),
+              [](const std::pair<std::string, size_t> &a, const std::pair<std::string, size_t> &b) {
+                  if (a.second != b.second) return a.second > b.second;
+                  return a.first < b.first;
+              });
+    return counts;
+}
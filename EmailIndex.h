@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Contact.h"
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/****************************************************************
+ * CLASS: EmailIndex
+ * --------------------------------------------------------------
+ * Emails split at insert time into a local part and a domain:
+ *
+ *   "Jane@Mail.Acme.com" -> local "jane", domain "mail.acme.com",
+ *                           reversed domain "com.acme.mail"
+ *
+ *   | Structure      | Key             | Serves                    |
+ *   |----------------|-----------------|---------------------------|
+ *   | domainIndex_   | exact domain    | "everyone @acme.com"      |
+ *   | reversedIndex_ | reversed domain | subdomain rollups (sorted)|
+ *   | localIndex_    | local part      | "jane@" in any domain     |
+ *
+ * Reversing the labels puts every subdomain of acme.com directly
+ * after "com.acme" in sorted order, so a rollup is one contiguous
+ * range scan.
+ ***************************************************************/
+class EmailIndex {
+public:
+    void Add(const Contact &contact);
+    void Remove(const Contact &contact);
+    void Clear();
+
+    /************************************************************
+     * ByDomain
+     * ----------------------------------------------------------
+     * PURPOSE : Contacts at a domain (leading '@' optional).
+     * PARAMS  : includeSubdomains (IN) - also match *.domain
+     * RETURNS : (vector<int>) Contact ids.
+     ***********************************************************/
+    std::vector<int> ByDomain(const std::string &domain, bool includeSubdomains) const;
+
+    /************************************************************
+     * ByLocalPart
+     * ----------------------------------------------------------
+     * PURPOSE : Contacts whose address starts with "local@".
+     ***********************************************************/
+    std::vector<int> ByLocalPart(const std::string &localPart) const;
+
+    /************************************************************
+     * DomainCounts
+     * ----------------------------------------------------------
+     * PURPOSE : (domain, contact count) for every distinct domain,
+     *           read straight from the index; no contact scan.
+     ***********************************************************/
+    std::vector<std::pair<std::string, size_t>> DomainCounts() const;
+
+    /************************************************************
+     * ReverseDomain (static)
+     * ----------------------------------------------------------
+     * PURPOSE : "mail.acme.com" -> "com.acme.mail".
+     ***********************************************************/
+    static std::string ReverseDomain(const std::string &domain);
+
+private:
+    struct Parts {
+        std::string local;
+        std::string domain;
+    };
+
+    static bool Split(const std::string &email, Parts &parts);
+    static void Erase(std::vector<int> &ids, int contactId);
+
+    std::unordered_map<std::string, std::vector<int>> domainIndex_;
+    std::map<std::string, std::vector<int>> reversedIndex_;
+    std::unordered_map<std::string, std::vector<int>> localIndex_;
+    std::unordered_map<int, Parts> partsById_;   // split once, reused on removal
+};
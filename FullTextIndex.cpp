@@ -0,0 +1,351 @@
+//======================================================================
+// Implementation File: FullTextIndex.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Tokenizer, light stemmer and compressed positional postings for
+//   full-text search.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * Variable-byte rather than PForDelta: postings here are short
+//     (a few words per note), so block codecs would be mostly
+//     padding, and varbyte can append one document at a time.
+//   * A query walks its words' lists in step, rarest first; the
+//     others only skip ahead to the rarest word's documents, and
+//     positions are decoded only for documents holding every word
+//     of a phrase.
+//======================================================================
+
+#include "FullTextIndex.h"
+#include "TextUtils.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+    const size_t COMPACT_MIN_DEAD = 1024;   // below this, dead documents just wait
+
+    void AppendVarByte(std::vector<unsigned char> &bytes, uint32_t value) {
+        while (value >= 0x80) {
+            bytes.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<unsigned char>(value));
+    }
+
+    uint32_t ReadVarByte(const std::vector<unsigned char> &bytes, size_t &offset) {
+        uint32_t value = 0;
+        int shift = 0;
+        while (bytes[offset] >= 0x80) {
+            value |= static_cast<uint32_t>(bytes[offset++] & 0x7F) << shift;
+            shift += 7;
+        }
+        return value | static_cast<uint32_t>(bytes[offset++]) << shift;
+    }
+
+    bool EndsWith(const std::string &word, const char *suffix) {
+        const size_t length = std::strlen(suffix);
+        return word.size() >= length && word.compare(word.size() - length, length, suffix) == 0;
+    }
+
+    // Reads one posting list a document at a time.
+    class Cursor {
+    public:
+        explicit Cursor(const std::vector<unsigned char> &bytes) : bytes_(bytes) {}
+
+        bool Next() {
+            if (offset_ >= bytes_.size()) return false;
+            document_ += ReadVarByte(bytes_, offset_);
+            count_ = ReadVarByte(bytes_, offset_);
+            positionsOffset_ = offset_;
+            for (uint32_t i = 0; i < count_; ++i) {
+                while (bytes_[offset_++] >= 0x80) {}
+            }
+            started_ = true;
+            return true;
+        }
+
+        // Moves to the first document >= target; false if there is none.
+        bool SeekTo(uint32_t target) {
+            while (!started_ || document_ < target) {
+                if (!Next()) return false;
+            }
+            return true;
+        }
+
+        uint32_t Document() const { return document_; }
+
+        void Positions(std::vector<uint32_t> &positions) const {
+            positions.clear();
+            size_t offset = positionsOffset_;
+            uint32_t position = 0;
+            for (uint32_t i = 0; i < count_; ++i) {
+                position += ReadVarByte(bytes_, offset);
+                positions.push_back(position);
+            }
+        }
+
+    private:
+        const std::vector<unsigned char> &bytes_;
+        size_t offset_ {0};
+        size_t positionsOffset_ {0};
+        uint32_t document_ {0};
+        uint32_t count_ {0};
+        bool started_ {false};
+    };
+
+    // Query text as phrases: quoted text is one phrase, every other
+    // word a phrase of its own. An unclosed quote runs to the end.
+    std::vector<std::vector<std::string>> ParsePhrases(const std::string &query, bool stemming) {
+        std::vector<std::vector<std::string>> phrases;
+        std::string segment;
+        bool quoted = false;
+        auto flush = [&]() {
+            std::vector<std::string> terms = FullTextIndex::Tokenize(segment, stemming);
+            if (quoted) {
+                if (!terms.empty()) phrases.push_back(std::move(terms));
+            } else {
+                for (auto &term : terms) phrases.push_back(std::vector<std::string>(1, std::move(term)));
+            }
+            segment.clear();
+        };
+        for (const char c : query) {
+            if (c == '"') {
+                flush();
+                quoted = !quoted;
+            } else {
+                segment += c;
+            }
+        }
+        flush();
+        return phrases;
+    }
+}
+
+std::vector<std::string> FullTextIndex::Tokenize(const std::string &text, bool stemming) {
+    std::vector<std::string> terms = TextUtils::SplitWords(text);
+    if (stemming) {
+        for (auto &term : terms) term = Stem(term);
+    }
+    return terms;
+}
+
+std::string FullTextIndex::Stem(const std::string &word) {
+    if (word.size() <= 3) return word;
+    std::string stem = word;
+    if (EndsWith(stem, "ies") && stem.size() > 4) {
+        stem.replace(stem.size() - 3, 3, "y");
+    } else if (EndsWith(stem, "sses")) {
+        stem.erase(stem.size() - 2);
+    } else if (EndsWith(stem, "s") && !EndsWith(stem, "ss") && !EndsWith(stem, "us") && !EndsWith(stem, "is")) {
+        stem.pop_back();
+    }
+
+    // -ing / -ed only when four letters remain ("thing", "need" stay).
+    if (EndsWith(stem, "ing") && stem.size() >= 7) {
+        stem.erase(stem.size() - 3);
+    } else if (EndsWith(stem, "ed") && stem.size() >= 6) {
+        stem.erase(stem.size() - 2);
+    } else {
+        return stem;
+    }
+    const char last = stem.back();
+    if (last == stem[stem.size() - 2] && last >= 'a' && last <= 'z' && !std::strchr("aeiouylsz", last)) {
+        stem.pop_back();   // "preferr" -> "prefer", but "call" and "pass" keep theirs
+    }
+    return stem;
+}
+
+void FullTextIndex::AppendDocument(PostingList &list, uint32_t document, const std::vector<uint32_t> &positions) {
+    AppendVarByte(list.bytes, list.documents == 0 ? document : document - list.lastDocument);
+    AppendVarByte(list.bytes, static_cast<uint32_t>(positions.size()));
+    uint32_t previous = 0;
+    for (uint32_t position : positions) {
+        AppendVarByte(list.bytes, position - previous);
+        previous = position;
+    }
+    list.lastDocument = document;
+    ++list.documents;
+}
+
+void FullTextIndex::Add(const Contact &contact) {
+    Remove(contact);   // a contact is indexed once; normally already gone
+
+    const uint32_t document = static_cast<uint32_t>(contactOfDocument_.size());
+    contactOfDocument_.push_back(contact.getId());
+    live_.push_back(true);
+    documentOf_[contact.getId()] = document;
+
+    std::vector<std::pair<std::string, uint32_t>> occurrences;   // (term, position)
+    uint32_t position = 0;
+    auto addField = [&](const std::string &text) {
+        for (auto &term : Tokenize(text, stemming_)) {
+            occurrences.emplace_back(std::move(term), position++);
+        }
+        ++position;   // phrases do not run from one field into the next
+    };
+    addField(contact.getFirstName() + ' ' + contact.getLastName());
+    addField(contact.getAddressLine());
+    addField(contact.getNotes());
+
+    std::sort(occurrences.begin(), occurrences.end());
+    std::vector<uint32_t> positions;
+    for (size_t start = 0; start < occurrences.size();) {
+        size_t end = start;
+        positions.clear();
+        while (end < occurrences.size() && occurrences[end].first == occurrences[start].first) {
+            positions.push_back(occurrences[end++].second);
+        }
+        AppendDocument(postings_[occurrences[start].first], document, positions);
+        start = end;
+    }
+}
+
+void FullTextIndex::Remove(const Contact &contact) {
+    auto found = documentOf_.find(contact.getId());
+    if (found == documentOf_.end()) return;
+    live_[found->second] = false;
+    documentOf_.erase(found);
+    ++deadDocuments_;
+    if (!bulkLoading_) CompactIfSparse();
+}
+
+void FullTextIndex::Clear() {
+    postings_.clear();
+    contactOfDocument_.clear();
+    live_.clear();
+    documentOf_.clear();
+    deadDocuments_ = 0;
+}
+
+void FullTextIndex::BeginBulkLoad() {
+    bulkLoading_ = true;
+}
+
+void FullTextIndex::EndBulkLoad() {
+    bulkLoading_ = false;
+    CompactIfSparse();
+}
+
+void FullTextIndex::CompactIfSparse() {
+    if (deadDocuments_ >= COMPACT_MIN_DEAD && deadDocuments_ * 2 > contactOfDocument_.size()) {
+        Compact();
+    }
+}
+
+//  Re-encodes every list without dead documents, renumbering the live
+//  ones densely in their existing order.
+void FullTextIndex::Compact() {
+    std::vector<uint32_t> renumbered(contactOfDocument_.size(), 0);
+    std::vector<int> contacts;
+    for (size_t document = 0; document < contactOfDocument_.size(); ++document) {
+        if (live_[document]) {
+            renumbered[document] = static_cast<uint32_t>(contacts.size());
+            contacts.push_back(contactOfDocument_[document]);
+        }
+    }
+
+    std::vector<uint32_t> positions;
+    for (auto entry = postings_.begin(); entry != postings_.end();) {
+        PostingList compacted;
+        Cursor cursor(entry->second.bytes);
+        while (cursor.Next()) {
+            if (live_[cursor.Document()]) {
+                cursor.Positions(positions);
+                AppendDocument(compacted, renumbered[cursor.Document()], positions);
+            }
+        }
+        if (compacted.documents == 0) {
+            entry = postings_.erase(entry);
+        } else {
+            compacted.bytes.shrink_to_fit();
+            entry->second = std::move(compacted);
+            ++entry;
+        }
+    }
+
+    contactOfDocument_.swap(contacts);
+    live_.assign(contactOfDocument_.size(), true);
+    documentOf_.clear();
+    for (size_t document = 0; document < contactOfDocument_.size(); ++document) {
+        documentOf_[contactOfDocument_[document]] = static_cast<uint32_t>(document);
+    }
+    deadDocuments_ = 0;
+}
+
+std::vector<int> FullTextIndex::Search(const std::string &query) const {
+    const std::vector<std::vector<std::string>> phrases = ParsePhrases(query, stemming_);
+    if (phrases.empty()) return {};
+
+    // One cursor per distinct word; a missing word means no matches.
+    std::vector<std::string> terms;
+    std::vector<std::vector<size_t>> phraseCursors;
+    for (const auto &phrase : phrases) {
+        phraseCursors.emplace_back();
+        for (const auto &term : phrase) {
+            size_t index = std::find(terms.begin(), terms.end(), term) - terms.begin();
+            if (index == terms.size()) terms.push_back(term);
+            phraseCursors.back().push_back(index);
+        }
+    }
+    std::vector<Cursor> cursors;
+    std::vector<size_t> rarestFirst;
+    for (const auto &term : terms) {
+        auto found = postings_.find(term);
+        if (found == postings_.end()) return {};
+        cursors.emplace_back(found->second.bytes);
+        rarestFirst.push_back(rarestFirst.size());
+    }
+    std::sort(rarestFirst.begin(), rarestFirst.end(), [&](size_t a, size_t b) {
+        return postings_.at(terms[a]).documents < postings_.at(terms[b]).documents;
+    });
+
+    std::vector<int> contactIds;
+    std::vector<std::vector<uint32_t>> positions(cursors.size());
+    uint32_t target = 0;
+    while (true) {
+        // Bring every cursor to the same document, or stop at the end
+        // of any list.
+        bool aligned = true;
+        for (size_t index : rarestFirst) {
+            if (!cursors[index].SeekTo(target)) {
+                std::sort(contactIds.begin(), contactIds.end());
+                return contactIds;
+            }
+            if (cursors[index].Document() > target) {
+                target = cursors[index].Document();
+                aligned = false;
+                break;
+            }
+        }
+        if (!aligned) continue;
+
+        bool matched = live_[target];
+        for (size_t p = 0; matched && p < phraseCursors.size(); ++p) {
+            const std::vector<size_t> &phrase = phraseCursors[p];
+            if (phrase.size() < 2) continue;
+            for (size_t index : phrase) cursors[index].Positions(positions[index]);
+            matched = false;
+            for (uint32_t start : positions[phrase[0]]) {
+                size_t word = 1;
+                while (word < phrase.size() &&
+                       std::binary_search(positions[phrase[word]].begin(), positions[phrase[word]].end(),
+                                          start + static_cast<uint32_t>(word))) {
+                    ++word;
+                }
+                if (word == phrase.size()) {
+                    matched = true;
+                    break;
+                }
+            }
+        }
+        if (matched) contactIds.push_back(contactOfDocument_[target]);
+        ++target;
+    }
+}
+
+size_t FullTextIndex::PostingBytes() const {
+    size_t bytes = 0;
+    for (const auto &entry : postings_) bytes += entry.second.bytes.size();
+    return bytes;
+}
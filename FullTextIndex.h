@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Contact.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/****************************************************************
+ * CLASS: FullTextIndex
+ * --------------------------------------------------------------
+ * Positional inverted index over the words of each contact's
+ * name, street address and notes, for queries such as
+ *     prefers "morning delivery"
+ * (every word must occur; quoted words must occur in order).
+ *
+ * Words come from TextUtils::SplitWords (case-folded, split on
+ * punctuation), optionally reduced by a light stemmer so that
+ * "deliveries" finds "delivery" and "prefers" finds "preferred".
+ * Positions run through the fields in that order, with one
+ * position skipped between fields so a phrase never spans two.
+ *
+ * Each indexed contact gets a document number, and each word a
+ * posting list of (document gap, position count, position
+ * gaps) in variable-byte form: most gaps fit one byte, so a list
+ * takes a fraction of the space of plain integers and is read
+ * front to back.
+ *
+ * Lists are append-only. A removed or edited contact's document
+ * is marked dead (an edit re-adds the contact as a new document)
+ * and skipped by queries; once dead documents outnumber live ones
+ * the lists are re-encoded without them. Bulk mode (loads) puts
+ * that clean-up off to EndBulkLoad().
+ ***************************************************************/
+class FullTextIndex {
+public:
+    explicit FullTextIndex(bool stemming) : stemming_(stemming) {}
+
+    /************************************************************
+     * Tokenize (static)
+     * ----------------------------------------------------------
+     * PURPOSE : The index terms of text, in order, as queries and
+     *           indexing see them.
+     ***********************************************************/
+    static std::vector<std::string> Tokenize(const std::string &text, bool stemming);
+
+    /************************************************************
+     * Stem (static)
+     * ----------------------------------------------------------
+     * PURPOSE : Strip common English suffixes from a folded
+     *           word: plural -s / -es / -ies, then -ing / -ed
+     *           (undoubling "preferr" -> "prefer"). Words of
+     *           three letters or fewer are left alone.
+     ***********************************************************/
+    static std::string Stem(const std::string &word);
+
+    void Add(const Contact &contact);
+    void Remove(const Contact &contact);
+    void Clear();
+    void BeginBulkLoad();
+    void EndBulkLoad();
+
+    /************************************************************
+     * Search
+     * ----------------------------------------------------------
+     * PURPOSE : Contacts containing every word of the query, and
+     *           every "quoted phrase" as consecutive words.
+     * RETURNS : (vector<int>) Contact ids, ascending; empty if
+     *           the query has no words.
+     ***********************************************************/
+    std::vector<int> Search(const std::string &query) const;
+
+    size_t Terms() const { return postings_.size(); }
+    size_t PostingBytes() const;
+
+private:
+    struct PostingList {
+        std::vector<unsigned char> bytes;
+        uint32_t lastDocument {0};
+        uint32_t documents {0};
+    };
+
+    static void AppendDocument(PostingList &list, uint32_t document, const std::vector<uint32_t> &positions);
+    void CompactIfSparse();
+    void Compact();
+
+    bool stemming_;
+    bool bulkLoading_ {false};
+    std::unordered_map<std::string, PostingList> postings_;
+    std::vector<int> contactOfDocument_;             // document -> contact id
+    std::vector<bool> live_;                         // document -> not removed since
+    std::unordered_map<int, uint32_t> documentOf_;   // contact id -> its live document
+    size_t deadDocuments_ {0};
+};
@@ -0,0 +1,201 @@
+//======================================================================
+// Implementation File: FuzzyIndex.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   BK-tree for bounded edit-distance name search.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * Nodes live in one vector and refer to children by index, which
+//     keeps the tree compact and avoids per-node heap allocations for
+//     pointers.
+//   * Exact-key lookups (adding a second contact with the same name)
+//     go through nodeByKey_ and never touch the tree.
+//======================================================================
+
+#include "FuzzyIndex.h"
+#include "TextUtils.h"
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+
+//**********************************************************************
+// KeysFor (private static)
+//----------------------------------------------------------------------
+// PURPOSE : Folded first, last and full name; empty and repeated keys
+//           are skipped.
+//**********************************************************************
+std::vector<std::string> FuzzyIndex::KeysFor(const Contact &contact) {
+    std::vector<std::string> keys;
+    const std::string first = TextUtils::FoldCase(contact.getFirstName());
+    const std::string last  = TextUtils::FoldCase(contact.getLastName());
+    const std::string full  = TextUtils::FoldCase(contact.getFullName());
+
+    for (const std::string *key : { &first, &last, &full }) {
+        if (key->empty()) continue;
+        if (std::find(keys.begin(), keys.end(), *key) != keys.end()) continue;
+        keys.push_back(*key);
+    }
+    return keys;
+}
+
+//**********************************************************************
+// EditDistance (static)
+//----------------------------------------------------------------------
+// PURPOSE : Lowrance-Wagner unrestricted Damerau-Levenshtein. Unlike
+//           the "optimal string alignment" variant this satisfies the
+//           triangle inequality, which BK-tree pruning depends on.
+//**********************************************************************
+int FuzzyIndex::EditDistance(const std::string &lhs, const std::string &rhs) {
+    const int n = static_cast<int>(lhs.size());
+    const int m = static_cast<int>(rhs.size());
+    const int maxDist = n + m;
+    const int width = m + 2;
+
+    // Reused scratch matrix: a BK-tree walk calls this once per visited
+    // node, so avoiding an allocation per call matters.
+    thread_local std::vector<int> d;
+    d.assign(static_cast<size_t>((n + 2) * width), 0);
+    auto at = [&](int i, int j) -> int & { return d[static_cast<size_t>(i * width + j)]; };
+
+    std::array<int, 256> lastRowOf {};   // last row where each byte occurred in lhs
+    at(0, 0) = maxDist;
+    for (int i = 0; i <= n; ++i) { at(i + 1, 0) = maxDist; at(i + 1, 1) = i; }
+    for (int j = 0; j <= m; ++j) { at(0, j + 1) = maxDist; at(1, j + 1) = j; }
+
+    for (int i = 1; i <= n; ++i) {
+        int lastMatchCol = 0;
+        for (int j = 1; j <= m; ++j) {
+            const int i1 = lastRowOf[static_cast<unsigned char>(rhs[j - 1])];
+            const int j1 = lastMatchCol;
+            int cost = 1;
+            if (lhs[i - 1] == rhs[j - 1]) {
+                cost = 0;
+                lastMatchCol = j;
+            }
+            at(i + 1, j + 1) = std::min({ at(i, j) + cost,                               // substitute
+                                          at(i + 1, j) + 1,                              // insert
+                                          at(i, j + 1) + 1,                              // delete
+                                          at(i1, j1) + (i - i1 - 1) + 1 + (j - j1 - 1) });// transpose
+        }
+        lastRowOf[static_cast<unsigned char>(lhs[i - 1])] = i;
+    }
+    return at(n + 1, m + 1);
+}
+
+//**********************************************************************
+// Add
+//----------------------------------------------------------------------
+// PURPOSE : Attach the contact id to each key's node, creating the node
+//           by walking the tree along matching edge distances.
+//**********************************************************************
+void FuzzyIndex::Add(const Contact &contact) {
+    for (const auto &key : KeysFor(contact)) {
+        auto existing = nodeByKey_.find(key);
+        if (existing != nodeByKey_.end()) {
+            nodes_[static_cast<size_t>(existing->second)].contactIds.push_back(contact.getId());
+            continue;
+        }
+
+        const int newIndex = static_cast<int>(nodes_.size());
+        if (!nodes_.empty()) {
+            int current = 0;
+            while (true) {
+                const int dist = EditDistance(key, nodes_[static_cast<size_t>(current)].key);
+                auto &children = nodes_[static_cast<size_t>(current)].children;
+                auto child = std::find_if(children.begin(), children.end(),
+                                          [dist](const std::pair<int, int> &edge) {
+                                              return edge.first == dist;
+                                          });
+                if (child == children.end()) {
+                    children.emplace_back(dist, newIndex);
+                    break;
+                }
+                current = child->second;
+            }
+        }
+
+        Node node;
+        node.key = key;
+        node.contactIds.push_back(contact.getId());
+        nodes_.push_back(std::move(node));
+        nodeByKey_[key] = newIndex;
+    }
+}
+
+//**********************************************************************
+// Remove
+//----------------------------------------------------------------------
+// PURPOSE : Detach the contact id from each of its key nodes. Nodes are
+//           kept so the subtree beneath them stays reachable.
+//**********************************************************************
+void FuzzyIndex::Remove(const Contact &contact) {
+    for (const auto &key : KeysFor(contact)) {
+        auto existing = nodeByKey_.find(key);
+        if (existing == nodeByKey_.end()) continue;
+        auto &ids = nodes_[static_cast<size_t>(existing->second)].contactIds;
+        auto pos = std::find(ids.begin(), ids.end(), contact.getId());
+        if (pos != ids.end()) ids.erase(pos);
+    }
+}
+
+void FuzzyIndex::Clear() {
+    nodes_.clear();
+    nodeByKey_.clear();
+}
+
+//**********************************************************************
+// Search
+//----------------------------------------------------------------------
+// PURPOSE : Iterative BK-tree walk. Each contact keeps its smallest
+//           distance across keys; the result is partially sorted to
+//           the requested top-K.
+//**********************************************************************
+std::vector<FuzzyIndex::Match> FuzzyIndex::Search(const std::string &query,
+                                                   int maxDistance,
+                                                   size_t limit) const {
+    std::vector<Match> matches;
+    if (nodes_.empty() || limit == 0 || maxDistance < 0) return matches;
+
+    const std::string folded = TextUtils::FoldCase(query);
+    std::unordered_map<int, int> bestById;
+    std::vector<int> pending { 0 };
+
+    while (!pending.empty()) {
+        const Node &node = nodes_[static_cast<size_t>(pending.back())];
+        pending.pop_back();
+
+        const int dist = EditDistance(folded, node.key);
+        if (dist <= maxDistance) {
+            for (int id : node.contactIds) {
+                auto found = bestById.find(id);
+                if (found == bestById.end() || dist < found->second) {
+                    bestById[id] = dist;
+                }
+            }
+        }
+
+        for (const auto &edge : node.children) {
+            if (edge.first >= dist - maxDistance && edge.first <= dist + maxDistance) {
+                pending.push_back(edge.second);
+            }
+        }
+    }
+
+    matches.reserve(bestById.size());
+    for (const auto &entry : bestById) {
+        matches.push_back(Match { entry.first, entry.second });
+    }
+
+    auto byRank = [](const Match &a, const Match &b) {
+        if (a.distance != b.distance) return a.distance < b.distance;
+        return a.contactId < b.contactId;
+    };
+    if (matches.size() > limit) {
+        std::partial_sort(matches.begin(), matches.begin() + static_cast<long>(limit),
+                          matches.end(), byRank);
+        matches.resize(limit);
+    } else {
+        std::sort(matches.begin(), matches.end(), byRank);
+    }
+    return matches;
+}
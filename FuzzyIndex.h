@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Contact.h"
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/****************************************************************
+ * CLASS: FuzzyIndex
+ * --------------------------------------------------------------
+ * BK-tree over the case-folded first, last and full names of all
+ * contacts. Edge labels are edit distances, so a query with
+ * tolerance k only descends into children whose edge lies in
+ * [d - k, d + k] (triangle inequality) instead of measuring the
+ * distance to every contact.
+ *
+ * RESPONSIBILITIES:
+ *   - Map each distinct key to one tree node holding the ids of
+ *     every contact that produced the key.
+ *   - Support incremental add/remove. Removing the last id of a
+ *     node leaves it in place as a routing node (BK-trees cannot
+ *     unlink interior nodes cheaply).
+ *
+ * NOTE    : The metric is unrestricted Damerau-Levenshtein, so a
+ *           swapped pair of letters ("Jonh") costs 1, and it is a
+ *           true metric as the BK-tree requires.
+ ***************************************************************/
+class FuzzyIndex {
+public:
+    /************************************************************
+     * Match
+     * ----------------------------------------------------------
+     * PURPOSE : One fuzzy hit: the contact and its best distance
+     *           over all of its indexed keys.
+     ***********************************************************/
+    struct Match {
+        int contactId;
+        int distance;
+    };
+
+    void Add(const Contact &contact);
+    void Remove(const Contact &contact);
+    void Clear();
+
+    /************************************************************
+     * Search
+     * ----------------------------------------------------------
+     * PURPOSE : Find contacts within maxDistance edits of query.
+     * PARAMS  : query       (IN) - name as typed (any case)
+     *           maxDistance (IN) - edit tolerance (0 = exact)
+     *           limit       (IN) - maximum matches returned
+     * RETURNS : (vector<Match>) Sorted by distance, then id.
+     ***********************************************************/
+    std::vector<Match> Search(const std::string &query, int maxDistance, size_t limit) const;
+
+    /************************************************************
+     * EditDistance (static)
+     * ----------------------------------------------------------
+     * PURPOSE : Unrestricted Damerau-Levenshtein distance.
+     ***********************************************************/
+    static int EditDistance(const std::string &lhs, const std::string &rhs);
+
+private:
+    struct Node {
+        std::string key;                           // case-folded name
+        std::vector<int> contactIds;               // owners of this key (may be empty)
+        std::vector<std::pair<int, int>> children; // (edge distance, node index)
+    };
+
+    static std::vector<std::string> KeysFor(const Contact &contact);
+
+    std::vector<Node> nodes_;                          // nodes_[0] is the root
+    std::unordered_map<std::string, int> nodeByKey_;   // exact key -> node index
+};
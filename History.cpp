@@ -0,0 +1,75 @@
+//======================================================================
+// Implementation File: History.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Bounded undo / redo stacks of contact-pointer deltas and label
+//   renames.
+//======================================================================
+
+#include "History.h"
+
+History::History(size_t limit) : limit_(limit) {}
+
+void History::Begin(const std::string &label) {
+    if (openDepth_++ == 0) {
+        open_ = Revision();
+        open_.label = label;
+    }
+}
+
+void History::End() {
+    if (--openDepth_ > 0 || (open_.changes.empty() && open_.renames.empty())) return;
+    Push(std::move(open_));
+    open_ = Revision();
+}
+
+void History::Push(Revision revision) {
+    undo_.push_back(std::move(revision));
+    while (undo_.size() > limit_) undo_.pop_front();
+}
+
+void History::Record(const Change &change, const std::string &fallbackLabel) {
+    redo_.clear();
+    if (openDepth_ > 0) {
+        open_.changes.push_back(change);
+        return;
+    }
+    Revision revision;
+    revision.label = fallbackLabel;
+    revision.changes.push_back(change);
+    Push(std::move(revision));
+}
+
+void History::RecordRename(const Rename &rename, const std::string &fallbackLabel) {
+    redo_.clear();
+    if (openDepth_ > 0) {
+        open_.renames.push_back(rename);
+        return;
+    }
+    Revision revision;
+    revision.label = fallbackLabel;
+    revision.renames.push_back(rename);
+    Push(std::move(revision));
+}
+
+bool History::TakeUndo(Revision &revision) {
+    if (undo_.empty() || openDepth_ > 0) return false;
+    revision = undo_.back();
+    redo_.push_back(std::move(undo_.back()));
+    undo_.pop_back();
+    return true;
+}
+
+bool History::TakeRedo(Revision &revision) {
+    if (redo_.empty() || openDepth_ > 0) return false;
+    revision = redo_.back();
+    undo_.push_back(std::move(redo_.back()));
+    redo_.pop_back();
+    return true;
+}
+
+void History::Clear() {
+    undo_.clear();
+    redo_.clear();
+    open_ = Revision();
+}
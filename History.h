@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Contact.h"
+#include "LabelDictionary.h"
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+/****************************************************************
+ * CLASS: History
+ * --------------------------------------------------------------
+ * Undo / redo journal for the address book.
+ *
+ * A revision is the list of slot changes one user action made
+ * (a merge is an edit plus a delete). Each change holds the
+ * contact pointers from before and after it, and stored contacts
+ * are immutable and shared, so every version of the book is
+ * reachable by replaying revisions while unchanged contacts
+ * are never copied: memory grows with the edits made, not with
+ * the size of the book times the number of versions kept.
+ *
+ * Positions recorded in a change are valid because revisions are
+ * always undone newest-first (and redone oldest-first); anything
+ * that moves contacts outside the journal must Clear() it.
+ ***************************************************************/
+class History {
+public:
+    // One slot change: add (before null), delete (after null) or edit.
+    struct Change {
+        ContactPtr before;
+        ContactPtr after;
+        size_t position;         // index in the contact vector
+        size_t shard;            // owning shard (for re-inserts)
+    };
+
+    // A tag or group renamed in its dictionary: every holder changes
+    // at once, so there is no contact change to keep.
+    struct Rename {
+        bool group;              // false: tag
+        LabelDictionary::Id id;
+        std::string from;
+        std::string to;
+    };
+
+    struct Revision {
+        std::string label;       // shown by the UI, e.g. "Edit Ann Lee"
+        std::vector<Change> changes;
+        std::vector<Rename> renames;     // made after changes
+    };
+
+    /************************************************************
+     * Scope
+     * ----------------------------------------------------------
+     * PURPOSE : Groups every change made while it is alive into
+     *           one revision. Scopes nest; the outermost label
+     *           wins. Empty revisions are dropped.
+     ***********************************************************/
+    class Scope {
+    public:
+        Scope(History &history, const std::string &label) : history_(history) { history_.Begin(label); }
+        ~Scope() { history_.End(); }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    private:
+        History &history_;
+    };
+
+    explicit History(size_t limit);
+
+    /************************************************************
+     * Record
+     * ----------------------------------------------------------
+     * PURPOSE : Add a change to the open revision, or as its own
+     *           revision (labelled fallbackLabel) if none is open.
+     *           Any redo history is discarded.
+     ***********************************************************/
+    void Record(const Change &change, const std::string &fallbackLabel);
+    void RecordRename(const Rename &rename, const std::string &fallbackLabel);
+
+    /************************************************************
+     * TakeUndo / TakeRedo
+     * ----------------------------------------------------------
+     * PURPOSE : Move the newest revision to the other stack and
+     *           hand it to the caller to apply.
+     * RETURNS : (bool) false if there is nothing to undo / redo.
+     ***********************************************************/
+    bool TakeUndo(Revision &revision);
+    bool TakeRedo(Revision &revision);
+
+    void Clear();
+    void ClearRedo() { redo_.clear(); }
+    size_t UndoDepth() const { return undo_.size(); }
+    size_t RedoDepth() const { return redo_.size(); }
+
+private:
+    void Begin(const std::string &label);
+    void End();
+    void Push(Revision revision);
+
+    std::deque<Revision> undo_;      // back = newest; front dropped past limit_
+    std::vector<Revision> redo_;     // back = next to redo
+    Revision open_;
+    int openDepth_ {0};
+    size_t limit_;
+};
@@ -0,0 +1,184 @@
+//======================================================================
+// Implementation File: LabelDictionary.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Global tag / group dictionaries and the compact per-contact set.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * Intern takes the shared lock first and only upgrades to the
+//     exclusive one for a label it has not seen; after the first few
+//     records of a load nearly every call is a shared-lock hit.
+//   * A rename adds the new text to names_ and points the id at it,
+//     so a reference returned by Name() before the rename stays valid
+//     (it just shows the old name).
+//   * LabelSet grows its heap array by doubling and never shrinks
+//     back to inline storage; a contact that once had many labels is
+//     rare enough that the few bytes do not matter.
+//======================================================================
+
+#include "LabelDictionary.h"
+#include <algorithm>
+#include <mutex>
+
+namespace {
+
+    //  Shared by NameFreeze holders, exclusive for a rename; one gate
+    //  for both dictionaries, since a record writes tags and groups.
+    std::shared_timed_mutex &RenameGate() {
+        static std::shared_timed_mutex gate;
+        return gate;
+    }
+}
+
+LabelDictionary &LabelDictionary::Tags() {
+    static LabelDictionary tags;
+    return tags;
+}
+
+LabelDictionary &LabelDictionary::Groups() {
+    static LabelDictionary groups;
+    return groups;
+}
+
+LabelDictionary::Id LabelDictionary::Intern(const std::string &label) {
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+        auto found = ids_.find(label);
+        if (found != ids_.end()) return found->second;
+    }
+    std::unique_lock<std::shared_timed_mutex> lock(mutex_);
+    auto inserted = ids_.emplace(label, static_cast<Id>(nameOf_.size()));
+    if (inserted.second) {
+        nameOf_.push_back(names_.size());
+        names_.push_back(label);
+    }
+    return inserted.first->second;
+}
+
+bool LabelDictionary::Find(const std::string &label, Id &id) const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+    auto found = ids_.find(label);
+    if (found == ids_.end()) return false;
+    id = found->second;
+    return true;
+}
+
+const std::string &LabelDictionary::Name(Id id) const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+    return names_[nameOf_.at(id)];
+}
+
+void LabelDictionary::Rename(Id id, const std::string &to) {
+    std::unique_lock<std::shared_timed_mutex> gate(RenameGate());
+    std::unique_lock<std::shared_timed_mutex> lock(mutex_);
+    const std::string &from = names_[nameOf_.at(id)];
+    if (from == to) return;
+
+    // Release the old name, to whoever held it before id did.
+    auto previous = setAside_.find(id);
+    if (previous != setAside_.end()) {
+        ids_[from] = previous->second;
+        setAside_.erase(previous);
+    } else {
+        ids_.erase(from);
+    }
+
+    auto taken = ids_.find(to);
+    if (taken != ids_.end()) {
+        setAside_[id] = taken->second;
+        taken->second = id;
+    } else {
+        ids_.emplace(to, id);
+    }
+    nameOf_[id] = names_.size();
+    names_.push_back(to);
+}
+
+LabelDictionary::NameFreeze::NameFreeze() {
+    RenameGate().lock_shared();
+}
+
+LabelDictionary::NameFreeze::~NameFreeze() {
+    RenameGate().unlock_shared();
+}
+
+size_t LabelDictionary::Size() const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+    return nameOf_.size();
+}
+
+LabelSet::LabelSet(const LabelSet &other) : size_(other.size_) {
+    if (other.size_ > INLINE_CAPACITY) {
+        capacity_ = other.size_;
+        heap_ = new Id[capacity_];
+    }
+    std::copy(other.begin(), other.end(), Data());
+}
+
+LabelSet::LabelSet(LabelSet &&other) noexcept : size_(other.size_), capacity_(other.capacity_) {
+    if (capacity_ > INLINE_CAPACITY) {
+        heap_ = other.heap_;
+        other.capacity_ = INLINE_CAPACITY;
+    } else {
+        std::copy(other.inline_, other.inline_ + size_, inline_);
+    }
+    other.size_ = 0;
+}
+
+LabelSet &LabelSet::operator=(const LabelSet &other) {
+    if (this != &other) *this = LabelSet(other);
+    return *this;
+}
+
+LabelSet &LabelSet::operator=(LabelSet &&other) noexcept {
+    if (this == &other) return *this;
+    if (capacity_ > INLINE_CAPACITY) delete[] heap_;
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    if (capacity_ > INLINE_CAPACITY) {
+        heap_ = other.heap_;
+        other.capacity_ = INLINE_CAPACITY;
+    } else {
+        std::copy(other.inline_, other.inline_ + size_, inline_);
+    }
+    other.size_ = 0;
+    return *this;
+}
+
+LabelSet::~LabelSet() {
+    if (capacity_ > INLINE_CAPACITY) delete[] heap_;
+}
+
+bool LabelSet::Insert(Id id) {
+    if (Contains(id)) return false;
+    if (size_ == capacity_) {
+        const std::uint32_t grown = capacity_ * 2;
+        Id *larger = new Id[grown];
+        std::copy(begin(), end(), larger);
+        if (capacity_ > INLINE_CAPACITY) delete[] heap_;
+        heap_ = larger;
+        capacity_ = grown;
+    }
+    Data()[size_++] = id;
+    return true;
+}
+
+bool LabelSet::Erase(Id id) {
+    Id *first = Data();
+    Id *last = first + size_;
+    Id *found = std::find(first, last, id);
+    if (found == last) return false;
+    std::copy(found + 1, last, found);
+    --size_;
+    return true;
+}
+
+bool LabelSet::Replace(Id from, Id to) {
+    if (from == to) return Contains(from);
+    if (Contains(to)) return Erase(from);
+    Id *last = Data() + size_;
+    Id *found = std::find(Data(), last, from);
+    if (found == last) return false;
+    *found = to;
+    return true;
+}
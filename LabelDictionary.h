@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/****************************************************************
+ * CLASS: LabelDictionary
+ * --------------------------------------------------------------
+ * Process-wide mapping between tag / group names and dense ids
+ * (0, 1, 2 ... in order of first use). Contacts store ids, so a
+ * membership test is an integer compare, and a label's text is
+ * kept once however many contacts carry it.
+ *
+ * Ids are never reused or removed: history entries and save
+ * snapshots hold contacts from earlier versions of the book, and
+ * their ids must keep their meaning. The dictionary therefore
+ * only grows, by one entry per distinct label ever seen.
+ *
+ * An id's name can change (Rename), which renames the label on
+ * every contact holding it at once; the book journals renames so
+ * that undo names the id back before older versions reappear.
+ * Because the dictionaries are shared by every book in the
+ * process, a rename waits while any save holds a NameFreeze, so
+ * a file never mixes a label's old and new names.
+ *
+ * Thread-safe: the load pipeline interns labels on its parse
+ * threads while other threads read names.
+ ***************************************************************/
+class LabelDictionary {
+public:
+    typedef std::uint32_t Id;
+
+    /************************************************************
+     * Tags / Groups (static)
+     * ----------------------------------------------------------
+     * PURPOSE : The two dictionaries; tag and group ids are
+     *           separate number spaces.
+     ***********************************************************/
+    static LabelDictionary &Tags();
+    static LabelDictionary &Groups();
+
+    /************************************************************
+     * Intern
+     * ----------------------------------------------------------
+     * PURPOSE : Id of a label, adding it on first use.
+     ***********************************************************/
+    Id Intern(const std::string &label);
+
+    /************************************************************
+     * Find
+     * ----------------------------------------------------------
+     * PURPOSE : Id of a label without adding it.
+     * RETURNS : (bool) false if no contact ever had the label.
+     ***********************************************************/
+    bool Find(const std::string &label, Id &id) const;
+
+    /************************************************************
+     * Name
+     * ----------------------------------------------------------
+     * PURPOSE : Text of an interned id. The reference stays valid
+     *           for the life of the program.
+     ***********************************************************/
+    const std::string &Name(Id id) const;
+
+    /************************************************************
+     * Rename
+     * ----------------------------------------------------------
+     * PURPOSE : Give id the name to, in O(1). If another id
+     *           already has that name, it is set aside until id
+     *           moves on to a different name, when it gets the
+     *           name back (so rename / undo / redo round-trip);
+     *           the caller makes sure no current contact holds
+     *           the one set aside.
+     ***********************************************************/
+    void Rename(Id id, const std::string &to);
+
+    /************************************************************
+     * CLASS: NameFreeze
+     * ----------------------------------------------------------
+     * While one exists, Rename() on either dictionary waits.
+     * Saves hold one for as long as they serialize records.
+     ***********************************************************/
+    class NameFreeze {
+    public:
+        NameFreeze();
+        ~NameFreeze();
+        NameFreeze(const NameFreeze &) = delete;
+        NameFreeze &operator=(const NameFreeze &) = delete;
+    };
+
+    size_t Size() const;
+
+private:
+    mutable std::shared_timed_mutex mutex_;          // exclusive: Intern of a new label, Rename
+    std::unordered_map<std::string, Id> ids_;
+    std::deque<std::string> names_;                  // every name ever given; deque keeps references stable
+    std::vector<size_t> nameOf_;                     // id -> its current entry in names_
+    std::unordered_map<Id, Id> setAside_;            // id -> the id it took its name from
+};
+
+/****************************************************************
+ * CLASS: LabelSet
+ * --------------------------------------------------------------
+ * A contact's tags or groups as dictionary ids. Up to
+ * INLINE_CAPACITY ids live inside the object itself, so the usual
+ * contact (0-4 labels) costs no heap allocation and copies as a
+ * few words; more spill to a heap array.
+ *
+ * Ids are kept in insertion order, not sorted: the order is what
+ * the CSV file, the detail view and the change feed show, and for
+ * a handful of integers a linear scan is as fast as a search.
+ ***************************************************************/
+class LabelSet {
+public:
+    typedef LabelDictionary::Id Id;
+    static const std::uint32_t INLINE_CAPACITY = 4;
+
+    LabelSet() {}
+    LabelSet(const LabelSet &other);
+    LabelSet(LabelSet &&other) noexcept;
+    LabelSet &operator=(const LabelSet &other);
+    LabelSet &operator=(LabelSet &&other) noexcept;
+    ~LabelSet();
+
+    /************************************************************
+     * Insert / Erase / Replace / Contains
+     * ----------------------------------------------------------
+     * RETURNS : Insert  -> false if the id was already present.
+     *           Erase   -> false if it was not; the order of the
+     *                      remaining ids is kept.
+     *           Replace -> false if from was not present. to takes
+     *                      from's place, or from is just erased if
+     *                      to is already present.
+     ***********************************************************/
+    bool Insert(Id id);
+    bool Erase(Id id);
+    bool Replace(Id from, Id to);
+    bool Contains(Id id) const {
+        for (const Id *it = begin(); it != end(); ++it) {
+            if (*it == id) return true;
+        }
+        return false;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const Id *begin() const { return capacity_ > INLINE_CAPACITY ? heap_ : inline_; }
+    const Id *end() const { return begin() + size_; }
+
+private:
+    Id *Data() { return capacity_ > INLINE_CAPACITY ? heap_ : inline_; }
+
+    std::uint32_t size_ {0};
+    std::uint32_t capacity_ {INLINE_CAPACITY};      // > INLINE_CAPACITY: heap_ is in use
+    union {
+        Id inline_[INLINE_CAPACITY];
+        Id *heap_;
+    };
+};
@@ -0,0 +1,125 @@
+//======================================================================
+// Implementation File: LabelIndex.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Dense-id posting lists for tags and groups.
+//======================================================================
+
+#include "LabelIndex.h"
+#include <algorithm>
+
+void LabelIndex::Add(const Contact &contact) {
+    for (LabelSet::Id tag : contact.getTagIds()) Insert(byTag_, tag, contact.getId());
+    for (LabelSet::Id group : contact.getGroupIds()) Insert(byGroup_, group, contact.getId());
+}
+
+void LabelIndex::Remove(const Contact &contact) {
+    for (LabelSet::Id tag : contact.getTagIds()) Erase(byTag_, tag, contact.getId());
+    for (LabelSet::Id group : contact.getGroupIds()) Erase(byGroup_, group, contact.getId());
+}
+
+void LabelIndex::Clear() {
+    byTag_ = Postings();
+    byGroup_ = Postings();
+}
+
+void LabelIndex::BeginBulkLoad() {
+    bulkLoading_ = true;
+}
+
+void LabelIndex::EndBulkLoad() {
+    bulkLoading_ = false;
+    Settle(byTag_);
+    Settle(byGroup_);
+}
+
+void LabelIndex::Insert(Postings &postings, LabelSet::Id label, int contactId) {
+    if (label >= postings.holders.size()) postings.holders.resize(label + 1);
+    std::vector<int> &contactIds = postings.holders[label];
+    if (contactIds.empty() || contactIds.back() < contactId) {
+        contactIds.push_back(contactId);
+    } else if (bulkLoading_) {
+        contactIds.push_back(contactId);
+        postings.touched.push_back(label);
+    } else {
+        contactIds.insert(std::lower_bound(contactIds.begin(), contactIds.end(), contactId), contactId);
+    }
+}
+
+void LabelIndex::Erase(Postings &postings, LabelSet::Id label, int contactId) {
+    if (label >= postings.holders.size()) return;
+    if (bulkLoading_) {
+        if (label >= postings.removed.size()) postings.removed.resize(label + 1);
+        postings.removed[label].push_back(contactId);
+        postings.touched.push_back(label);
+        return;
+    }
+    std::vector<int> &contactIds = postings.holders[label];
+    auto found = std::lower_bound(contactIds.begin(), contactIds.end(), contactId);
+    if (found != contactIds.end() && *found == contactId) contactIds.erase(found);
+}
+
+//  Ends bulk mode for one posting set. A list may hold an id twice
+//  (removed and re-added in the same batch), so each deferred removal
+//  drops exactly one occurrence.
+void LabelIndex::Settle(Postings &postings) {
+    std::sort(postings.touched.begin(), postings.touched.end());
+    postings.touched.erase(std::unique(postings.touched.begin(), postings.touched.end()),
+                           postings.touched.end());
+    for (LabelSet::Id label : postings.touched) {
+        std::vector<int> &contactIds = postings.holders[label];
+        std::sort(contactIds.begin(), contactIds.end());
+        if (label >= postings.removed.size() || postings.removed[label].empty()) continue;
+
+        std::vector<int> &removed = postings.removed[label];
+        std::sort(removed.begin(), removed.end());
+        auto drop = removed.begin();
+        auto kept = contactIds.begin();
+        for (int contactId : contactIds) {
+            while (drop != removed.end() && *drop < contactId) ++drop;
+            if (drop != removed.end() && *drop == contactId) {
+                ++drop;
+            } else {
+                *kept++ = contactId;
+            }
+        }
+        contactIds.erase(kept, contactIds.end());
+        std::vector<int>().swap(removed);
+    }
+    postings.touched.clear();
+}
+
+std::vector<int> LabelIndex::Lookup(const Postings &postings, const LabelDictionary &dictionary,
+                                    const std::string &label) {
+    LabelSet::Id id;
+    if (!dictionary.Find(label, id) || id >= postings.holders.size()) return {};
+    return postings.holders[id];
+}
+
+std::vector<int> LabelIndex::WithTag(const std::string &tag) const {
+    return Lookup(byTag_, LabelDictionary::Tags(), tag);
+}
+
+std::vector<int> LabelIndex::InGroup(const std::string &group) const {
+    return Lookup(byGroup_, LabelDictionary::Groups(), group);
+}
+
+std::vector<std::pair<std::string, size_t>> LabelIndex::Counts(const Postings &postings,
+                                                               const LabelDictionary &dictionary) {
+    std::vector<std::pair<std::string, size_t>> counts;
+    for (size_t id = 0; id < postings.holders.size(); ++id) {
+        if (!postings.holders[id].empty()) {
+            counts.emplace_back(dictionary.Name(static_cast<LabelSet::Id>(id)), postings.holders[id].size());
+        }
+    }
+    std::sort(counts.begin(), counts.end());
+    return counts;
+}
+
+std::vector<std::pair<std::string, size_t>> LabelIndex::TagCounts() const {
+    return Counts(byTag_, LabelDictionary::Tags());
+}
+
+std::vector<std::pair<std::string, size_t>> LabelIndex::GroupCounts() const {
+    return Counts(byGroup_, LabelDictionary::Groups());
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Contact.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+/****************************************************************
+ * CLASS: LabelIndex
+ * --------------------------------------------------------------
+ * Posting lists from tag / group ids to the contacts carrying
+ * them. Because LabelDictionary ids are dense, the lists sit in
+ * plain vectors indexed by id; no hashing and no string compares.
+ *
+ * RESPONSIBILITIES:
+ *   - Answer "who has tag X" / "who is in group Y" without a scan,
+ *     so filters and label-wide operations only touch the holders.
+ *   - Give per-label counts for reports straight from list sizes.
+ *   - Bulk mode (loads and bulk label edits): additions are
+ *     appended and removals deferred; EndBulkLoad() sorts and
+ *     prunes each touched list once, so editing k holders of a
+ *     label costs O(k log k) instead of k vector erases.
+ *     Queries are not valid between BeginBulkLoad and EndBulkLoad.
+ ***************************************************************/
+class LabelIndex {
+public:
+    void Add(const Contact &contact);
+    void Remove(const Contact &contact);
+    void Clear();
+    void BeginBulkLoad();
+    void EndBulkLoad();
+
+    /************************************************************
+     * WithTag / InGroup
+     * ----------------------------------------------------------
+     * RETURNS : (vector<int>) Ids of the contacts carrying the
+     *           label (exact, case-sensitive), ascending.
+     ***********************************************************/
+    std::vector<int> WithTag(const std::string &tag) const;
+    std::vector<int> InGroup(const std::string &group) const;
+
+    /************************************************************
+     * TagCounts / GroupCounts
+     * ----------------------------------------------------------
+     * RETURNS : (label, contact count) for every label in use,
+     *           ordered by label.
+     ***********************************************************/
+    std::vector<std::pair<std::string, size_t>> TagCounts() const;
+    std::vector<std::pair<std::string, size_t>> GroupCounts() const;
+
+private:
+    struct Postings {
+        std::vector<std::vector<int>> holders;   // label id -> contact ids, ascending
+        std::vector<std::vector<int>> removed;   // bulk mode: label id -> ids still to drop
+        std::vector<LabelSet::Id> touched;       // bulk mode: labels to sort / prune
+    };
+
+    void Insert(Postings &postings, LabelSet::Id label, int contactId);
+    void Erase(Postings &postings, LabelSet::Id label, int contactId);
+    static void Settle(Postings &postings);
+    static std::vector<int> Lookup(const Postings &postings, const LabelDictionary &dictionary,
+                                   const std::string &label);
+    static std::vector<std::pair<std::string, size_t>> Counts(const Postings &postings,
+                                                              const LabelDictionary &dictionary);
+
+    Postings byTag_;
+    Postings byGroup_;
+    bool bulkLoading_ {false};
+};
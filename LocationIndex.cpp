@@ -0,0 +1,169 @@
+//======================================================================
+// Implementation File: LocationIndex.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   State / city posting lists and a sorted ZIP array for regional
+//   filters.
+//======================================================================
+
+#include "LocationIndex.h"
+#include "TextUtils.h"
+#include <algorithm>
+#include <cctype>
+
+//**********************************************************************
+// Normalize (private static)
+//----------------------------------------------------------------------
+// PURPOSE : Trim surrounding whitespace and case-fold, so " Irvine"
+//           and "IRVINE" share one posting list.
+//**********************************************************************
+std::string LocationIndex::Normalize(const std::string &text) {
+    size_t first = 0;
+    size_t last = text.size();
+    while (first < last && std::isspace(static_cast<unsigned char>(text[first]))) ++first;
+    while (last > first && std::isspace(static_cast<unsigned char>(text[last - 1]))) --last;
+    return TextUtils::FoldCase(text.substr(first, last - first));
+}
+
+int LocationIndex::ParsePostal(const std::string &postalCode) {
+    int zip = 0;
+    int digits = 0;
+    for (char ch : postalCode) {
+        if (std::isspace(static_cast<unsigned char>(ch)) && digits == 0) continue;
+        if (ch < '0' || ch > '9') break;
+        zip = zip * 10 + (ch - '0');
+        if (++digits == 5) break;
+    }
+    return digits == 5 ? zip : -1;
+}
+
+void LocationIndex::Erase(std::vector<int> &ids, int contactId) {
+    ids.erase(std::remove(ids.begin(), ids.end(), contactId), ids.end());
+}
+
+std::vector<int> LocationIndex::Sorted(std::vector<int> ids) {
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+void LocationIndex::Add(const Contact &contact) {
+    Keys keys { Normalize(contact.getState()), Normalize(contact.getCity()),
+                ParsePostal(contact.getPostalCode()) };
+    const int id = contact.getId();
+
+    byState_[keys.state][keys.city].push_back(id);
+    if (!keys.city.empty()) byCity_[keys.city].push_back(id);
+    if (keys.postal >= 0) {
+        const std::pair<int, int> entry(keys.postal, id);
+        if (bulkLoading_) {
+            postal_.push_back(entry);
+        } else {
+            postal_.insert(std::lower_bound(postal_.begin(), postal_.end(), entry), entry);
+        }
+    }
+    keysById_[id] = std::move(keys);
+}
+
+void LocationIndex::Remove(const Contact &contact) {
+    auto stored = keysById_.find(contact.getId());
+    if (stored == keysById_.end()) return;
+
+    const int id = contact.getId();
+    const Keys &keys = stored->second;
+
+    auto state = byState_.find(keys.state);
+    if (state != byState_.end()) {
+        auto city = state->second.find(keys.city);
+        if (city != state->second.end()) {
+            Erase(city->second, id);
+            if (city->second.empty()) state->second.erase(city);
+        }
+        if (state->second.empty()) byState_.erase(state);
+    }
+
+    auto city = byCity_.find(keys.city);
+    if (city != byCity_.end()) {
+        Erase(city->second, id);
+        if (city->second.empty()) byCity_.erase(city);
+    }
+
+    if (keys.postal >= 0) {
+        auto entry = std::lower_bound(postal_.begin(), postal_.end(), std::make_pair(keys.postal, id));
+        if (entry != postal_.end() && entry->first == keys.postal && entry->second == id) {
+            postal_.erase(entry);
+        }
+    }
+    keysById_.erase(stored);
+}
+
+void LocationIndex::Clear() {
+    byState_.clear();
+    byCity_.clear();
+    postal_.clear();
+    keysById_.clear();
+}
+
+void LocationIndex::BeginBulkLoad() {
+    bulkLoading_ = true;
+}
+
+void LocationIndex::EndBulkLoad() {
+    bulkLoading_ = false;
+    std::sort(postal_.begin(), postal_.end());
+}
+
+std::vector<int> LocationIndex::ByState(const std::string &state) const {
+    std::vector<int> ids;
+    auto found = byState_.find(Normalize(state));
+    if (found == byState_.end()) return ids;
+    for (const auto &city : found->second) {
+        ids.insert(ids.end(), city.second.begin(), city.second.end());
+    }
+    return Sorted(std::move(ids));
+}
+
+std::vector<int> LocationIndex::ByStateCity(const std::string &state, const std::string &city) const {
+    auto foundState = byState_.find(Normalize(state));
+    if (foundState == byState_.end()) return std::vector<int>();
+    auto foundCity = foundState->second.find(Normalize(city));
+    if (foundCity == foundState->second.end()) return std::vector<int>();
+    return Sorted(foundCity->second);
+}
+
+std::vector<int> LocationIndex::ByCity(const std::string &city) const {
+    auto found = byCity_.find(Normalize(city));
+    return found == byCity_.end() ? std::vector<int>() : Sorted(found->second);
+}
+
+std::vector<int> LocationIndex::ByCityContaining(const std::string &fragment) const {
+    const std::string folded = TextUtils::FoldCase(fragment);
+    std::vector<int> ids;
+    for (const auto &city : byCity_) {
+        if (city.first.find(folded) != std::string::npos) {
+            ids.insert(ids.end(), city.second.begin(), city.second.end());
+        }
+    }
+    return Sorted(std::move(ids));
+}
+
+//**********************************************************************
+// ByPostalRange
+//----------------------------------------------------------------------
+// PURPOSE : lower_bound of (low, min id) and upper_bound of (high, max
+//           id) bracket the answer; the slice is copied out.
+//**********************************************************************
+std::vector<int> LocationIndex::ByPostalRange(int low, int high) const {
+    std::vector<int> ids;
+    if (low > high) return ids;
+    auto begin = std::lower_bound(postal_.begin(), postal_.end(), std::make_pair(low, 0),
+                                  [](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+                                      return a.first < b.first;
+                                  });
+    auto end = std::upper_bound(begin, postal_.end(), std::make_pair(high, 0),
+                                [](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+                                    return a.first < b.first;
+                                });
+    ids.reserve(static_cast<size_t>(end - begin));
+    for (auto it = begin; it != end; ++it) ids.push_back(it->second);
+    return Sorted(std::move(ids));
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Contact.h"
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/****************************************************************
+ * CLASS: LocationIndex
+ * --------------------------------------------------------------
+ * Hierarchical location index: state -> city -> contact ids, a
+ * flat city -> ids map for cross-state city lookups, and postal
+ * codes held as sorted integers for ZIP range queries.
+ *
+ *   | Structure     | Key                    | Serves              |
+ *   |---------------|------------------------|---------------------|
+ *   | byState_      | state, then city       | state / state+city  |
+ *   | byCity_       | city (any state)       | exact + substring   |
+ *   | postal_       | sorted (zip, id) array | "92600-92699" range |
+ *
+ * All text keys are case-folded and trimmed. Postal codes use
+ * their leading five digits ("92618-1234" -> 92618); codes that
+ * do not start with digits are not range-indexed.
+ ***************************************************************/
+class LocationIndex {
+public:
+    void Add(const Contact &contact);
+    void Remove(const Contact &contact);
+    void Clear();
+
+    void BeginBulkLoad();
+    void EndBulkLoad();
+
+    /************************************************************
+     * ByState / ByStateCity / ByCity
+     * ----------------------------------------------------------
+     * PURPOSE : Exact (case-insensitive) posting-list lookups.
+     * RETURNS : (vector<int>) Contact ids, ascending.
+     ***********************************************************/
+    std::vector<int> ByState(const std::string &state) const;
+    std::vector<int> ByStateCity(const std::string &state, const std::string &city) const;
+    std::vector<int> ByCity(const std::string &city) const;
+
+    /************************************************************
+     * ByCityContaining
+     * ----------------------------------------------------------
+     * PURPOSE : Substring match against the distinct city names,
+     *           returning the union of their postings. Cost scales
+     *           with the number of distinct cities, not contacts.
+     ***********************************************************/
+    std::vector<int> ByCityContaining(const std::string &fragment) const;
+
+    /************************************************************
+     * ByPostalRange
+     * ----------------------------------------------------------
+     * PURPOSE : Contacts whose 5-digit ZIP is in [low, high],
+     *           found with two binary searches.
+     ***********************************************************/
+    std::vector<int> ByPostalRange(int low, int high) const;
+
+    /************************************************************
+     * ParsePostal (static)
+     * ----------------------------------------------------------
+     * RETURNS : (int) Leading 5-digit ZIP, or -1 if not numeric.
+     ***********************************************************/
+    static int ParsePostal(const std::string &postalCode);
+
+private:
+    struct Keys {
+        std::string state;
+        std::string city;
+        int postal;
+    };
+
+    static std::string Normalize(const std::string &text);
+    static void Erase(std::vector<int> &ids, int contactId);
+    static std::vector<int> Sorted(std::vector<int> ids);
+
+    std::map<std::string, std::map<std::string, std::vector<int>>> byState_;
+    std::unordered_map<std::string, std::vector<int>> byCity_;
+    std::vector<std::pair<int, int>> postal_;   // (zip, id), sorted outside bulk mode
+    std::unordered_map<int, Keys> keysById_;
+    bool bulkLoading_ {false};
+};
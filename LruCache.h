@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/****************************************************************
+ * CLASS TEMPLATE: LruCache<Key, Value, Hash>
+ * --------------------------------------------------------------
+ * Least-recently-used cache bounded by a total cost (entries,
+ * bytes, ... — whatever the caller passes to Put). A hash map
+ * points into a recency list, so Get, Put and Erase are O(1).
+ *
+ * Not synchronized: callers that share one cache between threads
+ * wrap it in their own mutex (see RenderCache).
+ ***************************************************************/
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    typedef std::vector<std::pair<Key, Value>> Evicted;
+
+    explicit LruCache(size_t capacity) : capacity_(capacity) {}
+
+    /************************************************************
+     * Get
+     * ----------------------------------------------------------
+     * PURPOSE : Look up key and mark it most recently used.
+     * RETURNS : (Value*) nullptr on a miss. Valid until the next
+     *           Put / Erase / Clear.
+     ***********************************************************/
+    Value *Get(const Key &key) {
+        auto found = map_.find(key);
+        if (found == map_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+        ++hits_;
+        order_.splice(order_.begin(), order_, found->second);
+        return &found->second->value;
+    }
+
+    /************************************************************
+     * Put
+     * ----------------------------------------------------------
+     * PURPOSE : Insert or replace key, then evict least recently
+     *           used entries until the total cost fits. The new
+     *           entry itself is never evicted.
+     * PARAMS  : evicted (OUT, optional) - receives what was
+     *           pushed out, for callers that must act on it.
+     ***********************************************************/
+    void Put(const Key &key, Value value, size_t cost = 1, Evicted *evicted = nullptr) {
+        Erase(key);
+        order_.push_front(Node{key, std::move(value), cost});
+        map_[key] = order_.begin();
+        cost_ += cost;
+
+        while (cost_ > capacity_ && order_.size() > 1) {
+            Node &oldest = order_.back();
+            cost_ -= oldest.cost;
+            map_.erase(oldest.key);
+            if (evicted) evicted->emplace_back(std::move(oldest.key), std::move(oldest.value));
+            order_.pop_back();
+            ++evictions_;
+        }
+    }
+
+    bool Erase(const Key &key) {
+        auto found = map_.find(key);
+        if (found == map_.end()) return false;
+        cost_ -= found->second->cost;
+        order_.erase(found->second);
+        map_.erase(found);
+        return true;
+    }
+
+    void Clear() {
+        order_.clear();
+        map_.clear();
+        cost_ = 0;
+    }
+
+    size_t Size() const { return order_.size(); }
+    size_t Cost() const { return cost_; }
+    size_t Capacity() const { return capacity_; }
+    size_t Hits() const { return hits_; }
+    size_t Misses() const { return misses_; }
+    size_t Evictions() const { return evictions_; }
+
+private:
+    struct Node {
+        Key key;
+        Value value;
+        size_t cost;
+    };
+
+    std::list<Node> order_;      // front = most recently used
+    std::unordered_map<Key, typename std::list<Node>::iterator, Hash> map_;
+    size_t capacity_;
+    size_t cost_ {0};
+    size_t hits_ {0};
+    size_t misses_ {0};
+    size_t evictions_ {0};
+};
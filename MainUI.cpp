@@ -2,8 +2,10 @@
 #include "MainUI.h"
 #include <algorithm>
 #include <cctype>
+#include <iomanip>
 #include <iostream>
 #include <limits>
+#include <sstream>
 #include <string>
 
 using std::cin;
@@ -42,6 +44,80 @@ namespace
                                   lastNonSpaceIndex - firstNonSpaceIndex);
     }
 
+    // Parses "92600-92699" (or a single "92618") into inclusive bounds.
+    bool ParseZipRange(const string& text, int& lowZip, int& highZip)
+    {
+        try
+        {
+            size_t dash = text.find('-');
+            lowZip  = std::stoi(text.substr(0, dash));
+            highZip = (dash == string::npos) ? lowZip : std::stoi(text.substr(dash + 1));
+        }
+        catch (const std::exception&)
+        {
+            lowZip  = -1;
+            highZip = -1;
+            return false;
+        }
+        return lowZip >= 0 && highZip >= lowZip;
+    }
+
+    // Largest "low-high" span ParseIdList accepts in one range.
+    const long long MAX_ID_RANGE = 1000000;
+
+    // Parses "3, 7 10-20" (commas and/or spaces, inclusive ranges) into ids.
+    bool ParseIdList(const string& text, std::vector<int>& contactIds)
+    {
+        string token;
+        for (size_t position = 0; position <= text.size(); ++position)
+        {
+            if (position < text.size() && text[position] != ','
+                && !isspace(static_cast<unsigned char>(text[position])))
+            {
+                token += text[position];
+                continue;
+            }
+            if (token.empty())
+            {
+                continue;
+            }
+            long long lowId  = 0;
+            long long highId = 0;
+            try
+            {
+                size_t dash = token.find('-', 1);
+                lowId  = std::stoi(token.substr(0, dash));
+                highId = (dash == string::npos) ? lowId : std::stoi(token.substr(dash + 1));
+            }
+            catch (const std::exception&)
+            {
+                return false;
+            }
+            // Both ends fit an int, so their difference fits a long long.
+            if (highId < lowId || highId - lowId > MAX_ID_RANGE)
+            {
+                return false;
+            }
+            for (long long contactId = lowId; contactId <= highId; ++contactId)
+            {
+                contactIds.push_back(static_cast<int>(contactId));
+            }
+            token.clear();
+        }
+        return !contactIds.empty();
+    }
+
+    std::vector<int> IdsOf(const std::vector<Contact>& contacts)
+    {
+        std::vector<int> contactIds;
+        contactIds.reserve(contacts.size());
+        for (const Contact& contact : contacts)
+        {
+            contactIds.push_back(contact.getId());
+        }
+        return contactIds;
+    }
+
     bool IsBlank(const string& inputString)
     {
         for (char currentChar : inputString)
@@ -94,9 +170,14 @@ namespace UI
         const string MAIN_MENU_OPT_6_TAGS_GROUPS   = "6) Tags / Groups\n";
         const string MAIN_MENU_OPT_7_REPORTS       = "7) Reports\n";
         const string MAIN_MENU_OPT_8_SAVE          = "8) Save to File\n";
+        const string MAIN_MENU_OPT_9_DUPLICATES    = "9) Find / Merge Duplicates\n";
+        const string MAIN_MENU_OPT_10_SAVE_ASYNC   = "10) Save in Background\n";
+        const string MAIN_MENU_OPT_11_SHARDS       = "11) Shards\n";
+        const string MAIN_MENU_OPT_12_UNDO         = "12) Undo\n";
+        const string MAIN_MENU_OPT_13_REDO         = "13) Redo\n";
         const string MAIN_MENU_OPT_0_EXIT          = "0) Exit\n";
         const int    MAIN_MENU_MIN_OPTION          = 0;
-        const int    MAIN_MENU_MAX_OPTION          = 8;
+        const int    MAIN_MENU_MAX_OPTION          = 13;
 
         // Main Menu Choice Codes
         const int MAIN_CHOICE_EXIT          = 0;
@@ -108,19 +189,98 @@ namespace UI
         const int MAIN_CHOICE_TAGS_GROUPS   = 6;
         const int MAIN_CHOICE_REPORTS       = 7;
         const int MAIN_CHOICE_SAVE          = 8;
+        const int MAIN_CHOICE_DUPLICATES    = 9;
+        const int MAIN_CHOICE_SAVE_ASYNC    = 10;
+        const int MAIN_CHOICE_SHARDS        = 11;
+        const int MAIN_CHOICE_UNDO          = 12;
+        const int MAIN_CHOICE_REDO          = 13;
+
+        // Undo / Redo
+        const string MESSAGE_UNDONE         = "Undone: ";
+        const string MESSAGE_REDONE         = "Redone: ";
+        const string MESSAGE_NOTHING_UNDO   = "Nothing to undo.\n";
+        const string MESSAGE_NOTHING_REDO   = "Nothing to redo.\n";
+
+        // Background save status
+        const string MESSAGE_SAVE_STARTED       = "Background save started; you can keep working.\n";
+        const string MESSAGE_SAVE_BUSY          = "A background save is already running.\n";
+        const string MESSAGE_SAVE_WAITING       = "Waiting for the background save to finish...\n";
+        const string STATUS_SAVE_RUNNING        = "[Saving in background: ";
+        const string STATUS_SAVE_DONE           = "[Background save complete: ";
+        const string STATUS_SAVE_FAILED         = "[Background save FAILED: ";
+
+        // Duplicates
+        const string TITLE_DUPLICATES           = "\n=== Duplicate Candidates ===\n";
+        const string MESSAGE_NO_DUPLICATES      = "No likely duplicates found.\n";
+        const string MESSAGE_MERGE_SKIPPED      = "One of these contacts no longer exists; skipped.\n";
+        const string MESSAGE_MERGED             = "Merged.\n";
+        const string PROMPT_MERGE_PAIR          = "Merge the second contact into the first?";
+        const string PROMPT_CONTINUE_REVIEW     = "Review the next candidate?";
+        const double DUPLICATE_MIN_SCORE        = 0.70;
+
+        // Shards Menu
+        const string TITLE_SHARDS_MENU           = "\n=== Shards ===\n";
+        const string SHARDS_OPT_1_LIST           = "1) List Shards\n";
+        const string SHARDS_OPT_2_LOAD           = "2) Load Shard\n";
+        const string SHARDS_OPT_3_UNLOAD         = "3) Unload Shard\n";
+        const string SHARDS_OPT_4_ACTIVE         = "4) Set Shard for New Contacts\n";
+        const string SHARDS_OPT_0_BACK           = "0) Back\n";
+        const int    SHARDS_MIN_OPTION           = 0;
+        const int    SHARDS_MAX_OPTION           = 4;
+
+        // Shards Choice Codes
+        const int SHARDS_CHOICE_BACK   = 0;
+        const int SHARDS_CHOICE_LIST   = 1;
+        const int SHARDS_CHOICE_LOAD   = 2;
+        const int SHARDS_CHOICE_UNLOAD = 3;
+        const int SHARDS_CHOICE_ACTIVE = 4;
+
+        const string MESSAGE_NOT_SHARDED         = "Not a sharded book. Start with --shard-dir=DIR to use shards.\n";
+        const string PROMPT_SHARD_NAME           = "Shard file name: ";
+        const string PROMPT_SAVE_SHARD_FIRST     = "This shard has unsaved changes. Save it before unloading?";
+        const string MESSAGE_SHARD_LOAD_FAILED   = "Shard not found, already loaded, or unreadable.\n";
+        const string MESSAGE_SHARD_UNLOAD_FAILED = "Shard not loaded, or it receives new contacts (choose another first).\n";
+        const string MESSAGE_SHARD_UNLOADED      = "Shard unloaded.\n";
+        const string MESSAGE_SHARD_ACTIVE_FAILED = "Invalid name, or that shard is not loaded.\n";
+        const string MESSAGE_SHARD_ACTIVE_SET    = "New contacts will be added to that shard.\n";
 
         // View Menu
         const string TITLE_VIEW_MENU            = "\n=== View Contacts ===\n";
         const string VIEW_MENU_OPT_1_LIST_ALL   = "1) List All Contacts\n";
         const string VIEW_MENU_OPT_2_VIEW_BY_ID = "2) View Contact by ID\n";
+        const string VIEW_MENU_OPT_3_BROWSE     = "3) Browse Sorted (paged)\n";
+        const string VIEW_MENU_OPT_4_ORDER      = "4) Set Order for Search Results / Reports\n";
         const string VIEW_MENU_OPT_0_BACK       = "0) Back\n";
         const int    VIEW_MENU_MIN_OPTION       = 0;
-        const int    VIEW_MENU_MAX_OPTION       = 2;
+        const int    VIEW_MENU_MAX_OPTION       = 4;
 
         // View Menu Choice Codes
         const int VIEW_CHOICE_BACK      = 0;
         const int VIEW_CHOICE_LIST_ALL  = 1;
         const int VIEW_CHOICE_VIEW_BY_ID= 2;
+        const int VIEW_CHOICE_BROWSE    = 3;
+        const int VIEW_CHOICE_ORDER     = 4;
+
+        // Sort order picker
+        const string TITLE_SORT_FIELD          = "\nSort by:\n";
+        const string SORT_FIELD_OPT_1_LAST     = "1) Last Name\n";
+        const string SORT_FIELD_OPT_2_FIRST    = "2) First Name\n";
+        const string SORT_FIELD_OPT_3_CITY     = "3) City\n";
+        const string SORT_FIELD_OPT_4_TYPE     = "4) Type\n";
+        const string SORT_FIELD_OPT_5_ID       = "5) ID\n";
+        const string SORT_FIELD_OPT_0_NONE     = "0) No further key\n";
+        const int    SORT_FIELD_MAX_OPTION     = 5;
+        const string PROMPT_SORT_DESCENDING    = "Descending?";
+        const size_t SORT_MAX_KEYS             = 3;
+        const string MESSAGE_RESULT_ORDER_OFF  = "Results will be shown in the order found.\n";
+        const string MESSAGE_RESULT_ORDER_SET  = "Result order set.\n";
+
+        // Sorted browsing
+        const size_t BROWSE_PAGE_SIZE          = 20;
+        const string PROMPT_BROWSE_NAVIGATE    = "[n]ext, [p]revious, page number, or [q]uit: ";
+        const string TEXT_PAGE                 = "\n--- Page ";
+        const string TEXT_PAGE_OF              = " of ";
+        const string TEXT_PAGE_END             = " ---\n";
 
         // Search / Filter Menu
         const string TITLE_SEARCH_FILTER_MENU     = "\n=== Search / Filter ===\n";
@@ -130,9 +290,15 @@ namespace UI
         const string SEARCH_FILTER_OPT_4_BY_TYPE  = "4) Filter by Type\n";
         const string SEARCH_FILTER_OPT_5_BY_CITY  = "5) Filter by City\n";
         const string SEARCH_FILTER_OPT_6_BY_TAG   = "6) Filter by Tag\n";
+        const string SEARCH_FILTER_OPT_7_TYPEAHEAD = "7) Type-ahead Name Lookup\n";
+        const string SEARCH_FILTER_OPT_8_FUZZY    = "8) Fuzzy Name Search (typos)\n";
+        const string SEARCH_FILTER_OPT_9_SOUNDS_LIKE = "9) Name Sounds Like\n";
+        const string SEARCH_FILTER_OPT_10_REGION  = "10) Filter by Region (State / City / ZIP range)\n";
+        const string SEARCH_FILTER_OPT_11_RANKED  = "11) Ranked Search (best matches first)\n";
+        const string SEARCH_FILTER_OPT_12_TEXT    = "12) Full-Text Search (notes, address, name)\n";
         const string SEARCH_FILTER_OPT_0_BACK     = "0) Back\n";
         const int    SEARCH_FILTER_MIN_OPTION     = 0;
-        const int    SEARCH_FILTER_MAX_OPTION     = 6;
+        const int    SEARCH_FILTER_MAX_OPTION     = 12;
 
         // Search / Filter Choice Codes
         const int SEARCH_CHOICE_BACK     = 0;
@@ -142,21 +308,63 @@ namespace UI
         const int SEARCH_CHOICE_BY_TYPE  = 4;
         const int SEARCH_CHOICE_BY_CITY  = 5;
         const int SEARCH_CHOICE_BY_TAG   = 6;
+        const int SEARCH_CHOICE_TYPEAHEAD = 7;
+        const int SEARCH_CHOICE_FUZZY     = 8;
+        const int SEARCH_CHOICE_SOUNDS_LIKE = 9;
+        const int SEARCH_CHOICE_REGION    = 10;
+        const int SEARCH_CHOICE_RANKED    = 11;
+        const int SEARCH_CHOICE_TEXT      = 12;
+
+        // Region filter
+        const string PROMPT_REGION_STATE     = "State (blank = any): ";
+        const string PROMPT_REGION_CITY      = "City (blank = any): ";
+        const string PROMPT_REGION_ZIP_RANGE = "ZIP range, e.g. 92600-92699 (blank = any): ";
+        const string MESSAGE_INVALID_ZIP_RANGE = "ZIP range not understood; ignoring it.\n";
+
+        // Fuzzy search
+        const string PROMPT_NAME_APPROX          = "Name (approximate): ";
+        const string PROMPT_FUZZY_MAX_DISTANCE   = "Max typos allowed (0-3): ";
+        const int    FUZZY_MIN_DISTANCE          = 0;
+        const int    FUZZY_MAX_DISTANCE          = 3;
+        const size_t FUZZY_RESULT_LIMIT          = 10;
+
+        // Ranked search
+        const string PROMPT_RANKED_QUERY         = "Words to find (name, email, notes): ";
+        const size_t RANKED_RESULT_LIMIT         = 20;
+        const string TITLE_RANKED_RESULTS        = "BEST MATCHES: ";
+        const string MESSAGE_NO_RANKED_RESULTS   = "No contacts found matching search criteria\n";
+
+        // Full-text search
+        const string PROMPT_TEXT_QUERY           = "Words to find (all must appear; \"quote\" a phrase): ";
+
+        // Type-ahead
+        const string TITLE_TYPEAHEAD            = "\n=== Type-ahead Name Lookup ===\n";
+        const string TYPEAHEAD_INSTRUCTIONS     = "Type more letters to narrow, '<' to erase one, "
+                                                  "'#n' to view suggestion n, blank to finish.\n";
+        const string PROMPT_TYPEAHEAD_BEGIN     = "Name [";
+        const string PROMPT_TYPEAHEAD_END       = "]: ";
+        const string MESSAGE_NO_SUGGESTIONS     = "  (no suggestions)\n";
+        const string MESSAGE_INVALID_SUGGESTION = "No suggestion with that number.\n";
+        const size_t TYPEAHEAD_SUGGESTION_LIMIT = 5;
 
         // Reports Menu
         const string TITLE_REPORTS_MENU       = "\n=== Reports ===\n";
         const string REPORTS_OPT_1_MISSING    = "1) Missing Info\n";
         const string REPORTS_OPT_2_COUNTS     = "2) Counts by Type\n";
         const string REPORTS_OPT_3_GROUPS     = "3) Group Summary\n";
+        const string REPORTS_OPT_4_DOMAINS    = "4) Email Domains\n";
+        const string REPORTS_OPT_5_CACHE      = "5) Cache Statistics\n";
         const string REPORTS_OPT_0_BACK       = "0) Back\n";
         const int    REPORTS_MIN_OPTION       = 0;
-        const int    REPORTS_MAX_OPTION       = 3;
+        const int    REPORTS_MAX_OPTION       = 5;
 
         // Reports Choice Codes
         const int REPORTS_CHOICE_BACK      = 0;
         const int REPORTS_CHOICE_MISSING   = 1;
         const int REPORTS_CHOICE_COUNTS    = 2;
         const int REPORTS_CHOICE_GROUPS    = 3;
+        const int REPORTS_CHOICE_DOMAINS   = 4;
+        const int REPORTS_CHOICE_CACHE     = 5;
 
         // Tags / Groups Menu
         const string TITLE_TAGS_GROUPS_MENU         = "\n=== Tags / Groups ===\n";
@@ -164,9 +372,10 @@ namespace UI
         const string TAGS_GROUPS_OPT_2_REMOVE_TAG   = "2) Remove Tag from Contact\n";
         const string TAGS_GROUPS_OPT_3_ASSIGN_GROUP = "3) Assign to Group\n";
         const string TAGS_GROUPS_OPT_4_REMOVE_GROUP = "4) Remove from Group\n";
+        const string TAGS_GROUPS_OPT_5_BULK         = "5) Bulk Edit (ID list, search or filter)\n";
         const string TAGS_GROUPS_OPT_0_BACK         = "0) Back\n";
         const int    TAGS_GROUPS_MIN_OPTION         = 0;
-        const int    TAGS_GROUPS_MAX_OPTION         = 4;
+        const int    TAGS_GROUPS_MAX_OPTION         = 5;
 
         // Tags / Groups Choice Codes
         const int TAGS_GROUPS_CHOICE_BACK         = 0;
@@ -174,13 +383,72 @@ namespace UI
         const int TAGS_GROUPS_CHOICE_REMOVE_TAG   = 2;
         const int TAGS_GROUPS_CHOICE_ASSIGN_GROUP = 3;
         const int TAGS_GROUPS_CHOICE_REMOVE_GROUP = 4;
+        const int TAGS_GROUPS_CHOICE_BULK         = 5;
+
+        // Bulk Tag / Group Edit: what to change
+        const string TITLE_BULK_EDIT_MENU         = "\n=== Bulk Tag / Group Edit ===\n";
+        const string BULK_EDIT_OPT_1_APPLY_TAG    = "1) Apply Tag\n";
+        const string BULK_EDIT_OPT_2_REMOVE_TAG   = "2) Remove Tag\n";
+        const string BULK_EDIT_OPT_3_RENAME_TAG   = "3) Rename Tag\n";
+        const string BULK_EDIT_OPT_4_ASSIGN_GROUP = "4) Assign to Group\n";
+        const string BULK_EDIT_OPT_5_REMOVE_GROUP = "5) Remove from Group\n";
+        const string BULK_EDIT_OPT_6_RENAME_GROUP = "6) Rename Group\n";
+        const string BULK_EDIT_OPT_0_BACK         = "0) Back\n";
+        const int    BULK_EDIT_MIN_OPTION         = 0;
+        const int    BULK_EDIT_MAX_OPTION         = 6;
+
+        // Bulk Tag / Group Edit Choice Codes
+        const int BULK_EDIT_CHOICE_BACK         = 0;
+        const int BULK_EDIT_CHOICE_APPLY_TAG    = 1;
+        const int BULK_EDIT_CHOICE_REMOVE_TAG   = 2;
+        const int BULK_EDIT_CHOICE_RENAME_TAG   = 3;
+        const int BULK_EDIT_CHOICE_ASSIGN_GROUP = 4;
+        const int BULK_EDIT_CHOICE_REMOVE_GROUP = 5;
+        const int BULK_EDIT_CHOICE_RENAME_GROUP = 6;
+
+        // Bulk Tag / Group Edit: which contacts
+        const string TITLE_BULK_SELECT_MENU     = "\nWhich contacts?\n";
+        const string BULK_SELECT_OPT_1_IDS      = "1) ID List\n";
+        const string BULK_SELECT_OPT_2_NAME     = "2) Name Search\n";
+        const string BULK_SELECT_OPT_3_EMAIL    = "3) Email Search\n";
+        const string BULK_SELECT_OPT_4_PHONE    = "4) Phone Search\n";
+        const string BULK_SELECT_OPT_5_TYPE     = "5) Type Filter\n";
+        const string BULK_SELECT_OPT_6_CITY     = "6) City Filter\n";
+        const string BULK_SELECT_OPT_7_TAG      = "7) Tag Filter\n";
+        const string BULK_SELECT_OPT_8_GROUP    = "8) Group Filter\n";
+        const string BULK_SELECT_OPT_9_REGION   = "9) Region Filter (State / City / ZIP range)\n";
+        const string BULK_SELECT_OPT_10_ALL     = "10) All Contacts\n";
+        const int    BULK_SELECT_MIN_OPTION     = 1;
+        const int    BULK_SELECT_MAX_OPTION     = 10;
+
+        // Bulk Select Choice Codes
+        const int BULK_SELECT_CHOICE_IDS    = 1;
+        const int BULK_SELECT_CHOICE_NAME   = 2;
+        const int BULK_SELECT_CHOICE_EMAIL  = 3;
+        const int BULK_SELECT_CHOICE_PHONE  = 4;
+        const int BULK_SELECT_CHOICE_TYPE   = 5;
+        const int BULK_SELECT_CHOICE_CITY   = 6;
+        const int BULK_SELECT_CHOICE_TAG    = 7;
+        const int BULK_SELECT_CHOICE_GROUP  = 8;
+        const int BULK_SELECT_CHOICE_REGION = 9;
+        const int BULK_SELECT_CHOICE_ALL    = 10;
+
+        const string PROMPT_CONTACT_ID_LIST   = "Contact IDs (e.g. 3, 7, 10-20): ";
+        const string PROMPT_GROUP_VALUE       = "Group: ";
+        const string PROMPT_RENAME_TO         = "Rename to: ";
+        const string PROMPT_CONFIRM_BULK_EDIT = "Apply to the selected contacts?";
+        const string MESSAGE_INVALID_ID_LIST  = "ID list not understood.\n";
+        const string MESSAGE_NOTHING_SELECTED = "No contacts matched.\n";
+        const string MESSAGE_BULK_SELECTED    = " contact(s) selected.\n";
+        const string MESSAGE_BULK_CHANGED     = " contact(s) changed (one Undo reverts them all).\n";
 
         // Prompts
         const string PROMPT_ENTER_CONTACT_ID = "Enter Contact ID: ";
         const string PROMPT_NAME_CONTAINS    = "Name contains: ";
-        const string PROMPT_EMAIL_CONTAINS   = "Email contains: ";
-        const string PROMPT_PHONE_CONTAINS   = "Phone contains: ";
+        const string PROMPT_EMAIL_CONTAINS   = "Email contains (@domain or name@ for exact parts): ";
+        const string PROMPT_PHONE_CONTAINS   = "Phone digits (*1234 = ends with 1234): ";
         const string PROMPT_CITY_VALUE       = "City: ";
+        const string PROMPT_NAME_SOUNDS_LIKE = "Name as heard: ";
         const string PROMPT_TAG_VALUE        = "Tag: ";
         const string PROMPT_TAG_TO_ADD       = "Tag to add: ";
         const string PROMPT_TAG_TO_REMOVE    = "Tag to remove: ";
@@ -402,7 +670,101 @@ namespace UI
     // SUBMENU: VIEW
     // =====================================================================================
 
-    void ShowViewMenu(const AddressBook& addressBook)
+    // Asks for one sort field and direction; false if the user picked none
+    // (only offered when allowNone is set).
+    bool PromptSortKey(AddressBook::SortKey& key, bool allowNone)
+    {
+        cout << TITLE_SORT_FIELD
+             << SORT_FIELD_OPT_1_LAST
+             << SORT_FIELD_OPT_2_FIRST
+             << SORT_FIELD_OPT_3_CITY
+             << SORT_FIELD_OPT_4_TYPE
+             << SORT_FIELD_OPT_5_ID;
+        if (allowNone)
+        {
+            cout << SORT_FIELD_OPT_0_NONE;
+        }
+
+        int choice = ReadIntegerInRange(PROMPT_INPUT_ARROW, allowNone ? 0 : 1, SORT_FIELD_MAX_OPTION);
+        switch (choice)
+        {
+            case 1:  key.field = AddressBook::SortField::LastName;  break;
+            case 2:  key.field = AddressBook::SortField::FirstName; break;
+            case 3:  key.field = AddressBook::SortField::City;      break;
+            case 4:  key.field = AddressBook::SortField::Type;      break;
+            case 5:  key.field = AddressBook::SortField::Id;        break;
+            default: return false;
+        }
+        key.descending = ConfirmYesNo(PROMPT_SORT_DESCENDING);
+        return true;
+    }
+
+    void BrowseSorted(const AddressBook& addressBook)
+    {
+        AddressBook::SortKey order;
+        PromptSortKey(order, false);
+
+        const size_t total = addressBook.ContactCount();
+        const size_t pages = std::max<size_t>(1, (total + BROWSE_PAGE_SIZE - 1) / BROWSE_PAGE_SIZE);
+        size_t page = 0;
+        bool continueLoop = true;
+
+        while (continueLoop)
+        {
+            cout << TEXT_PAGE << (page + 1) << TEXT_PAGE_OF << pages << TEXT_PAGE_END;
+            for (const Contact& contact : addressBook.ListSorted(order, page * BROWSE_PAGE_SIZE, BROWSE_PAGE_SIZE))
+            {
+                cout << "ID: " << contact.getId()
+                     << " | Name: " << contact.getFullName()
+                     << " | City: " << contact.getCity()
+                     << " | Type: " << Contact::contactTypeToString(contact.getType())
+                     << "\n";
+            }
+
+            string input = Trim(ReadLine(PROMPT_BROWSE_NAVIGATE));
+            if (!cin || input == "q" || input == "Q")
+            {
+                continueLoop = false;
+            }
+            else if (input.empty() || input == "n" || input == "N")
+            {
+                page = std::min(page + 1, pages - 1);
+            }
+            else if (input == "p" || input == "P")
+            {
+                page = (page == 0) ? 0 : page - 1;
+            }
+            else
+            {
+                try
+                {
+                    size_t requested = static_cast<size_t>(std::stoul(input));
+                    if (requested >= 1 && requested <= pages)
+                    {
+                        page = requested - 1;
+                    }
+                }
+                catch (const std::exception&)
+                {
+                    cout << MESSAGE_INVALID_CHOICE;
+                }
+            }
+        }
+    }
+
+    void ChooseResultOrder(AddressBook& addressBook)
+    {
+        std::vector<AddressBook::SortKey> keys;
+        AddressBook::SortKey key;
+        while (keys.size() < SORT_MAX_KEYS && PromptSortKey(key, true))
+        {
+            keys.push_back(key);
+        }
+        addressBook.SetResultOrder(keys);
+        cout << (keys.empty() ? MESSAGE_RESULT_ORDER_OFF : MESSAGE_RESULT_ORDER_SET);
+    }
+
+    void ShowViewMenu(AddressBook& addressBook)
     {
         bool continueLoop   = true;
         int  selectedOption = 0;
@@ -412,6 +774,8 @@ namespace UI
             cout << TITLE_VIEW_MENU
                  << VIEW_MENU_OPT_1_LIST_ALL
                  << VIEW_MENU_OPT_2_VIEW_BY_ID
+                 << VIEW_MENU_OPT_3_BROWSE
+                 << VIEW_MENU_OPT_4_ORDER
                  << VIEW_MENU_OPT_0_BACK;
 
             selectedOption = ReadIntegerInRange(PROMPT_INPUT_ARROW,
@@ -438,6 +802,15 @@ namespace UI
 
                 PauseForUser();
             }
+            else if (selectedOption == VIEW_CHOICE_BROWSE)
+            {
+                BrowseSorted(addressBook);
+            }
+            else if (selectedOption == VIEW_CHOICE_ORDER)
+            {
+                ChooseResultOrder(addressBook);
+                PauseForUser();
+            }
         }
     }
 
@@ -445,6 +818,99 @@ namespace UI
     // SUBMENU: SEARCH / FILTER
     // =====================================================================================
 
+    void RunTypeAheadLookup(const AddressBook& addressBook)
+    {
+        bool   continueLoop = true;
+        string prefix;
+        std::vector<Contact> suggestions;
+
+        cout << TITLE_TYPEAHEAD << TYPEAHEAD_INSTRUCTIONS;
+
+        while (continueLoop)
+        {
+            // Refresh suggestions for the text typed so far
+            suggestions = addressBook.SuggestByPrefix(prefix, TYPEAHEAD_SUGGESTION_LIMIT);
+            if (suggestions.empty())
+            {
+                cout << MESSAGE_NO_SUGGESTIONS;
+            }
+            for (size_t i = 0; i < suggestions.size(); ++i)
+            {
+                cout << "  #" << (i + 1) << " " << suggestions[i].getFullName()
+                     << " <" << suggestions[i].getEmail() << ">"
+                     << " (ID " << suggestions[i].getId() << ")\n";
+            }
+
+            string input = ReadLine(PROMPT_TYPEAHEAD_BEGIN + prefix + PROMPT_TYPEAHEAD_END);
+
+            if (IsBlank(input))
+            {
+                continueLoop = false;
+            }
+            else if (input == "<")
+            {
+                if (!prefix.empty())
+                {
+                    prefix.pop_back();
+                }
+            }
+            else if (input[0] == '#')
+            {
+                size_t choice = 0;
+                try
+                {
+                    choice = static_cast<size_t>(std::stoul(input.substr(1)));
+                }
+                catch (const std::exception&)
+                {
+                    choice = 0;
+                }
+
+                if (choice >= 1 && choice <= suggestions.size())
+                {
+                    addressBook.ViewContact(suggestions[choice - 1].getId());
+                    PauseForUser();
+                }
+                else
+                {
+                    cout << MESSAGE_INVALID_SUGGESTION;
+                }
+            }
+            else
+            {
+                prefix += input;
+            }
+        }
+    }
+
+    void RunRankedSearch(const AddressBook& addressBook)
+    {
+        string query = ReadNonEmptyLine(PROMPT_RANKED_QUERY);
+        std::vector<AddressBook::RankedMatch> matches = addressBook.SearchRanked(query, RANKED_RESULT_LIMIT);
+
+        cout << "\n" << string(50, '=') << "\n"
+             << TITLE_RANKED_RESULTS << "'" << query << "' (top " << RANKED_RESULT_LIMIT << ")\n"
+             << string(50, '=') << "\n";
+        if (matches.empty())
+        {
+            cout << MESSAGE_NO_RANKED_RESULTS;
+            return;
+        }
+
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1);
+        for (size_t rank = 0; rank < matches.size(); ++rank)
+        {
+            const Contact& contact = matches[rank].contact;
+            line.str("");
+            line << std::setw(3) << (rank + 1) << ". [" << std::setw(5) << matches[rank].score << "] "
+                 << "ID: " << contact.getId()
+                 << " | Name: " << contact.getFullName()
+                 << " | Email: " << contact.getEmail();
+            cout << line.str() << "\n";
+        }
+    }
+
     void ShowSearchFilterMenu(const AddressBook& addressBook)
     {
         bool   continueLoop   = true;
@@ -460,6 +926,12 @@ namespace UI
                  << SEARCH_FILTER_OPT_4_BY_TYPE
                  << SEARCH_FILTER_OPT_5_BY_CITY
                  << SEARCH_FILTER_OPT_6_BY_TAG
+                 << SEARCH_FILTER_OPT_7_TYPEAHEAD
+                 << SEARCH_FILTER_OPT_8_FUZZY
+                 << SEARCH_FILTER_OPT_9_SOUNDS_LIKE
+                 << SEARCH_FILTER_OPT_10_REGION
+                 << SEARCH_FILTER_OPT_11_RANKED
+                 << SEARCH_FILTER_OPT_12_TEXT
                  << SEARCH_FILTER_OPT_0_BACK;
 
             selectedOption = ReadIntegerInRange(PROMPT_INPUT_ARROW,
@@ -488,7 +960,7 @@ namespace UI
             {
                 query = ReadNonEmptyLine(PROMPT_PHONE_CONTAINS);
                 std::vector<Contact> results = addressBook.SearchByPhone(query);
-                addressBook.DisplaySearchResults(results, "Phone contains '" + query + "'");
+                addressBook.DisplaySearchResults(results, "Phone matches '" + query + "'");
                 PauseForUser();
             }
             else if (selectedOption == SEARCH_CHOICE_BY_TYPE)
@@ -512,6 +984,59 @@ namespace UI
                 addressBook.DisplaySearchResults(results, "Tag = '" + query + "'");
                 PauseForUser();
             }
+            else if (selectedOption == SEARCH_CHOICE_TYPEAHEAD)
+            {
+                RunTypeAheadLookup(addressBook);
+            }
+            else if (selectedOption == SEARCH_CHOICE_FUZZY)
+            {
+                query = ReadNonEmptyLine(PROMPT_NAME_APPROX);
+                int maxDistance = ReadIntegerInRange(PROMPT_FUZZY_MAX_DISTANCE,
+                                                     FUZZY_MIN_DISTANCE,
+                                                     FUZZY_MAX_DISTANCE);
+                std::vector<Contact> results = addressBook.SearchByNameFuzzy(query, maxDistance,
+                                                                             FUZZY_RESULT_LIMIT);
+                addressBook.DisplaySearchResults(results, "Name ~ '" + query + "' (within "
+                                                 + std::to_string(maxDistance) + " edits)");
+                PauseForUser();
+            }
+            else if (selectedOption == SEARCH_CHOICE_SOUNDS_LIKE)
+            {
+                query = ReadNonEmptyLine(PROMPT_NAME_SOUNDS_LIKE);
+                std::vector<Contact> results = addressBook.SearchBySoundsLike(query);
+                addressBook.DisplaySearchResults(results, "Name sounds like '" + query + "'");
+                PauseForUser();
+            }
+            else if (selectedOption == SEARCH_CHOICE_REGION)
+            {
+                string state    = Trim(ReadLine(PROMPT_REGION_STATE));
+                string city     = Trim(ReadLine(PROMPT_REGION_CITY));
+                string zipRange = Trim(ReadLine(PROMPT_REGION_ZIP_RANGE));
+                int    lowZip   = -1;
+                int    highZip  = -1;
+
+                if (!zipRange.empty() && !ParseZipRange(zipRange, lowZip, highZip))
+                {
+                    cout << MESSAGE_INVALID_ZIP_RANGE;
+                }
+
+                std::vector<Contact> results = addressBook.FilterByRegion(state, city, lowZip, highZip);
+                addressBook.DisplaySearchResults(results, "Region state='" + state + "' city='" + city
+                                                 + "' zip='" + zipRange + "'");
+                PauseForUser();
+            }
+            else if (selectedOption == SEARCH_CHOICE_RANKED)
+            {
+                RunRankedSearch(addressBook);
+                PauseForUser();
+            }
+            else if (selectedOption == SEARCH_CHOICE_TEXT)
+            {
+                query = ReadNonEmptyLine(PROMPT_TEXT_QUERY);
+                std::vector<Contact> results = addressBook.SearchText(query);
+                addressBook.DisplaySearchResults(results, "Text matches: " + query);
+                PauseForUser();
+            }
         }
     }
 
@@ -530,6 +1055,8 @@ namespace UI
                  << REPORTS_OPT_1_MISSING
                  << REPORTS_OPT_2_COUNTS
                  << REPORTS_OPT_3_GROUPS
+                 << REPORTS_OPT_4_DOMAINS
+                 << REPORTS_OPT_5_CACHE
                  << REPORTS_OPT_0_BACK;
 
             selectedOption = ReadIntegerInRange(PROMPT_INPUT_ARROW,
@@ -555,6 +1082,16 @@ namespace UI
                 addressBook.ReportGroupSummary();
                 PauseForUser();
             }
+            else if (selectedOption == REPORTS_CHOICE_DOMAINS)
+            {
+                addressBook.ReportEmailDomains();
+                PauseForUser();
+            }
+            else if (selectedOption == REPORTS_CHOICE_CACHE)
+            {
+                addressBook.ReportCacheStats();
+                PauseForUser();
+            }
         }
     }
 
@@ -562,6 +1099,147 @@ namespace UI
     // SUBMENU: TAGS / GROUPS
     // =====================================================================================
 
+    // Picks the contacts for a bulk edit; false if the user got none.
+    bool SelectBulkContacts(const AddressBook& addressBook, std::vector<int>& contactIds, bool& everyone)
+    {
+        cout << TITLE_BULK_SELECT_MENU
+             << BULK_SELECT_OPT_1_IDS
+             << BULK_SELECT_OPT_2_NAME
+             << BULK_SELECT_OPT_3_EMAIL
+             << BULK_SELECT_OPT_4_PHONE
+             << BULK_SELECT_OPT_5_TYPE
+             << BULK_SELECT_OPT_6_CITY
+             << BULK_SELECT_OPT_7_TAG
+             << BULK_SELECT_OPT_8_GROUP
+             << BULK_SELECT_OPT_9_REGION
+             << BULK_SELECT_OPT_10_ALL;
+
+        int selectedOption = ReadIntegerInRange(PROMPT_INPUT_ARROW,
+                                                BULK_SELECT_MIN_OPTION,
+                                                BULK_SELECT_MAX_OPTION);
+        everyone = false;
+
+        if (selectedOption == BULK_SELECT_CHOICE_IDS)
+        {
+            if (!ParseIdList(ReadNonEmptyLine(PROMPT_CONTACT_ID_LIST), contactIds))
+            {
+                cout << MESSAGE_INVALID_ID_LIST;
+                return false;
+            }
+            return true;
+        }
+        else if (selectedOption == BULK_SELECT_CHOICE_NAME)
+        {
+            contactIds = IdsOf(addressBook.SearchByName(ReadNonEmptyLine(PROMPT_NAME_CONTAINS)));
+        }
+        else if (selectedOption == BULK_SELECT_CHOICE_EMAIL)
+        {
+            contactIds = IdsOf(addressBook.SearchByEmail(ReadNonEmptyLine(PROMPT_EMAIL_CONTAINS)));
+        }
+        else if (selectedOption == BULK_SELECT_CHOICE_PHONE)
+        {
+            contactIds = IdsOf(addressBook.SearchByPhone(ReadNonEmptyLine(PROMPT_PHONE_CONTAINS)));
+        }
+        else if (selectedOption == BULK_SELECT_CHOICE_TYPE)
+        {
+            contactIds = IdsOf(addressBook.FilterByType(PromptContactType()));
+        }
+        else if (selectedOption == BULK_SELECT_CHOICE_CITY)
+        {
+            contactIds = IdsOf(addressBook.FilterByCity(ReadNonEmptyLine(PROMPT_CITY_VALUE)));
+        }
+        else if (selectedOption == BULK_SELECT_CHOICE_TAG)
+        {
+            contactIds = IdsOf(addressBook.FilterByTag(ReadNonEmptyLine(PROMPT_TAG_VALUE)));
+        }
+        else if (selectedOption == BULK_SELECT_CHOICE_GROUP)
+        {
+            contactIds = IdsOf(addressBook.FilterByGroup(ReadNonEmptyLine(PROMPT_GROUP_VALUE)));
+        }
+        else if (selectedOption == BULK_SELECT_CHOICE_REGION)
+        {
+            string state    = Trim(ReadLine(PROMPT_REGION_STATE));
+            string city     = Trim(ReadLine(PROMPT_REGION_CITY));
+            string zipRange = Trim(ReadLine(PROMPT_REGION_ZIP_RANGE));
+            int    lowZip   = -1;
+            int    highZip  = -1;
+
+            if (!zipRange.empty() && !ParseZipRange(zipRange, lowZip, highZip))
+            {
+                cout << MESSAGE_INVALID_ZIP_RANGE;
+            }
+            contactIds = IdsOf(addressBook.FilterByRegion(state, city, lowZip, highZip));
+        }
+        else
+        {
+            // Remove / Rename over everyone only visit the label's holders
+            everyone = true;
+            return true;
+        }
+
+        if (contactIds.empty())
+        {
+            cout << MESSAGE_NOTHING_SELECTED;
+            return false;
+        }
+        cout << contactIds.size() << MESSAGE_BULK_SELECTED;
+        return true;
+    }
+
+    void RunBulkLabelEdit(AddressBook& addressBook)
+    {
+        typedef AddressBook::LabelEdit::Action Action;
+
+        cout << TITLE_BULK_EDIT_MENU
+             << BULK_EDIT_OPT_1_APPLY_TAG
+             << BULK_EDIT_OPT_2_REMOVE_TAG
+             << BULK_EDIT_OPT_3_RENAME_TAG
+             << BULK_EDIT_OPT_4_ASSIGN_GROUP
+             << BULK_EDIT_OPT_5_REMOVE_GROUP
+             << BULK_EDIT_OPT_6_RENAME_GROUP
+             << BULK_EDIT_OPT_0_BACK;
+
+        int selectedOption = ReadIntegerInRange(PROMPT_INPUT_ARROW,
+                                                BULK_EDIT_MIN_OPTION,
+                                                BULK_EDIT_MAX_OPTION);
+        if (selectedOption == BULK_EDIT_CHOICE_BACK)
+        {
+            return;
+        }
+
+        AddressBook::LabelEdit edit;
+        edit.group = selectedOption >= BULK_EDIT_CHOICE_ASSIGN_GROUP;
+        if (selectedOption == BULK_EDIT_CHOICE_APPLY_TAG || selectedOption == BULK_EDIT_CHOICE_ASSIGN_GROUP)
+        {
+            edit.action = Action::Apply;
+        }
+        else if (selectedOption == BULK_EDIT_CHOICE_REMOVE_TAG || selectedOption == BULK_EDIT_CHOICE_REMOVE_GROUP)
+        {
+            edit.action = Action::Remove;
+        }
+        else
+        {
+            edit.action = Action::Rename;
+        }
+
+        edit.label = ReadNonEmptyLine(edit.group ? PROMPT_GROUP_VALUE : PROMPT_TAG_VALUE);
+        if (edit.action == Action::Rename)
+        {
+            edit.newLabel = ReadNonEmptyLine(PROMPT_RENAME_TO);
+        }
+
+        std::vector<int> contactIds;
+        bool everyone = false;
+        if (SelectBulkContacts(addressBook, contactIds, everyone) &&
+            ConfirmYesNo(PROMPT_CONFIRM_BULK_EDIT))
+        {
+            size_t changed = everyone ? addressBook.EditLabelsForAll(edit)
+                                      : addressBook.EditLabels(contactIds, edit);
+            cout << changed << MESSAGE_BULK_CHANGED;
+        }
+        PauseForUser();
+    }
+
     void ShowTagsGroupsMenu(AddressBook& addressBook)
     {
         bool   continueLoop   = true;
@@ -576,6 +1254,7 @@ namespace UI
                  << TAGS_GROUPS_OPT_2_REMOVE_TAG
                  << TAGS_GROUPS_OPT_3_ASSIGN_GROUP
                  << TAGS_GROUPS_OPT_4_REMOVE_GROUP
+                 << TAGS_GROUPS_OPT_5_BULK
                  << TAGS_GROUPS_OPT_0_BACK;
 
             selectedOption = ReadIntegerInRange(PROMPT_INPUT_ARROW,
@@ -586,6 +1265,10 @@ namespace UI
             {
                 continueLoop = false;
             }
+            else if (selectedOption == TAGS_GROUPS_CHOICE_BULK)
+            {
+                RunBulkLabelEdit(addressBook);
+            }
             else
             {
                 contactId = PromptContactId(PROMPT_ENTER_CONTACT_ID);
@@ -632,6 +1315,161 @@ namespace UI
         }
     }
 
+    // =====================================================================================
+    // DUPLICATE REVIEW
+    // =====================================================================================
+
+    void ShowDuplicatesReview(AddressBook& addressBook)
+    {
+        cout << TITLE_DUPLICATES;
+
+        std::vector<DuplicateFinder::MergeProposal> proposals =
+            addressBook.FindDuplicates(DUPLICATE_MIN_SCORE);
+
+        if (proposals.empty())
+        {
+            cout << MESSAGE_NO_DUPLICATES;
+            return;
+        }
+
+        cout << "Found " << proposals.size() << " candidate pair(s).\n";
+
+        bool continueReview = true;
+        for (size_t i = 0; i < proposals.size() && continueReview; ++i)
+        {
+            const DuplicateFinder::MergeProposal& proposal = proposals[i];
+
+            cout << "\nCandidate " << (i + 1) << " of " << proposals.size()
+                 << " | score " << static_cast<int>(proposal.score * 100) << "%"
+                 << " | matched: " << proposal.reasons << "\n";
+
+            // An earlier merge in this session may have removed one side
+            if (!addressBook.ViewContact(proposal.survivorId) ||
+                !addressBook.ViewContact(proposal.duplicateId))
+            {
+                cout << MESSAGE_MERGE_SKIPPED;
+                continue;
+            }
+
+            if (ConfirmYesNo(PROMPT_MERGE_PAIR))
+            {
+                if (addressBook.MergeContacts(proposal.survivorId, proposal.duplicateId))
+                {
+                    cout << MESSAGE_MERGED;
+                }
+            }
+
+            if (i + 1 < proposals.size())
+            {
+                continueReview = ConfirmYesNo(PROMPT_CONTINUE_REVIEW);
+            }
+        }
+    }
+
+    // =====================================================================================
+    // SUBMENU: SHARDS
+    // =====================================================================================
+
+    void ShowShardsMenu(AddressBook& addressBook)
+    {
+        if (!addressBook.IsSharded())
+        {
+            cout << MESSAGE_NOT_SHARDED;
+            PauseForUser();
+            return;
+        }
+
+        bool   continueLoop   = true;
+        int    selectedOption = 0;
+        string shardName;
+
+        while (continueLoop)
+        {
+            cout << TITLE_SHARDS_MENU
+                 << SHARDS_OPT_1_LIST
+                 << SHARDS_OPT_2_LOAD
+                 << SHARDS_OPT_3_UNLOAD
+                 << SHARDS_OPT_4_ACTIVE
+                 << SHARDS_OPT_0_BACK;
+
+            selectedOption = ReadIntegerInRange(PROMPT_INPUT_ARROW,
+                                                SHARDS_MIN_OPTION,
+                                                SHARDS_MAX_OPTION);
+
+            if (selectedOption == SHARDS_CHOICE_BACK)
+            {
+                continueLoop = false;
+                continue;
+            }
+
+            if (selectedOption == SHARDS_CHOICE_LIST)
+            {
+                for (const auto& shard : addressBook.ListShards())
+                {
+                    cout << shard.name << " | "
+                         << (shard.loaded ? std::to_string(shard.contacts) + " contacts" : "not loaded")
+                         << (shard.dirty ? " | unsaved changes" : "") << "\n";
+                }
+            }
+            else if (selectedOption == SHARDS_CHOICE_LOAD)
+            {
+                shardName = ReadNonEmptyLine(PROMPT_SHARD_NAME);
+                if (!addressBook.LoadShard(shardName))
+                {
+                    cout << MESSAGE_SHARD_LOAD_FAILED;
+                }
+            }
+            else if (selectedOption == SHARDS_CHOICE_UNLOAD)
+            {
+                shardName = ReadNonEmptyLine(PROMPT_SHARD_NAME);
+                bool saveFirst = false;
+                for (const auto& shard : addressBook.ListShards())
+                {
+                    if (shard.name == shardName && shard.loaded && shard.dirty)
+                    {
+                        saveFirst = ConfirmYesNo(PROMPT_SAVE_SHARD_FIRST);
+                    }
+                }
+                cout << (addressBook.UnloadShard(shardName, saveFirst) ? MESSAGE_SHARD_UNLOADED
+                                                                       : MESSAGE_SHARD_UNLOAD_FAILED);
+            }
+            else if (selectedOption == SHARDS_CHOICE_ACTIVE)
+            {
+                shardName = ReadNonEmptyLine(PROMPT_SHARD_NAME);
+                cout << (addressBook.SetActiveShard(shardName) ? MESSAGE_SHARD_ACTIVE_SET
+                                                               : MESSAGE_SHARD_ACTIVE_FAILED);
+            }
+
+            PauseForUser();
+        }
+    }
+
+    // =====================================================================================
+    // BACKGROUND SAVE STATUS
+    // =====================================================================================
+
+    void ShowSaveStatus(AddressBook& addressBook)
+    {
+        const SnapshotWriter::Status status = addressBook.GetSaveStatus();
+
+        if (status.state == SnapshotWriter::State::Running)
+        {
+            cout << "\n" << STATUS_SAVE_RUNNING << status.written << " / " << status.total
+                 << " contacts]\n";
+        }
+        else if (status.state == SnapshotWriter::State::Succeeded)
+        {
+            cout << "\n" << STATUS_SAVE_DONE << status.total << " contacts -> "
+                 << status.message << "]\n";
+            addressBook.AcknowledgeSaveStatus();
+        }
+        else if (status.state == SnapshotWriter::State::Failed)
+        {
+            cout << "\n" << STATUS_SAVE_FAILED << status.message << "]\n";
+            addressBook.AcknowledgeSaveStatus();
+        }
+    }
+
     // =====================================================================================
     // MAIN UI LOOP
     // =====================================================================================
@@ -647,6 +1485,8 @@ namespace UI
 
         while (continueLoop)
         {
+            ShowSaveStatus(addressBook);
+
             cout << TITLE_MAIN_MENU
                  << MAIN_MENU_OPT_1_ADD
                  << MAIN_MENU_OPT_2_EDIT
@@ -656,6 +1496,11 @@ namespace UI
                  << MAIN_MENU_OPT_6_TAGS_GROUPS
                  << MAIN_MENU_OPT_7_REPORTS
                  << MAIN_MENU_OPT_8_SAVE
+                 << MAIN_MENU_OPT_9_DUPLICATES
+                 << MAIN_MENU_OPT_10_SAVE_ASYNC
+                 << MAIN_MENU_OPT_11_SHARDS
+                 << MAIN_MENU_OPT_12_UNDO
+                 << MAIN_MENU_OPT_13_REDO
                  << MAIN_MENU_OPT_0_EXIT;
 
             selectedOption = ReadIntegerInRange(PROMPT_INPUT_ARROW,
@@ -668,6 +1513,12 @@ namespace UI
                 {
                     addressBook.SaveToFile();
                 }
+                else if (addressBook.GetSaveStatus().state == SnapshotWriter::State::Running)
+                {
+                    cout << MESSAGE_SAVE_WAITING;
+                    addressBook.WaitForSave();
+                    ShowSaveStatus(addressBook);
+                }
 
                 cout << MESSAGE_GOODBYE;
                 continueLoop = false;
@@ -719,6 +1570,33 @@ namespace UI
                 addressBook.SaveToFile();
                 PauseForUser();
             }
+            else if (selectedOption == MAIN_CHOICE_DUPLICATES)
+            {
+                ShowDuplicatesReview(addressBook);
+                PauseForUser();
+            }
+            else if (selectedOption == MAIN_CHOICE_SAVE_ASYNC)
+            {
+                cout << (addressBook.SaveToFileAsync() ? MESSAGE_SAVE_STARTED : MESSAGE_SAVE_BUSY);
+                PauseForUser();
+            }
+            else if (selectedOption == MAIN_CHOICE_SHARDS)
+            {
+                ShowShardsMenu(addressBook);
+            }
+            else if (selectedOption == MAIN_CHOICE_UNDO || selectedOption == MAIN_CHOICE_REDO)
+            {
+                string label;
+                if (selectedOption == MAIN_CHOICE_UNDO)
+                {
+                    cout << (addressBook.Undo(label) ? MESSAGE_UNDONE + label + "\n" : MESSAGE_NOTHING_UNDO);
+                }
+                else
+                {
+                    cout << (addressBook.Redo(label) ? MESSAGE_REDONE + label + "\n" : MESSAGE_NOTHING_REDO);
+                }
+                PauseForUser();
+            }
             else
             {
                 cout << MESSAGE_INVALID_CHOICE;
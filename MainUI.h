@@ -68,26 +68,84 @@ namespace UI
     //======================================================================================
 
     /***************************************************************************************
-    * Displays the "View" submenu (list all contacts or view specific ID).
+    * Prompts for a sort field and direction. Returns false if the user chose "none"
+    * (offered only when allowNone is true).
     ***************************************************************************************/
-    void ShowViewMenu(const AddressBook& addressBook);
+    bool PromptSortKey(AddressBook::SortKey& key, bool allowNone);
+
+    /***************************************************************************************
+    * Pages through the whole book in a chosen sort order.
+    ***************************************************************************************/
+    void BrowseSorted(const AddressBook& addressBook);
+
+    /***************************************************************************************
+    * Sets the (up to three key) order used for search results and reports.
+    ***************************************************************************************/
+    void ChooseResultOrder(AddressBook& addressBook);
+
+    /***************************************************************************************
+    * Displays the "View" submenu (list all, view by ID, sorted browsing, result order).
+    ***************************************************************************************/
+    void ShowViewMenu(AddressBook& addressBook);
 
     /***************************************************************************************
     * Displays the "Search / Filter" submenu.
     ***************************************************************************************/
     void ShowSearchFilterMenu(const AddressBook& addressBook);
 
+    /***************************************************************************************
+    * Interactive type-ahead: shows live name/email suggestions as the user extends the
+    * prefix one entry at a time, and lets them open a suggestion by number.
+    ***************************************************************************************/
+    void RunTypeAheadLookup(const AddressBook& addressBook);
+
+    /***************************************************************************************
+    * Ranked search over name, email and notes: shows the best matches first, with scores.
+    ***************************************************************************************/
+    void RunRankedSearch(const AddressBook& addressBook);
+
     /***************************************************************************************
     * Displays the "Reports" submenu (missing info, counts by type, group summary).
     ***************************************************************************************/
     void ShowReportsMenu(const AddressBook& addressBook);
 
     /***************************************************************************************
-    * Displays the "Tags / Groups" submenu.
+    * Picks the contacts for a bulk tag / group edit: an ID list, a search or filter result,
+    * or everyone. Returns false if nothing was selected.
+    ***************************************************************************************/
+    bool SelectBulkContacts(const AddressBook& addressBook, std::vector<int>& contactIds, bool& everyone);
+
+    /***************************************************************************************
+    * Applies, removes or renames a tag or group across many contacts as one undoable edit.
+    ***************************************************************************************/
+    void RunBulkLabelEdit(AddressBook& addressBook);
+
+    /***************************************************************************************
+    * Displays the "Tags / Groups" submenu (single-contact edits and bulk edits).
     ***************************************************************************************/
     void ShowTagsGroupsMenu(AddressBook& addressBook);
 
 
+    /***************************************************************************************
+    * Lists likely duplicate pairs and merges the ones the user confirms.
+    ***************************************************************************************/
+    void ShowDuplicatesReview(AddressBook& addressBook);
+
+
+    /***************************************************************************************
+    * Lists, loads and unloads the shard files of a sharded book (--shard-dir) and picks the
+    * shard that receives new contacts.
+    ***************************************************************************************/
+    void ShowShardsMenu(AddressBook& addressBook);
+
+
+    /***************************************************************************************
+    * Prints one status line for a running or just-finished background save; a finished
+    * result is shown once and then cleared.
+    ***************************************************************************************/
+    void ShowSaveStatus(AddressBook& addressBook);
+
+
     //======================================================================================
     // MAIN MENU
     //======================================================================================
@@ -0,0 +1,75 @@
+//======================================================================
+// Implementation File: MappedFile.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   mmap on POSIX, whole-file read elsewhere.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * Empty files are never mapped (mmap rejects length 0); they get an
+//     empty buffer instead.
+//   * MADV_SEQUENTIAL is a hint for the one start-up scan; later record
+//     lookups are random but few.
+//======================================================================
+
+#include "MappedFile.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPED_FILE_USE_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::shared_ptr<const MappedFile> MappedFile::Open(const std::string &path, std::string &error) {
+    std::shared_ptr<MappedFile> file(new MappedFile());
+
+#if defined(MAPPED_FILE_USE_POSIX)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "could not open " + path + ": " + std::strerror(errno);
+        return nullptr;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        error = "could not stat " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        return nullptr;
+    }
+    if (info.st_size > 0) {
+        void *address = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            error = "could not map " + path + ": " + std::strerror(errno);
+            ::close(fd);
+            return nullptr;
+        }
+        ::madvise(address, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+        file->data_ = static_cast<const char *>(address);
+        file->size_ = static_cast<size_t>(info.st_size);
+        file->mapped_ = true;
+    }
+    ::close(fd);                 // the mapping stays valid without the descriptor
+    if (file->mapped_) return file;
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        error = "could not open " + path;
+        return nullptr;
+    }
+    file->buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+#endif
+
+    file->data_ = file->buffer_.data();
+    file->size_ = file->buffer_.size();
+    return file;
+}
+
+MappedFile::~MappedFile() {
+#if defined(MAPPED_FILE_USE_POSIX)
+    if (mapped_) ::munmap(const_cast<char *>(data_), size_);
+#endif
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/****************************************************************
+ * CLASS: MappedFile
+ * --------------------------------------------------------------
+ * Read-only view of a whole file. On POSIX the file is mmapped,
+ * so pages are only read from disk when a record on them is
+ * touched; elsewhere the file is read into memory once.
+ *
+ * Shared through std::shared_ptr<const MappedFile>: lazily loaded
+ * contacts keep the file alive until the last of them has been
+ * parsed.
+ ***************************************************************/
+class MappedFile {
+public:
+    /************************************************************
+     * Open (static)
+     * ----------------------------------------------------------
+     * PURPOSE : Map path for reading.
+     * RETURNS : (shared_ptr) nullptr with error set on failure.
+     ***********************************************************/
+    static std::shared_ptr<const MappedFile> Open(const std::string &path, std::string &error);
+
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *Data() const { return data_; }
+    size_t Size() const { return size_; }
+
+private:
+    MappedFile() = default;
+
+    const char *data_ {nullptr};
+    size_t size_ {0};
+    bool mapped_ {false};        // true: munmap on destruction
+    std::string buffer_;         // fallback storage when not mapped
+};
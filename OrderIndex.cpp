@@ -0,0 +1,195 @@
+//======================================================================
+// Implementation File: OrderIndex.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Maintained sort orders over the book for sorted, paged listings.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * A full block splits in half, and a block emptied by removals is
+//     dropped. Blocks are not merged otherwise: deletes mostly happen
+//     one at a time, and half-empty blocks only lengthen the size walk.
+//   * Bulk mode collects entries and sorts once; EndBulkLoad merges
+//     them with whatever is already indexed (e.g. when a second shard
+//     loads into a book that has been browsed).
+//======================================================================
+
+#include "OrderIndex.h"
+#include "TextUtils.h"
+#include <algorithm>
+#include <iterator>
+
+const size_t OrderIndex::BLOCK_LIMIT = 1024;
+
+std::string OrderIndex::CollationKey(const Contact &contact, Key key) {
+    // '\x01' sorts below every printable byte, so "Lee" + first name
+    // stays ahead of "Leeds" whatever the first name is.
+    switch (key) {
+        case Key::Id:
+            return std::string();
+        case Key::LastName:
+            return TextUtils::FoldCase(contact.getLastName()) + '\x01' + TextUtils::FoldCase(contact.getFirstName());
+        case Key::FirstName:
+            return TextUtils::FoldCase(contact.getFirstName()) + '\x01' + TextUtils::FoldCase(contact.getLastName());
+        case Key::City:
+            return TextUtils::FoldCase(contact.getCity());
+        case Key::Type:
+            return std::string(1, static_cast<char>('0' + static_cast<int>(contact.getType())));
+    }
+    return std::string();
+}
+
+//  Index of the block an entry belongs in: the first block whose last
+//  entry is not below it (or the last block).
+size_t OrderIndex::BlockFor(const Entry &entry) const {
+    auto found = std::lower_bound(blocks_.begin(), blocks_.end(), entry,
+                                  [](const Block &block, const Entry &value) { return block.back() < value; });
+    if (found == blocks_.end()) return blocks_.size() - 1;
+    return static_cast<size_t>(found - blocks_.begin());
+}
+
+void OrderIndex::Add(const Contact &contact) {
+    Entry entry {CollationKey(contact, key_), contact.getId()};
+    ++size_;
+    if (bulkLoading_) {
+        pending_.push_back(std::move(entry));
+        return;
+    }
+    if (blocks_.empty()) {
+        blocks_.emplace_back();
+        blocks_.back().push_back(std::move(entry));
+        return;
+    }
+    const size_t index = BlockFor(entry);
+    Block &block = blocks_[index];
+    block.insert(std::upper_bound(block.begin(), block.end(), entry), std::move(entry));
+    if (block.size() > BLOCK_LIMIT) {
+        Block upper(std::make_move_iterator(block.begin() + block.size() / 2),
+                    std::make_move_iterator(block.end()));
+        block.erase(block.begin() + block.size() / 2, block.end());
+        blocks_.insert(blocks_.begin() + index + 1, std::move(upper));
+    }
+}
+
+void OrderIndex::Remove(const Contact &contact) {
+    const Entry entry {CollationKey(contact, key_), contact.getId()};
+    if (bulkLoading_) {
+        auto found = std::find_if(pending_.begin(), pending_.end(), [&](const Entry &candidate) {
+            return candidate.id == entry.id && candidate.key == entry.key;
+        });
+        if (found != pending_.end()) {
+            pending_.erase(found);
+            --size_;
+            return;
+        }
+    }
+    if (blocks_.empty()) return;
+    const size_t index = BlockFor(entry);
+    Block &block = blocks_[index];
+    auto found = std::lower_bound(block.begin(), block.end(), entry);
+    if (found == block.end() || found->id != entry.id || found->key != entry.key) return;
+    block.erase(found);
+    --size_;
+    if (block.empty()) blocks_.erase(blocks_.begin() + index);
+}
+
+void OrderIndex::Clear() {
+    blocks_.clear();
+    pending_.clear();
+    size_ = 0;
+}
+
+void OrderIndex::BeginBulkLoad() {
+    bulkLoading_ = true;
+}
+
+void OrderIndex::EndBulkLoad() {
+    bulkLoading_ = false;
+    if (pending_.empty()) return;
+    std::sort(pending_.begin(), pending_.end());
+    std::vector<Entry> entries;
+    entries.reserve(size_);
+    for (Block &block : blocks_) {
+        std::move(block.begin(), block.end(), std::back_inserter(entries));
+    }
+    const size_t indexed = entries.size();
+    std::move(pending_.begin(), pending_.end(), std::back_inserter(entries));
+    std::inplace_merge(entries.begin(), entries.begin() + indexed, entries.end());
+    std::vector<Entry>().swap(pending_);
+    Rebuild(entries);
+}
+
+//  Cuts a sorted run into half-full blocks, leaving room for inserts.
+void OrderIndex::Rebuild(std::vector<Entry> &entries) {
+    blocks_.clear();
+    const size_t fill = BLOCK_LIMIT / 2;
+    for (size_t start = 0; start < entries.size(); start += fill) {
+        const size_t end = std::min(entries.size(), start + fill);
+        blocks_.emplace_back(std::make_move_iterator(entries.begin() + start),
+                             std::make_move_iterator(entries.begin() + end));
+    }
+}
+
+std::vector<int> OrderIndex::Page(size_t offset, size_t count, bool descending) const {
+    std::vector<int> contactIds;
+    if (offset >= size_ || count == 0) return contactIds;
+    count = std::min(count, size_ - offset);
+    if (!pending_.empty()) {
+        contactIds = MergedRange(descending ? size_ - offset - count : offset, count);
+        if (descending) std::reverse(contactIds.begin(), contactIds.end());
+        return contactIds;
+    }
+    contactIds.reserve(count);
+
+    // Ascending rank of the first entry to report, then walk from it.
+    size_t rank = descending ? size_ - 1 - offset : offset;
+    size_t block = 0;
+    while (rank >= blocks_[block].size()) {
+        rank -= blocks_[block].size();
+        ++block;
+    }
+    while (contactIds.size() < count) {
+        contactIds.push_back(blocks_[block][rank].id);
+        if (descending) {
+            if (rank == 0) {
+                if (block == 0) break;
+                --block;
+                rank = blocks_[block].size();
+            }
+            --rank;
+        } else if (++rank == blocks_[block].size()) {
+            ++block;
+            rank = 0;
+            if (block == blocks_.size()) break;
+        }
+    }
+    return contactIds;
+}
+
+//  Ascending ranks [first, first + count) of blocks_ and pending_ merged.
+//  Page() is a read, so pending_ is sorted into a side list rather than
+//  placed; this walks from the start, which is fine for the short time
+//  a bulk load lasts.
+std::vector<int> OrderIndex::MergedRange(size_t first, size_t count) const {
+    std::vector<const Entry *> added;
+    added.reserve(pending_.size());
+    for (const Entry &entry : pending_) added.push_back(&entry);
+    std::sort(added.begin(), added.end(), [](const Entry *a, const Entry *b) { return *a < *b; });
+
+    std::vector<int> contactIds;
+    contactIds.reserve(count);
+    size_t block = 0, at = 0, next = 0;
+    for (size_t rank = 0; contactIds.size() < count; ++rank) {
+        const Entry *entry;
+        if (block < blocks_.size() && (next == added.size() || blocks_[block][at] < *added[next])) {
+            entry = &blocks_[block][at];
+            if (++at == blocks_[block].size()) {
+                ++block;
+                at = 0;
+            }
+        } else {
+            entry = added[next++];
+        }
+        if (rank >= first) contactIds.push_back(entry->id);
+    }
+    return contactIds;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Contact.h"
+#include <string>
+#include <vector>
+
+/****************************************************************
+ * CLASS: OrderIndex
+ * --------------------------------------------------------------
+ * Every contact in one sort order, kept up to date as contacts
+ * change, so a sorted listing can be paged without re-sorting.
+ *
+ * Entries are (collation key, id) pairs. The collation key is the
+ * case-folded sort field, computed once when the contact is added,
+ * so comparisons during inserts and sorts are plain byte compares.
+ * Ties go to the lower id, which makes the order total and stable.
+ *
+ * Storage is an order-statistic list of sorted blocks of at most
+ * BLOCK_LIMIT entries: an insert or erase moves entries inside one
+ * block, and finding the k-th entry walks block sizes. At a
+ * million contacts that is ~2000 size reads per page instead of a
+ * sort, and a single-contact edit costs a block memmove instead of
+ * shifting the whole array.
+ ***************************************************************/
+class OrderIndex {
+public:
+    /************************************************************
+     * Key
+     * ----------------------------------------------------------
+     * Id        : contact id
+     * LastName  : last name, then first name (phone-book order)
+     * FirstName : first name, then last name
+     * City      : city
+     * Type      : ContactType declaration order
+     ***********************************************************/
+    enum class Key { Id, LastName, FirstName, City, Type };
+    static const size_t KEY_COUNT = 5;
+
+    explicit OrderIndex(Key key) : key_(key) {}
+
+    /************************************************************
+     * CollationKey (static)
+     * ----------------------------------------------------------
+     * PURPOSE : Sort key of a contact for one Key. Byte order of
+     *           the result is the collation order (ids excluded).
+     ***********************************************************/
+    static std::string CollationKey(const Contact &contact, Key key);
+
+    void Add(const Contact &contact);
+    void Remove(const Contact &contact);
+    void Clear();
+    void BeginBulkLoad();
+    void EndBulkLoad();
+
+    size_t Size() const { return size_; }
+
+    /************************************************************
+     * Page
+     * ----------------------------------------------------------
+     * PURPOSE : Ids at ranks [offset, offset + count) of the order,
+     *           counted from the end when descending.
+     * RETURNS : (vector<int>) Fewer than count ids near the end.
+     * NOTES   : In bulk mode the entries not yet placed are
+     *           ranked too, without placing them.
+     ***********************************************************/
+    std::vector<int> Page(size_t offset, size_t count, bool descending) const;
+
+private:
+    struct Entry {
+        std::string key;
+        int id;
+        bool operator<(const Entry &other) const {
+            int order = key.compare(other.key);
+            return order != 0 ? order < 0 : id < other.id;
+        }
+    };
+    typedef std::vector<Entry> Block;
+
+    static const size_t BLOCK_LIMIT;                 // split a block that grows past this
+
+    size_t BlockFor(const Entry &entry) const;
+    std::vector<int> MergedRange(size_t first, size_t count) const;
+    void Rebuild(std::vector<Entry> &entries);
+
+    Key key_;
+    std::vector<Block> blocks_;                      // sorted; each block non-empty
+    size_t size_ {0};
+    bool bulkLoading_ {false};
+    std::vector<Entry> pending_;                     // bulk mode: added, not yet placed
+};
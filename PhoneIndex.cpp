@@ -0,0 +1,231 @@
+//======================================================================
+// Implementation File: PhoneIndex.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Canonical digit column and suffix buckets for phone lookups.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * Numbers are canonicalized once when a contact is indexed; a
+//     query is canonicalized once and then only integers are compared.
+//   * Suffix matching on a packed number is a modulo by a power of ten.
+//   * The column is a plain vector; a removed number's slot is filled
+//     by the last one, so scans never step over holes.
+//======================================================================
+
+#include "PhoneIndex.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+    const int MAX_DIGITS = 15;
+
+    const std::uint64_t POW10[MAX_DIGITS + 1] = {
+        1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+        10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+        100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+        100000000000000ULL, 1000000000000000ULL
+    };
+}
+
+//**********************************************************************
+// Canonicalize (static)
+//----------------------------------------------------------------------
+// PURPOSE : Keep digits only; when there are more than 15 the leading
+//           ones roll off, which preserves the suffix used for lookup.
+//**********************************************************************
+std::uint64_t PhoneIndex::Canonicalize(const std::string &phone) {
+    std::uint64_t value = 0;
+    int length = 0;
+    for (char ch : phone) {
+        if (ch < '0' || ch > '9') continue;
+        value = (value * 10 + static_cast<std::uint64_t>(ch - '0')) % POW10[MAX_DIGITS];
+        if (length < MAX_DIGITS) ++length;
+    }
+    if (length == 0) return 0;
+    return (value << 4) | static_cast<std::uint64_t>(length);
+}
+
+//**********************************************************************
+// Contains (private static)
+//----------------------------------------------------------------------
+// PURPOSE : Substring test on packed numbers: the query's digits at
+//           each offset from the right are one divide and one modulo.
+//           Lengths are kept, so leading zeros (international "00"
+//           prefixes) still count as digits.
+//**********************************************************************
+bool PhoneIndex::Contains(std::uint64_t packed, std::uint64_t packedQuery) {
+    const int queryLength = LengthOf(packedQuery);
+    const std::uint64_t queryValue = ValueOf(packedQuery);
+    std::uint64_t value = ValueOf(packed);
+    for (int offset = 0; offset + queryLength <= LengthOf(packed); ++offset) {
+        if (value % POW10[queryLength] == queryValue) return true;
+        value /= 10;
+    }
+    return false;
+}
+
+int PhoneIndex::LongestLength() const {
+    int length = MAX_DIGITS;
+    while (length > 0 && numbersOfLength_[length] == 0) --length;
+    return length;
+}
+
+bool PhoneIndex::EndsWith(int contactId, std::uint64_t packedQuery) const {
+    const std::uint64_t packed = digits_[slotOf_.at(contactId)];
+    return LengthOf(packed) >= LengthOf(packedQuery) &&
+           ValueOf(packed) % POW10[LengthOf(packedQuery)] == ValueOf(packedQuery);
+}
+
+template <typename Key>
+void PhoneIndex::Erase(std::unordered_map<Key, std::vector<int>> &index, Key key, int contactId) {
+    auto bucket = index.find(key);
+    if (bucket == index.end()) return;
+    auto &ids = bucket->second;
+    ids.erase(std::remove(ids.begin(), ids.end(), contactId), ids.end());
+    if (ids.empty()) index.erase(bucket);
+}
+
+void PhoneIndex::Add(const Contact &contact) {
+    const std::uint64_t packed = Canonicalize(contact.getPhone());
+    if (packed == 0) return;
+
+    const int id = contact.getId();
+    const std::uint64_t value = ValueOf(packed);
+    const int length = LengthOf(packed);
+
+    slotOf_[id] = static_cast<std::uint32_t>(digits_.size());
+    digits_.push_back(packed);
+    idOfSlot_.push_back(id);
+    ++numbersOfLength_[length];
+    full_[packed].push_back(id);
+    if (length >= 4) last4_[static_cast<std::uint32_t>(value % POW10[4])].push_back(id);
+    if (length >= 7) last7_[static_cast<std::uint32_t>(value % POW10[7])].push_back(id);
+}
+
+//**********************************************************************
+// Remove
+//----------------------------------------------------------------------
+// PURPOSE : Uses the stored digit column, so the number does not have
+//           to be re-parsed from the contact.
+//**********************************************************************
+void PhoneIndex::Remove(const Contact &contact) {
+    auto stored = slotOf_.find(contact.getId());
+    if (stored == slotOf_.end()) return;
+
+    const int id = contact.getId();
+    const std::uint32_t slot = stored->second;
+    const std::uint64_t packed = digits_[slot];
+    const std::uint64_t value = ValueOf(packed);
+    const int length = LengthOf(packed);
+
+    Erase(full_, packed, id);
+    if (length >= 4) Erase(last4_, static_cast<std::uint32_t>(value % POW10[4]), id);
+    if (length >= 7) Erase(last7_, static_cast<std::uint32_t>(value % POW10[7]), id);
+    --numbersOfLength_[length];
+
+    digits_[slot] = digits_.back();
+    idOfSlot_[slot] = idOfSlot_.back();
+    slotOf_[idOfSlot_[slot]] = slot;
+    digits_.pop_back();
+    idOfSlot_.pop_back();
+    slotOf_.erase(id);
+}
+
+void PhoneIndex::Clear() {
+    digits_.clear();
+    idOfSlot_.clear();
+    slotOf_.clear();
+    last4_.clear();
+    last7_.clear();
+    full_.clear();
+    std::fill(std::begin(numbersOfLength_), std::end(numbersOfLength_), 0);
+}
+
+//**********************************************************************
+// Exact
+//----------------------------------------------------------------------
+// PURPOSE : "+1 949 555 1234" and "949-555-1234" name the same line;
+//           whichever form was stored, the other one is the fallback
+//           probe.
+//**********************************************************************
+const std::vector<int> *PhoneIndex::Exact(const std::string &phone) const {
+    const std::uint64_t packed = Canonicalize(phone);
+    auto found = full_.find(packed);
+    if (found != full_.end()) return &found->second;
+
+    std::uint64_t alternate = 0;
+    if (LengthOf(packed) == 11 && ValueOf(packed) / POW10[10] == 1) {
+        alternate = ((ValueOf(packed) % POW10[10]) << 4) | 10;
+    } else if (LengthOf(packed) == 10) {
+        alternate = ((ValueOf(packed) + POW10[10]) << 4) | 11;
+    }
+    found = alternate == 0 ? full_.end() : full_.find(alternate);
+    return found == full_.end() ? nullptr : &found->second;
+}
+
+//**********************************************************************
+// MatchDigits
+//----------------------------------------------------------------------
+// PURPOSE : A number can only contain the query somewhere other than
+//           at its end if it is longer than the query. When none is,
+//           the suffix lookup is the whole answer; otherwise - always
+//           for 1-3 digits - the digit column is scanned with
+//           Contains().
+//**********************************************************************
+std::vector<int> PhoneIndex::MatchDigits(const std::string &query) const {
+    std::vector<int> ids;
+    const std::uint64_t packedQuery = Canonicalize(query);
+    if (packedQuery == 0) return ids;
+
+    if (LengthOf(packedQuery) >= 4 && LongestLength() <= LengthOf(packedQuery)) {
+        return MatchSuffix(query);
+    }
+    for (size_t slot = 0; slot < digits_.size(); ++slot) {
+        if (Contains(digits_[slot], packedQuery)) ids.push_back(idOfSlot_[slot]);
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+//**********************************************************************
+// MatchSuffix
+//----------------------------------------------------------------------
+// PURPOSE : The narrowest bucket the query fills (last 7 when it is
+//           long enough, else last 4) holds every match; each
+//           candidate is verified with one modulo.
+//**********************************************************************
+std::vector<int> PhoneIndex::MatchSuffix(const std::string &query) const {
+    std::vector<int> ids;
+    const std::uint64_t packedQuery = Canonicalize(query);
+    if (packedQuery == 0) return ids;
+
+    const std::uint64_t queryValue = ValueOf(packedQuery);
+    const int queryLength = LengthOf(packedQuery);
+
+    if (queryLength < 4) {
+        for (size_t slot = 0; slot < digits_.size(); ++slot) {
+            if (LengthOf(digits_[slot]) >= queryLength &&
+                ValueOf(digits_[slot]) % POW10[queryLength] == queryValue) {
+                ids.push_back(idOfSlot_[slot]);
+            }
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    const std::vector<int> *bucket = nullptr;
+    if (queryLength >= 7) {
+        auto found = last7_.find(static_cast<std::uint32_t>(queryValue % POW10[7]));
+        if (found != last7_.end()) bucket = &found->second;
+    } else {
+        auto found = last4_.find(static_cast<std::uint32_t>(queryValue % POW10[4]));
+        if (found != last4_.end()) bucket = &found->second;
+    }
+    if (!bucket) return ids;
+
+    for (int id : *bucket) {
+        if (EndsWith(id, packedQuery)) ids.push_back(id);
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
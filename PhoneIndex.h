@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Contact.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/****************************************************************
+ * CLASS: PhoneIndex
+ * --------------------------------------------------------------
+ * Phone numbers canonicalized to digits ("(949) 555-1234" ->
+ * 9495551234) and packed into one 64-bit word per contact, kept
+ * in a contiguous column by dense slot, plus suffix buckets for
+ * the common lookup shapes:
+ *
+ *   | Bucket | Key                  | Serves                       |
+ *   |--------|----------------------|------------------------------|
+ *   | last4_ | last 4 digits        | "ends with 1234" queries     |
+ *   | last7_ | last 7 digits        | local-number / longer suffix |
+ *   | full_  | packed whole number  | exact caller-id lookup       |
+ *
+ * PACKING : value << 4 | digitCount. E.164 numbers have at most
+ *           15 digits (< 2^50), so this always fits. Longer inputs
+ *           keep their trailing 15 digits.
+ ***************************************************************/
+class PhoneIndex {
+public:
+    void Add(const Contact &contact);
+    void Remove(const Contact &contact);
+    void Clear();
+
+    /************************************************************
+     * MatchDigits
+     * ----------------------------------------------------------
+     * PURPOSE : Find contacts whose number contains the digits
+     *           of query anywhere. When no indexed number is longer
+     *           than the query, a match can only be a whole-number
+     *           suffix and MatchSuffix() answers it; otherwise the
+     *           digit column is scanned.
+     * RETURNS : (vector<int>) Matching contact ids, ascending.
+     ***********************************************************/
+    std::vector<int> MatchDigits(const std::string &query) const;
+
+    /************************************************************
+     * MatchSuffix
+     * ----------------------------------------------------------
+     * PURPOSE : Find contacts whose number ends with the digits
+     *           of query ("ends with 1234"). Four or more digits
+     *           are answered from the narrowest suffix bucket;
+     *           shorter queries scan the digit column.
+     * RETURNS : (vector<int>) Matching contact ids, ascending.
+     ***********************************************************/
+    std::vector<int> MatchSuffix(const std::string &query) const;
+
+    /************************************************************
+     * Exact
+     * ----------------------------------------------------------
+     * PURPOSE : Caller-id lookup: a hash probe on the full
+     *           canonical number. A 10-digit number and the same
+     *           number behind a leading country code 1 are the same
+     *           caller, so a miss retries the other form.
+     * RETURNS : (pointer) Ids sharing the number, or nullptr.
+     ***********************************************************/
+    const std::vector<int> *Exact(const std::string &phone) const;
+
+    /************************************************************
+     * Canonicalize (static)
+     * ----------------------------------------------------------
+     * PURPOSE : Strip everything but digits and pack the result.
+     * RETURNS : (uint64_t) Packed number; 0 if there are no digits.
+     ***********************************************************/
+    static std::uint64_t Canonicalize(const std::string &phone);
+
+private:
+    static std::uint64_t ValueOf(std::uint64_t packed) { return packed >> 4; }
+    static int LengthOf(std::uint64_t packed) { return static_cast<int>(packed & 0xF); }
+    static bool Contains(std::uint64_t packed, std::uint64_t packedQuery);
+    int LongestLength() const;
+
+    template <typename Key>
+    static void Erase(std::unordered_map<Key, std::vector<int>> &index, Key key, int contactId);
+
+    bool EndsWith(int contactId, std::uint64_t packedQuery) const;
+
+    std::vector<std::uint64_t> digits_;                            // slot -> packed number
+    std::vector<int> idOfSlot_;                                    // slot -> contact id
+    std::unordered_map<int, std::uint32_t> slotOf_;                // contact id -> slot
+    std::unordered_map<std::uint32_t, std::vector<int>> last4_;
+    std::unordered_map<std::uint32_t, std::vector<int>> last7_;
+    std::unordered_map<std::uint64_t, std::vector<int>> full_;
+    std::size_t numbersOfLength_[16] {};                           // digit count -> numbers indexed
+};
@@ -0,0 +1,130 @@
+//======================================================================
+// Implementation File: PhoneticIndex.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Soundex-keyed hash index for sound-alike first/last name lookup.
+//======================================================================
+
+#include "PhoneticIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+//**********************************************************************
+// Soundex (static)
+//----------------------------------------------------------------------
+// PURPOSE : Standard American Soundex. Vowels (and Y) reset the
+//           "previous code" so repeated consonants across a vowel are
+//           both kept; H and W do not.
+//**********************************************************************
+std::string PhoneticIndex::Soundex(const std::string &name) {
+    //                            ABCDEFGHIJKLMNOPQRSTUVWXYZ
+    static const char CODES[] = "01230120022455012623010202";
+
+    std::string code;
+    char previous = '\0';
+    for (char raw : name) {
+        const char upper = static_cast<char>(std::toupper(static_cast<unsigned char>(raw)));
+        if (upper < 'A' || upper > 'Z') continue;
+        const char digit = CODES[upper - 'A'];
+
+        if (code.empty()) {
+            code.push_back(upper);
+            previous = digit;
+            continue;
+        }
+        if (upper == 'H' || upper == 'W') continue;   // transparent
+        if (digit == '0') {                           // vowel separates
+            previous = '0';
+            continue;
+        }
+        if (digit != previous) {
+            code.push_back(digit);
+            if (code.size() == 4) break;
+        }
+        previous = digit;
+    }
+
+    if (!code.empty()) code.resize(4, '0');
+    return code;
+}
+
+void PhoneticIndex::Add(const Contact &contact) {
+    Codes codes { Soundex(contact.getFirstName()), Soundex(contact.getLastName()) };
+    if (!codes.first.empty()) firstNameIndex_[codes.first].push_back(contact.getId());
+    if (!codes.last.empty()) lastNameIndex_[codes.last].push_back(contact.getId());
+    codesById_[contact.getId()] = std::move(codes);
+}
+
+void PhoneticIndex::Erase(std::unordered_map<std::string, std::vector<int>> &index,
+                          const std::string &code, int contactId) {
+    auto bucket = index.find(code);
+    if (bucket == index.end()) return;
+    auto &ids = bucket->second;
+    ids.erase(std::remove(ids.begin(), ids.end(), contactId), ids.end());
+    if (ids.empty()) index.erase(bucket);
+}
+
+//**********************************************************************
+// Remove
+//----------------------------------------------------------------------
+// PURPOSE : Uses the codes cached at Add time, so the caller's copy of
+//           the contact only has to supply the id.
+//**********************************************************************
+void PhoneticIndex::Remove(const Contact &contact) {
+    auto cached = codesById_.find(contact.getId());
+    if (cached == codesById_.end()) return;
+    Erase(firstNameIndex_, cached->second.first, contact.getId());
+    Erase(lastNameIndex_, cached->second.last, contact.getId());
+    codesById_.erase(cached);
+}
+
+void PhoneticIndex::Clear() {
+    firstNameIndex_.clear();
+    lastNameIndex_.clear();
+    codesById_.clear();
+}
+
+//**********************************************************************
+// Lookup
+//----------------------------------------------------------------------
+// PURPOSE : One word  -> union of first-name and last-name buckets.
+//           Two+ words -> first word against first names, last word
+//           against last names, intersected.
+//**********************************************************************
+std::vector<int> PhoneticIndex::Lookup(const std::string &nameQuery) const {
+    std::vector<std::string> words;
+    std::istringstream tokens(nameQuery);
+    std::string word;
+    while (tokens >> word) {
+        if (!Soundex(word).empty()) words.push_back(word);   // skip "&", "-" etc.
+    }
+
+    std::vector<int> ids;
+    if (words.empty()) return ids;
+
+    auto bucketOf = [](const std::unordered_map<std::string, std::vector<int>> &index,
+                       const std::string &code) {
+        auto found = index.find(code);
+        return found == index.end() ? std::vector<int>() : found->second;
+    };
+
+    if (words.size() == 1) {
+        const std::string code = Soundex(words.front());
+        ids = bucketOf(firstNameIndex_, code);
+        const std::vector<int> lastIds = bucketOf(lastNameIndex_, code);
+        ids.insert(ids.end(), lastIds.begin(), lastIds.end());
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        return ids;
+    }
+
+    std::vector<int> firstIds = bucketOf(firstNameIndex_, Soundex(words.front()));
+    std::vector<int> lastIds = bucketOf(lastNameIndex_, Soundex(words.back()));
+    std::sort(firstIds.begin(), firstIds.end());
+    std::sort(lastIds.begin(), lastIds.end());
+    std::set_intersection(firstIds.begin(), firstIds.end(),
+                          lastIds.begin(), lastIds.end(),
+                          std::back_inserter(ids));
+    return ids;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Contact.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/****************************************************************
+ * CLASS: PhoneticIndex
+ * --------------------------------------------------------------
+ * Hash index from American Soundex codes of first and last names
+ * to contact ids, for "sounds like" lookups ("Smyth" -> "Smith").
+ *
+ * RESPONSIBILITIES:
+ *   - Compute each contact's codes once, at insert time, and
+ *     remember them so removal needs no recomputation.
+ *   - Answer a lookup with hash hits only; the query is encoded
+ *     once and never compared against every contact.
+ ***************************************************************/
+class PhoneticIndex {
+public:
+    void Add(const Contact &contact);
+    void Remove(const Contact &contact);
+    void Clear();
+
+    /************************************************************
+     * Lookup
+     * ----------------------------------------------------------
+     * PURPOSE : Find contacts whose names sound like the query.
+     * PARAMS  : nameQuery (IN) - "First Last" or a single name.
+     *           Two or more words match first AND last name;
+     *           a single word matches either one.
+     * RETURNS : (vector<int>) Matching contact ids, ascending.
+     ***********************************************************/
+    std::vector<int> Lookup(const std::string &nameQuery) const;
+
+    /************************************************************
+     * Soundex (static)
+     * ----------------------------------------------------------
+     * PURPOSE : American Soundex (letter + three digits, H/W do
+     *           not separate equal codes). Non-letters ignored.
+     * RETURNS : (string) Code such as "S530", or "" if no letters.
+     ***********************************************************/
+    static std::string Soundex(const std::string &name);
+
+private:
+    struct Codes {
+        std::string first;
+        std::string last;
+    };
+
+    static void Erase(std::unordered_map<std::string, std::vector<int>> &index,
+                      const std::string &code, int contactId);
+
+    std::unordered_map<std::string, std::vector<int>> firstNameIndex_; // code -> ids
+    std::unordered_map<std::string, std::vector<int>> lastNameIndex_;  // code -> ids
+    std::unordered_map<int, Codes> codesById_;                         // cached per-contact keys
+};
@@ -0,0 +1,113 @@
+//======================================================================
+// Implementation File: PrefixIndex.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Sorted (key, id) array supporting type-ahead prefix completion.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * A flat sorted vector is far more compact than a node-based trie
+//     and binary search over it is cache friendly. Single inserts pay
+//     an O(n) memmove, which is acceptable for interactive edits; file
+//     loads use the bulk path and sort once.
+//======================================================================
+
+#include "PrefixIndex.h"
+#include "TextUtils.h"
+#include <algorithm>
+#include <unordered_set>
+
+//**********************************************************************
+// EntryLess (private static)
+//----------------------------------------------------------------------
+// PURPOSE : Strict ordering by key, then id, so duplicate keys from
+//           different contacts have a stable position.
+//**********************************************************************
+bool PrefixIndex::EntryLess(const Entry &lhs, const Entry &rhs) {
+    int cmp = lhs.key.compare(rhs.key);
+    if (cmp != 0) return cmp < 0;
+    return lhs.contactId < rhs.contactId;
+}
+
+//**********************************************************************
+// KeysFor (private static)
+//----------------------------------------------------------------------
+// PURPOSE : Case-folded first, last, full name and email. Empty and
+//           repeated keys are skipped so Add/Remove stay symmetric.
+//**********************************************************************
+std::vector<std::string> PrefixIndex::KeysFor(const Contact &contact) {
+    std::vector<std::string> keys;
+    const std::string first = TextUtils::FoldCase(contact.getFirstName());
+    const std::string last  = TextUtils::FoldCase(contact.getLastName());
+    const std::string full  = TextUtils::FoldCase(contact.getFullName());
+    const std::string email = TextUtils::FoldCase(contact.getEmail());
+
+    for (const std::string *key : { &first, &last, &full, &email }) {
+        if (key->empty()) continue;
+        if (std::find(keys.begin(), keys.end(), *key) != keys.end()) continue;
+        keys.push_back(*key);
+    }
+    return keys;
+}
+
+void PrefixIndex::Add(const Contact &contact) {
+    for (auto &key : KeysFor(contact)) {
+        Entry entry { std::move(key), contact.getId() };
+        if (bulkLoading_) {
+            entries_.push_back(std::move(entry));
+        } else {
+            auto pos = std::lower_bound(entries_.begin(), entries_.end(), entry, EntryLess);
+            entries_.insert(pos, std::move(entry));
+        }
+    }
+}
+
+void PrefixIndex::Remove(const Contact &contact) {
+    for (auto &key : KeysFor(contact)) {
+        Entry probe { std::move(key), contact.getId() };
+        auto pos = std::lower_bound(entries_.begin(), entries_.end(), probe, EntryLess);
+        if (pos != entries_.end() && pos->contactId == probe.contactId && pos->key == probe.key) {
+            entries_.erase(pos);
+        }
+    }
+}
+
+void PrefixIndex::Clear() {
+    entries_.clear();
+}
+
+void PrefixIndex::BeginBulkLoad() {
+    bulkLoading_ = true;
+}
+
+void PrefixIndex::EndBulkLoad() {
+    bulkLoading_ = false;
+    std::sort(entries_.begin(), entries_.end(), EntryLess);
+}
+
+//**********************************************************************
+// Complete
+//----------------------------------------------------------------------
+// PURPOSE : lower_bound to the first key >= prefix, then walk forward
+//           while keys still start with the prefix, collecting up to
+//           `limit` distinct contact ids.
+//**********************************************************************
+std::vector<int> PrefixIndex::Complete(const std::string &prefix, size_t limit) const {
+    std::vector<int> ids;
+    if (limit == 0) return ids;
+
+    const std::string folded = TextUtils::FoldCase(prefix);
+    Entry probe { folded, 0 };
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), probe,
+                               [](const Entry &lhs, const Entry &rhs) {
+                                   return lhs.key < rhs.key;
+                               });
+
+    std::unordered_set<int> seen;
+    for (; it != entries_.end() && ids.size() < limit; ++it) {
+        if (!TextUtils::StartsWith(it->key, folded)) break;
+        if (seen.insert(it->contactId).second) {
+            ids.push_back(it->contactId);
+        }
+    }
+    return ids;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Contact.h"
+#include <string>
+#include <vector>
+
+/****************************************************************
+ * CLASS: PrefixIndex
+ * --------------------------------------------------------------
+ * Sorted-array prefix index over the case-folded first name,
+ * last name, full name and email of every contact. A prefix
+ * query is two binary searches (lower_bound of the prefix) and a
+ * short forward walk, so type-ahead completion cost depends on
+ * the number of suggestions requested, not on the book size.
+ *
+ * RESPONSIBILITIES:
+ *   - Keep one (key, contactId) entry per indexed field.
+ *   - Support incremental add/remove as contacts change.
+ *   - Support a bulk-load mode (append, then sort once) so a
+ *     file load is O(n log n) instead of O(n^2) inserts.
+ ***************************************************************/
+class PrefixIndex {
+public:
+    /************************************************************
+     * Add / Remove
+     * ----------------------------------------------------------
+     * PURPOSE : Insert or erase every key derived from contact.
+     * NOTE    : Remove must be given the contact as it was when
+     *           added (callers unindex before mutating).
+     ***********************************************************/
+    void Add(const Contact &contact);
+    void Remove(const Contact &contact);
+
+    /************************************************************
+     * Clear
+     * ----------------------------------------------------------
+     * PURPOSE : Drop every entry (used before a reload).
+     ***********************************************************/
+    void Clear();
+
+    /************************************************************
+     * BeginBulkLoad / EndBulkLoad
+     * ----------------------------------------------------------
+     * PURPOSE : While in bulk mode Add only appends; EndBulkLoad
+     *           sorts the array once. Queries are not valid until
+     *           EndBulkLoad has been called.
+     ***********************************************************/
+    void BeginBulkLoad();
+    void EndBulkLoad();
+
+    /************************************************************
+     * Complete
+     * ----------------------------------------------------------
+     * PURPOSE : Find contacts with any indexed field starting
+     *           with prefix (case-insensitive).
+     * PARAMS  : prefix (IN) - text typed so far
+     *           limit  (IN) - maximum distinct contacts returned
+     * RETURNS : (vector<int>) Contact ids in key order, no dupes.
+     ***********************************************************/
+    std::vector<int> Complete(const std::string &prefix, size_t limit) const;
+
+    size_t Size() const { return entries_.size(); }
+
+private:
+    struct Entry {
+        std::string key;   // case-folded field value
+        int contactId;     // owning contact
+    };
+
+    static bool EntryLess(const Entry &lhs, const Entry &rhs);
+    static std::vector<std::string> KeysFor(const Contact &contact);
+
+    std::vector<Entry> entries_; // sorted by (key, contactId) outside bulk mode
+    bool bulkLoading_ {false};
+};
@@ -0,0 +1,167 @@
+//======================================================================
+// Implementation File: Relevance.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Ranked-search scoring and bounded top-K selection.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * Field words are matched in place with a case-folding compare;
+//     scoring a contact allocates nothing, which matters because it
+//     runs once per contact per search.
+//   * Term frequency is damped as 1 + ln(count): a name that repeats
+//     a word beats one that has it once, but a note that says it ten
+//     times does not drown out an exact name match.
+//======================================================================
+
+#include "Relevance.h"
+#include "TextUtils.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+namespace {
+
+    enum class MatchKind { None, Substring, Prefix, Exact };
+
+    // Byte tables: scoring classifies every byte of every scored field,
+    // and a table load is much cheaper than a locale-aware call.
+    struct CharTables {
+        bool word[256];
+        char fold[256];
+        CharTables() {
+            for (int c = 0; c < 256; ++c) {
+                word[c] = TextUtils::IsWordByte(static_cast<char>(c));
+                fold[c] = static_cast<char>(std::tolower(c));
+            }
+        }
+    };
+    const CharTables TABLES;
+
+    bool IsWordChar(char c) {
+        return TABLES.word[static_cast<unsigned char>(c)];
+    }
+
+    char Fold(char c) {
+        return TABLES.fold[static_cast<unsigned char>(c)];
+    }
+
+    // How a folded query term matches text[begin, end), one field word.
+    MatchKind MatchWord(const std::string &text, size_t begin, size_t end, const std::string &term) {
+        if (term.size() > end - begin) return MatchKind::None;
+        const auto wordBegin = text.begin() + static_cast<std::ptrdiff_t>(begin);
+        const auto wordEnd = text.begin() + static_cast<std::ptrdiff_t>(end);
+        auto same = [](char fieldChar, char termChar) { return Fold(fieldChar) == termChar; };
+        if (std::equal(wordBegin, wordBegin + static_cast<std::ptrdiff_t>(term.size()), term.begin(), same)) {
+            return term.size() == end - begin ? MatchKind::Exact : MatchKind::Prefix;
+        }
+        return std::search(wordBegin + 1, wordEnd, term.begin(), term.end(), same) != wordEnd
+                   ? MatchKind::Substring : MatchKind::None;
+    }
+
+    // Best match of one term over the words of one or more strings
+    // that make up a field, and how many words it matched.
+    struct FieldMatch {
+        MatchKind best {MatchKind::None};
+        size_t count {0};
+    };
+
+    void MatchField(const std::string &text, const std::string &term, FieldMatch &match) {
+        size_t position = 0;
+        while (position < text.size()) {
+            while (position < text.size() && !IsWordChar(text[position])) ++position;
+            size_t end = position;
+            while (end < text.size() && IsWordChar(text[end])) ++end;
+            if (end > position) {
+                const MatchKind kind = MatchWord(text, position, end, term);
+                if (kind != MatchKind::None) {
+                    ++match.count;
+                    match.best = std::max(match.best, kind);
+                }
+            }
+            position = end;
+        }
+    }
+
+    double FieldScore(const FieldMatch &match, double fieldWeight, const Relevance::Weights &weights) {
+        if (match.count == 0) return 0.0;
+        double kindWeight = weights.substring;
+        if (match.best == MatchKind::Exact) kindWeight = weights.exact;
+        else if (match.best == MatchKind::Prefix) kindWeight = weights.prefix;
+        return fieldWeight * kindWeight * (1.0 + std::log(static_cast<double>(match.count)));
+    }
+
+    double WeightedScore(const Contact &contact, const Relevance::Query &query, const Relevance::Weights &weights) {
+        double score = 0.0;
+        for (const std::string &term : query.terms) {
+            if (weights.name > 0.0) {
+                FieldMatch name;
+                MatchField(contact.getFirstName(), term, name);
+                MatchField(contact.getLastName(), term, name);
+                score += FieldScore(name, weights.name, weights);
+            }
+            if (weights.email > 0.0) {
+                FieldMatch email;
+                MatchField(contact.getEmail(), term, email);
+                score += FieldScore(email, weights.email, weights);
+            }
+            if (weights.notes > 0.0) {
+                FieldMatch notes;
+                MatchField(contact.getNotes(), term, notes);
+                score += FieldScore(notes, weights.notes, weights);
+            }
+        }
+        return score;
+    }
+}
+
+namespace Relevance {
+
+Query ParseQuery(const std::string &text) {
+    Query query;
+    query.terms = TextUtils::SplitWords(text);
+    return query;
+}
+
+Scorer FieldScorer(const Weights &weights) {
+    return [weights](const Contact &contact, const Query &query) {
+        return WeightedScore(contact, query, weights);
+    };
+}
+
+double DefaultScore(const Contact &contact, const Query &query) {
+    static const Weights DEFAULT_WEIGHTS;
+    return WeightedScore(contact, query, DEFAULT_WEIGHTS);
+}
+
+//  Strict "ranks ahead of"; as the heap's comparator it keeps the
+//  weakest hit at the root.
+bool TopK::Better(const Hit &a, const Hit &b) {
+    return a.score != b.score ? a.score > b.score : a.item < b.item;
+}
+
+void TopK::Offer(double score, size_t item) {
+    const Hit hit {score, item};
+    if (heap_.size() < limit_) {
+        heap_.push_back(hit);
+        std::push_heap(heap_.begin(), heap_.end(), Better);
+    } else if (limit_ > 0 && Better(hit, heap_.front())) {
+        std::pop_heap(heap_.begin(), heap_.end(), Better);
+        heap_.back() = hit;
+        std::push_heap(heap_.begin(), heap_.end(), Better);
+    }
+}
+
+void TopK::Merge(const TopK &other) {
+    for (const Hit &hit : other.heap_) {
+        Offer(hit.score, hit.item);
+    }
+}
+
+std::vector<TopK::Hit> TopK::Take() {
+    std::sort_heap(heap_.begin(), heap_.end(), Better);
+    std::vector<Hit> hits;
+    hits.swap(heap_);
+    return hits;
+}
+
+}
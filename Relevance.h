@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Contact.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/****************************************************************
+ * NAMESPACE: Relevance
+ * --------------------------------------------------------------
+ * Scoring and top-K selection for ranked searches
+ * (AddressBook::SearchRanked).
+ *
+ * A query is split into words; a contact's score is the sum over
+ * query words of how well each one matches each field. Field
+ * text is split into words the same way, and a query word
+ * matches a field word exactly, as its prefix, or somewhere
+ * inside it. The default weights put exact over prefix over
+ * substring, and name over email over notes; a word matching
+ * several field words counts more, with diminishing returns.
+ *
+ * Scorers are plain functions, so callers can plug in their own
+ * (different weights through FieldScorer(), or any other rule).
+ * A scorer is called from several threads at once and must only
+ * read its arguments. A score <= 0 means "no match".
+ ***************************************************************/
+namespace Relevance {
+
+    /************************************************************
+     * Query
+     * ----------------------------------------------------------
+     * The search text as case-folded words, split once per
+     * search rather than once per contact.
+     ***********************************************************/
+    struct Query {
+        std::vector<std::string> terms;
+    };
+
+    /************************************************************
+     * ParseQuery
+     * ----------------------------------------------------------
+     * PURPOSE : Split search text into case-folded words
+     *           (TextUtils::SplitWords).
+     * RETURNS : (Query) No terms if the text has no words.
+     ***********************************************************/
+    Query ParseQuery(const std::string &text);
+
+    typedef std::function<double(const Contact &, const Query &)> Scorer;
+
+    /************************************************************
+     * Weights
+     * ----------------------------------------------------------
+     * Field weights multiply match-kind weights; the name field
+     * is first and last name together.
+     ***********************************************************/
+    struct Weights {
+        double name {3.0};
+        double email {2.0};
+        double notes {1.0};
+        double exact {4.0};
+        double prefix {2.0};
+        double substring {1.0};
+    };
+
+    /************************************************************
+     * FieldScorer
+     * ----------------------------------------------------------
+     * PURPOSE : The weighted field scorer described above. A
+     *           field weight of 0 leaves that field out.
+     ***********************************************************/
+    Scorer FieldScorer(const Weights &weights);
+
+    /************************************************************
+     * DefaultScore
+     * ----------------------------------------------------------
+     * PURPOSE : FieldScorer() with the default Weights.
+     ***********************************************************/
+    double DefaultScore(const Contact &contact, const Query &query);
+
+    /************************************************************
+     * CLASS: TopK
+     * ----------------------------------------------------------
+     * The best `limit` (score, item) pairs offered so far, held in
+     * a min-heap whose root is the weakest one kept: each offer is
+     * one compare against the root, and O(log limit) only when it
+     * gets in. Finding the best k of n matches costs
+     * O(n log k) instead of sorting all n.
+     *
+     * Higher scores rank first; equal scores go to the lower
+     * item, so the result does not depend on the order of offers
+     * (or on how a scan was split between threads).
+     ***********************************************************/
+    class TopK {
+    public:
+        struct Hit {
+            double score;
+            size_t item;
+        };
+
+        explicit TopK(size_t limit) : limit_(limit) {}
+
+        void Offer(double score, size_t item);
+        void Merge(const TopK &other);
+
+        /********************************************************
+         * Take
+         * ------------------------------------------------------
+         * RETURNS : (vector<Hit>) The hits kept, best first. The
+         *           TopK is empty afterwards.
+         *******************************************************/
+        std::vector<Hit> Take();
+
+    private:
+        static bool Better(const Hit &a, const Hit &b);
+
+        size_t limit_;
+        std::vector<Hit> heap_;            // root = weakest kept hit
+    };
+}
@@ -0,0 +1,65 @@
+//======================================================================
+// Implementation File: RenderCache.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Version-checked LRU of formatted contact text.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * Formatting happens outside the lock; two threads missing on the
+//     same contact both render it and the second Put simply wins.
+//   * Cost = text bytes + a fixed per-entry overhead, so a flood of
+//     tiny entries cannot grow the map without bound either.
+//======================================================================
+
+#include "RenderCache.h"
+
+namespace {
+    const size_t ENTRY_OVERHEAD_BYTES = 64;
+
+    std::string FormatContact(const Contact &contact, RenderCache::Format format) {
+        switch (format) {
+            case RenderCache::Format::Detail: return contact.toString(true);
+            case RenderCache::Format::Summary: return contact.toString();
+            case RenderCache::Format::Csv: return contact.toCSV();
+        }
+        return std::string();
+    }
+}
+
+RenderCache::RenderCache(size_t capacityBytes) : cache_(capacityBytes) {}
+
+std::string RenderCache::Render(const Contact &contact, Format format) {
+    const Key key {contact.getId(), format};
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Entry *cached = cache_.Get(key);
+        if (cached && cached->version == contact.getVersion()) {
+            ++hits_;
+            return cached->text;
+        }
+        ++misses_;                 // absent, or rendered from an older version
+    }
+
+    std::string text = FormatContact(contact, format);
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.Put(key, Entry{contact.getVersion(), text}, text.size() + ENTRY_OVERHEAD_BYTES);
+    return text;
+}
+
+void RenderCache::Invalidate(int contactId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.Erase(Key{contactId, Format::Detail});
+    cache_.Erase(Key{contactId, Format::Summary});
+    cache_.Erase(Key{contactId, Format::Csv});
+}
+
+void RenderCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.Clear();
+}
+
+RenderCache::Stats RenderCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return Stats{hits_, misses_, cache_.Evictions(),
+                 cache_.Size(), cache_.Cost(), cache_.Capacity()};
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Contact.h"
+#include "LruCache.h"
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+/****************************************************************
+ * CLASS: RenderCache
+ * --------------------------------------------------------------
+ * Bounded cache of formatted contact text (toString / toCSV), so
+ * contacts that are viewed again and again are formatted once.
+ *
+ * Entries are keyed by (contact id, format) and remember the
+ * contact version they were rendered from; a different version
+ * is a miss and re-renders. Edits also Invalidate() the id so the
+ * stale text does not occupy the budget.
+ *
+ * The budget is in bytes of cached text, so memory stays bounded
+ * however large individual records are. Thread-safe.
+ ***************************************************************/
+class RenderCache {
+public:
+    enum class Format { Detail, Summary, Csv };   // toString(true), toString(), toCSV()
+
+    struct Stats {
+        size_t hits;
+        size_t misses;
+        size_t evictions;
+        size_t entries;
+        size_t bytes;
+        size_t capacityBytes;
+    };
+
+    explicit RenderCache(size_t capacityBytes);
+
+    /************************************************************
+     * Render
+     * ----------------------------------------------------------
+     * PURPOSE : Cached text for contact in the given format.
+     ***********************************************************/
+    std::string Render(const Contact &contact, Format format);
+
+    void Invalidate(int contactId);
+    void Clear();
+    Stats GetStats() const;
+
+private:
+    struct Key {
+        int contactId;
+        Format format;
+        bool operator==(const Key &other) const {
+            return contactId == other.contactId && format == other.format;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key &key) const {
+            return std::hash<int>()(key.contactId) * 3 + static_cast<size_t>(key.format);
+        }
+    };
+    struct Entry {
+        unsigned version;
+        std::string text;
+    };
+
+    mutable std::mutex mutex_;
+    LruCache<Key, Entry, KeyHash> cache_;
+    size_t hits_ {0};            // version-checked, so not the LRU's own counts
+    size_t misses_ {0};
+};
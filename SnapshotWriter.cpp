@@ -0,0 +1,324 @@
+//======================================================================
+// Implementation File: SnapshotWriter.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Durable (temp file + fsync + rename) CSV writes, optionally on a
+//   background thread with progress counters.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * Records are serialized into a buffer and written in chunks, so a
+//     large book costs a few hundred system calls rather than one per
+//     line. The compressed format frames each chunk with BlockCodec.
+//   * Serialize, compress and write run as pipeline stages on their own
+//     threads, joined by BoundedQueues of PIPELINE_DEPTH chunks, so the
+//     disk is busy while the next chunk is built and memory stays a few
+//     chunks deep however large the book is.
+//   * The worker owns its snapshot outright; the only state shared
+//     with the UI thread is the atomics and the mutex-guarded message.
+//     Label names come from the shared dictionaries, so a save holds
+//     a NameFreeze across all its files to keep renames out.
+//======================================================================
+
+#include "SnapshotWriter.h"
+#include "BlockCodec.h"
+#include "BoundedQueue.h"
+#include "LabelDictionary.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SNAPSHOT_USE_POSIX 1
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    const size_t WRITE_CHUNK_BYTES = 64 * 1024;
+    const size_t PIPELINE_DEPTH = 4;    // chunks queued between stages
+
+    //  Thin file wrapper: POSIX descriptors where available (for fsync),
+    //  otherwise a binary ofstream.
+    class OutputFile {
+    public:
+        ~OutputFile() { Close(); }
+
+#if defined(SNAPSHOT_USE_POSIX)
+        bool Open(const std::string &path, std::string &error) {
+            fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd_ < 0) error = ErrnoText("could not open " + path);
+            return fd_ >= 0;
+        }
+
+        bool Write(const std::string &data, std::string &error) {
+            size_t done = 0;
+            while (done < data.size()) {
+                const ssize_t n = ::write(fd_, data.data() + done, data.size() - done);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    error = ErrnoText("write failed");
+                    return false;
+                }
+                done += static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        bool Sync(std::string &error) {
+            if (::fsync(fd_) == 0) return true;
+            error = ErrnoText("fsync failed");
+            return false;
+        }
+
+        bool Close() {
+            if (fd_ < 0) return true;
+            const int result = ::close(fd_);
+            fd_ = -1;
+            return result == 0;
+        }
+
+    private:
+        static std::string ErrnoText(const std::string &what) {
+            return what + ": " + std::strerror(errno);
+        }
+
+        int fd_ {-1};
+#else
+        bool Open(const std::string &path, std::string &error) {
+            file_.open(path, std::ios::binary | std::ios::trunc);
+            if (!file_.is_open()) error = "could not open " + path;
+            return file_.is_open();
+        }
+
+        bool Write(const std::string &data, std::string &error) {
+            file_.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!file_) error = "write failed";
+            return static_cast<bool>(file_);
+        }
+
+        bool Sync(std::string &error) {
+            file_.flush();
+            if (!file_) error = "write failed";
+            return static_cast<bool>(file_);
+        }
+
+        bool Close() {
+            if (file_.is_open()) file_.close();
+            return true;
+        }
+
+    private:
+        std::ofstream file_;
+#endif
+    };
+
+    //  Moves the finished temp file over the real one. POSIX rename is
+    //  atomic; elsewhere rename() may refuse to replace, so remove first.
+    bool ReplaceFile(const std::string &tempPath, const std::string &path, std::string &error) {
+#if !defined(SNAPSHOT_USE_POSIX)
+        std::remove(path.c_str());
+#endif
+        if (std::rename(tempPath.c_str(), path.c_str()) == 0) return true;
+        error = "rename failed: " + std::string(std::strerror(errno));
+        return false;
+    }
+
+#if defined(SNAPSHOT_USE_POSIX)
+    // Makes the rename durable; best effort, as some filesystems refuse.
+    void SyncParentDirectory(const std::string &path) {
+        const size_t slash = path.find_last_of('/');
+        const std::string dir = (slash == std::string::npos) ? "." : path.substr(0, slash + 1);
+        const int fd = ::open(dir.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        ::fsync(fd);
+        ::close(fd);
+    }
+#endif
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    Wait();
+}
+
+//**********************************************************************
+// WriteFile (static)
+//----------------------------------------------------------------------
+// PURPOSE : See header. Records are gathered into a chunk (64 KiB for
+//           CSV, one codec block when compressed) on the calling thread;
+//           full chunks go through a bounded queue to a compressor
+//           thread (compressed format only) and then to a writer thread.
+//           Because a chunk only ever holds whole records, every
+//           compressed block is independently parseable. A write error
+//           closes both queues, which stops the upstream stages. The
+//           temporary file is removed on any failure so a stale .tmp
+//           never lingers.
+//**********************************************************************
+bool SnapshotWriter::WriteFile(const std::vector<ContactPtr> &contacts,
+                               const std::string &path,
+                               Format format,
+                               std::atomic<size_t> *progress,
+                               std::string &error) {
+    const std::string tempPath = path + ".tmp";
+    const bool compressed = (format == Format::Compressed);
+    const size_t chunkBytes = compressed ? BlockCodec::DEFAULT_BLOCK_SIZE : WRITE_CHUNK_BYTES;
+
+    OutputFile file;
+    if (!file.Open(tempPath, error)) return false;
+
+    BoundedQueue<std::string> toCompress(PIPELINE_DEPTH);
+    BoundedQueue<std::string> toWrite(PIPELINE_DEPTH);
+    BoundedQueue<std::string> &sink = compressed ? toCompress : toWrite;
+
+    // Write stage. Only this thread touches file and writeError until
+    // it is joined.
+    std::string writeError;
+    std::thread writer([&]() {
+        std::string data;
+        while (toWrite.Pop(data)) {
+            if (!file.Write(data, writeError)) {
+                toWrite.Close();
+                toCompress.Close();
+                return;
+            }
+        }
+    });
+
+    // Compress stage.
+    std::thread compressor;
+    if (compressed) {
+        toWrite.Push(std::string(BlockCodec::MAGIC, BlockCodec::MAGIC_SIZE));
+        compressor = std::thread([&]() {
+            std::string chunk;
+            while (toCompress.Pop(chunk)) {
+                std::string framed;
+                BlockCodec::AppendFrame(framed, chunk.data(), chunk.size());
+                if (!toWrite.Push(std::move(framed))) {
+                    toCompress.Close();
+                    return;
+                }
+            }
+        });
+    }
+
+    // Serialize stage (this thread).
+    std::string chunk;
+    chunk.reserve(chunkBytes + 1024);
+    bool ok = true;
+    for (size_t i = 0; ok && i < contacts.size(); ++i) {
+        chunk += contacts[i]->toCSV();
+        chunk += '\n';
+        if (chunk.size() >= chunkBytes) {
+            ok = sink.Push(std::move(chunk));
+            chunk.clear();
+            chunk.reserve(chunkBytes + 1024);
+        }
+        if (progress) progress->fetch_add(1, std::memory_order_relaxed);
+    }
+    if (ok && !chunk.empty()) sink.Push(std::move(chunk));
+
+    if (compressed) {
+        toCompress.Close();
+        compressor.join();
+        std::string framed;
+        BlockCodec::AppendEndFrame(framed);
+        toWrite.Push(std::move(framed));
+    }
+    toWrite.Close();
+    writer.join();
+
+    ok = writeError.empty();
+    if (!ok) error = writeError;
+    if (ok) ok = file.Sync(error);
+    if (!file.Close() && ok) {
+        error = "close failed";
+        ok = false;
+    }
+    if (ok) ok = ReplaceFile(tempPath, path, error);
+    if (!ok) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+#if defined(SNAPSHOT_USE_POSIX)
+    SyncParentDirectory(path);
+#endif
+    return true;
+}
+
+//**********************************************************************
+// Start
+//----------------------------------------------------------------------
+// PURPOSE : A finished worker is joined before the next one starts, so
+//           at most one save thread exists at a time. Safe to call from
+//           several threads; a second caller simply gets false.
+//**********************************************************************
+bool SnapshotWriter::Start(std::vector<Job> jobs, Format format, std::function<void(bool succeeded)> finished) {
+    std::lock_guard<std::mutex> control(controlMutex_);
+    if (IsRunning()) return false;
+    if (worker_.joinable()) worker_.join();
+
+    size_t total = 0;
+    for (const Job &job : jobs) total += job.contacts.size();
+    written_.store(0);
+    total_.store(total);
+    {
+        std::lock_guard<std::mutex> lock(messageMutex_);
+        message_.clear();
+    }
+    state_.store(State::Running);
+
+    worker_ = std::thread([this, format, finished](std::vector<Job> work) {
+        std::string error;
+        bool ok = true;
+        {
+            LabelDictionary::NameFreeze names;
+            for (const Job &job : work) {
+                if (!(ok = WriteFile(job.contacts, job.path, format, &written_, error))) break;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(messageMutex_);
+            message_ = !ok ? error
+                     : work.size() == 1 ? work.front().path
+                     : std::to_string(work.size()) + " files";
+        }
+        if (finished) finished(ok);
+        state_.store(ok ? State::Succeeded : State::Failed);
+    }, std::move(jobs));
+    return true;
+}
+
+bool SnapshotWriter::WriteNow(const std::vector<Job> &jobs, Format format, std::string &error) {
+    std::lock_guard<std::mutex> control(controlMutex_);
+    if (worker_.joinable()) worker_.join();
+    LabelDictionary::NameFreeze names;
+    for (const Job &job : jobs) {
+        if (!WriteFile(job.contacts, job.path, format, nullptr, error)) return false;
+    }
+    return true;
+}
+
+void SnapshotWriter::Wait() {
+    std::lock_guard<std::mutex> control(controlMutex_);
+    if (worker_.joinable()) worker_.join();
+}
+
+SnapshotWriter::Status SnapshotWriter::GetStatus() const {
+    Status status;
+    status.state = state_.load();
+    status.written = written_.load(std::memory_order_relaxed);
+    status.total = total_.load();
+    std::lock_guard<std::mutex> lock(messageMutex_);
+    status.message = message_;
+    return status;
+}
+
+void SnapshotWriter::Acknowledge() {
+    State finished = State::Succeeded;
+    if (!state_.compare_exchange_strong(finished, State::Idle)) {
+        finished = State::Failed;
+        state_.compare_exchange_strong(finished, State::Idle);
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "Contact.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/****************************************************************
+ * CLASS: SnapshotWriter
+ * --------------------------------------------------------------
+ * Writes a snapshot of the address book to disk, either on the
+ * calling thread or on a background thread.
+ *
+ * A snapshot is a vector of ContactPtr handles. Stored contacts
+ * are immutable (edits swap in a new copy), so the handles stay
+ * valid and unchanged while the UI keeps editing.
+ *
+ * DURABILITY:
+ *   1) serialize to "<path>.tmp"
+ *   2) flush and fsync the temporary file
+ *   3) rename it over <path> (atomic on POSIX)
+ *   4) fsync the directory so the rename itself survives a crash
+ * A crash at any point leaves either the old or the new file,
+ * never a torn one. Platforms without POSIX I/O fall back to a
+ * plain stream write followed by remove + rename.
+ ***************************************************************/
+class SnapshotWriter {
+public:
+    enum class State { Idle, Running, Succeeded, Failed };
+    enum class Format { Csv, Compressed };     // Compressed = BlockCodec container
+
+    /************************************************************
+     * Job
+     * ----------------------------------------------------------
+     * PURPOSE : One file to write. A sharded book saves one job
+     *           per shard; a single-file book has one job.
+     ***********************************************************/
+    struct Job {
+        std::string path;
+        std::vector<ContactPtr> contacts;
+    };
+
+    /************************************************************
+     * Status
+     * ----------------------------------------------------------
+     * PURPOSE : Progress of the current (or last) background save.
+     *           message holds the error text after a failure.
+     ***********************************************************/
+    struct Status {
+        State state;
+        size_t written;      // contacts serialized so far
+        size_t total;        // contacts in the snapshot
+        std::string message; // file written (or "N files"), or the error
+    };
+
+    SnapshotWriter() = default;
+    SnapshotWriter(const SnapshotWriter &) = delete;
+    SnapshotWriter &operator=(const SnapshotWriter &) = delete;
+
+    /************************************************************
+     * ~SnapshotWriter
+     * ----------------------------------------------------------
+     * PURPOSE : Waits for a running save so the file is never
+     *           left half-written at exit.
+     ***********************************************************/
+    ~SnapshotWriter();
+
+    /************************************************************
+     * Start
+     * ----------------------------------------------------------
+     * PURPOSE : Begin writing the jobs in the background. Each
+     *           file is replaced atomically on its own; a failure
+     *           stops the remaining jobs. finished, if set, runs on
+     *           the save thread with the outcome, before the status
+     *           leaves Running.
+     * RETURNS : (bool) false if a save is already running; then
+     *           finished is not called.
+     ***********************************************************/
+    bool Start(std::vector<Job> jobs, Format format = Format::Csv,
+               std::function<void(bool succeeded)> finished = nullptr);
+
+    /************************************************************
+     * WriteNow
+     * ----------------------------------------------------------
+     * PURPOSE : Synchronous save on the calling thread. Waits for
+     *           a background save first and blocks new ones until
+     *           done, so the two never share the temporary file.
+     * RETURNS : (bool) true on success; error holds the reason.
+     ***********************************************************/
+    bool WriteNow(const std::vector<Job> &jobs, Format format, std::string &error);
+
+    /************************************************************
+     * Wait
+     * ----------------------------------------------------------
+     * PURPOSE : Block until the background save (if any) ends.
+     ***********************************************************/
+    void Wait();
+
+    /************************************************************
+     * GetStatus / IsRunning
+     * ----------------------------------------------------------
+     * PURPOSE : Lock-free progress polling for the UI.
+     ***********************************************************/
+    Status GetStatus() const;
+    bool IsRunning() const { return state_.load() == State::Running; }
+
+    /************************************************************
+     * Acknowledge
+     * ----------------------------------------------------------
+     * PURPOSE : Return a finished save to Idle once its result has
+     *           been shown, so it is reported only once.
+     ***********************************************************/
+    void Acknowledge();
+
+    /************************************************************
+     * WriteFile (static)
+     * ----------------------------------------------------------
+     * PURPOSE : The durable temp-file + fsync + rename write.
+     * PARAMS  : contacts (IN)  - records to write, in order
+     *           path     (IN)  - final file name
+     *           format   (IN)  - plain CSV or compressed blocks
+     *           progress (OUT) - optional per-contact counter
+     *           error    (OUT) - reason on failure
+     * RETURNS : (bool) true if path now holds the new contents.
+     ***********************************************************/
+    static bool WriteFile(const std::vector<ContactPtr> &contacts,
+                          const std::string &path,
+                          Format format,
+                          std::atomic<size_t> *progress,
+                          std::string &error);
+
+private:
+    std::mutex controlMutex_;           // serializes Start / Wait (UI and autosave threads)
+    std::thread worker_;
+    std::atomic<State> state_ {State::Idle};
+    std::atomic<size_t> written_ {0};
+    std::atomic<size_t> total_ {0};
+    mutable std::mutex messageMutex_;   // guards message_
+    std::string message_;
+};
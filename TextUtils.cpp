@@ -0,0 +1,71 @@
+//======================================================================
+// Implementation File: TextUtils.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Shared string normalization helpers used by the index modules.
+//======================================================================
+
+#include "TextUtils.h"
+#include <cctype>
+
+namespace TextUtils {
+
+//**********************************************************************
+// FoldCase
+//----------------------------------------------------------------------
+// PURPOSE : Lowercase every character. Casts through unsigned char so
+//           bytes >= 0x80 do not hit undefined behavior in tolower.
+//**********************************************************************
+std::string FoldCase(const std::string &text) {
+    std::string folded(text.size(), '\0');
+    for (size_t i = 0; i < text.size(); ++i) {
+        folded[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(text[i])));
+    }
+    return folded;
+}
+
+//**********************************************************************
+// StartsWith
+//----------------------------------------------------------------------
+// PURPOSE : Prefix test without allocating.
+//**********************************************************************
+bool StartsWith(const std::string &text, const std::string &prefix) {
+    return text.size() >= prefix.size() &&
+           text.compare(0, prefix.size(), prefix) == 0;
+}
+
+//**********************************************************************
+// IsWordByte
+//----------------------------------------------------------------------
+// PURPOSE : Word test that ignores the locale, so ranking and the
+//           full-text index split text the same way everywhere.
+//**********************************************************************
+bool IsWordByte(char c) {
+    const unsigned char byte = static_cast<unsigned char>(c);
+    return byte >= 0x80 || (byte >= '0' && byte <= '9') || (byte >= 'a' && byte <= 'z') ||
+           (byte >= 'A' && byte <= 'Z');
+}
+
+//**********************************************************************
+// SplitWords
+//----------------------------------------------------------------------
+// PURPOSE : Tokenizer shared by query parsing and text indexing.
+//**********************************************************************
+std::vector<std::string> SplitWords(const std::string &text) {
+    std::vector<std::string> words;
+    std::string word;
+    for (const char c : text) {
+        if (IsWordByte(c)) {
+            word += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        } else if (!word.empty()) {
+            words.push_back(std::move(word));
+            word.clear();
+        }
+    }
+    if (!word.empty()) {
+        words.push_back(std::move(word));
+    }
+    return words;
+}
+
+}
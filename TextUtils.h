@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/****************************************************************
+ * NAMESPACE: TextUtils
+ * --------------------------------------------------------------
+ * Small string helpers shared by the search indexes. Kept free
+ * of any Contact / AddressBook knowledge so every index module
+ * can normalize keys the same way.
+ ***************************************************************/
+namespace TextUtils {
+
+    /************************************************************
+     * FoldCase
+     * ----------------------------------------------------------
+     * PURPOSE : Produce the case-folded (ASCII lowercase) form of
+     *           a string, used as the canonical index key.
+     * RETURNS : (string) Lowercased copy of the input.
+     ***********************************************************/
+    std::string FoldCase(const std::string &text);
+
+    /************************************************************
+     * StartsWith
+     * ----------------------------------------------------------
+     * PURPOSE : Test whether text begins with prefix.
+     * RETURNS : true if prefix is a leading substring of text.
+     ***********************************************************/
+    bool StartsWith(const std::string &text, const std::string &prefix);
+
+    /************************************************************
+     * IsWordByte
+     * ----------------------------------------------------------
+     * PURPOSE : True for the bytes that make up words: ASCII
+     *           letters and digits, and every byte >= 0x80 so a
+     *           UTF-8 name ("José") stays one word.
+     ***********************************************************/
+    bool IsWordByte(char c);
+
+    /************************************************************
+     * SplitWords
+     * ----------------------------------------------------------
+     * PURPOSE : Case-folded words of text, split on punctuation
+     *           and whitespace, in order.
+     * RETURNS : (vector<string>) Empty if text has no words.
+     ***********************************************************/
+    std::vector<std::string> SplitWords(const std::string &text);
+
+}
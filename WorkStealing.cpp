@@ -0,0 +1,206 @@
+//======================================================================
+// Implementation File: WorkStealing.cpp
+//----------------------------------------------------------------------
+// PURPOSE:
+//   Range-splitting work-stealing loop for batches of small tasks, run
+//   on one process-wide pool of helper threads.
+//----------------------------------------------------------------------
+// DESIGN NOTES:
+//   * A thread's queue is always one contiguous range [begin, end), so
+//     "push / pop / steal" reduce to moving its two ends: the owner
+//     advances begin, a thief takes [mid, end) and lowers end. Both
+//     ends live in one 64-bit atomic word and move with a single
+//     compare-exchange, padded off its neighbours' cache line; the
+//     owner's exchange only fails if a thief got in first.
+//   * Stolen work is never put back in a shared place: the thief runs
+//     it from its own range. So a thread may stop as soon as it sees
+//     every range empty; work in flight belongs to a thread that will
+//     finish it.
+//   * Helpers are started once and then sleep between calls. A call
+//     posts its job, works through it on the calling thread, and
+//     waits only for the helpers that actually joined; a helper that
+//     is busy elsewhere simply leaves its share to be stolen.
+//======================================================================
+
+#include "WorkStealing.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    const unsigned MAX_HELPERS = 63;                       // pool never grows past this
+    const size_t MAX_JOB_TASKS = 0xFFFFFFFFu;              // range ends are 32-bit
+
+    struct Range {
+        std::atomic<std::uint64_t> bounds {0};   // begin << 32 | end
+        char padding[64];                        // keeps neighbours off this cache line
+    };
+
+    std::uint64_t Pack(size_t begin, size_t end) {
+        return static_cast<std::uint64_t>(begin) << 32 | static_cast<std::uint64_t>(end);
+    }
+
+    size_t BeginOf(std::uint64_t bounds) { return static_cast<size_t>(bounds >> 32); }
+    size_t EndOf(std::uint64_t bounds) { return static_cast<size_t>(bounds & 0xFFFFFFFFu); }
+
+    //  Owner side: the next index of its own range, if any.
+    bool TakeFront(Range &range, size_t &index) {
+        std::uint64_t bounds = range.bounds.load(std::memory_order_acquire);
+        while (BeginOf(bounds) != EndOf(bounds)) {
+            if (range.bounds.compare_exchange_weak(bounds, Pack(BeginOf(bounds) + 1, EndOf(bounds)),
+                                                   std::memory_order_acq_rel)) {
+                index = BeginOf(bounds);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //  Thief side: moves the back half of the fullest other range into
+    //  self (whose own range is empty). False once every range is empty.
+    bool Steal(std::vector<Range> &ranges, size_t self) {
+        for (;;) {
+            size_t victim = ranges.size();
+            size_t most = 0;
+            for (size_t r = 0; r < ranges.size(); ++r) {
+                if (r == self) continue;
+                const std::uint64_t bounds = ranges[r].bounds.load(std::memory_order_acquire);
+                if (EndOf(bounds) - BeginOf(bounds) > most) {
+                    most = EndOf(bounds) - BeginOf(bounds);
+                    victim = r;
+                }
+            }
+            if (victim == ranges.size()) return false;
+
+            std::uint64_t bounds = ranges[victim].bounds.load(std::memory_order_acquire);
+            const size_t left = EndOf(bounds) - BeginOf(bounds);
+            if (left == 0) continue;                     // drained meanwhile; look again
+            const size_t end = EndOf(bounds);
+            const size_t begin = end - (left + 1) / 2;
+            if (!ranges[victim].bounds.compare_exchange_strong(bounds, Pack(BeginOf(bounds), begin),
+                                                              std::memory_order_acq_rel)) {
+                continue;                                // owner or another thief moved it
+            }
+            ranges[self].bounds.store(Pack(begin, end), std::memory_order_release);
+            return true;
+        }
+    }
+
+    //  One ParallelFor call: range 0 is the caller's, the rest go to the
+    //  helpers that join, in the order they join.
+    struct Job {
+        Job(size_t count, unsigned threads, const std::function<void(size_t)> &task)
+            : ranges(threads), task(task) {
+            for (unsigned t = 0; t < threads; ++t) {
+                ranges[t].bounds.store(Pack(count * t / threads, count * (t + 1) / threads));
+            }
+        }
+
+        void Work(size_t self) {
+            size_t index;
+            do {
+                while (TakeFront(ranges[self], index)) task(index);
+            } while (Steal(ranges, self));
+        }
+
+        std::vector<Range> ranges;
+        const std::function<void(size_t)> &task;
+        unsigned joined {0};             // helpers that took a range (pool mutex)
+        unsigned working {0};            // of those, still in Work() (pool mutex)
+    };
+
+    class Pool {
+    public:
+        ~Pool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            posted_.notify_all();
+            for (auto &thread : threads_) thread.join();
+        }
+
+        //  Runs job with up to its range count - 1 helpers; returns once
+        //  every task has finished.
+        void Run(Job &job) {
+            const unsigned helpers = static_cast<unsigned>(job.ranges.size() - 1);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                while (threads_.size() < std::min(helpers, MAX_HELPERS)) {
+                    threads_.emplace_back(&Pool::Helper, this);
+                }
+                jobs_.push_back(&job);
+            }
+            posted_.notify_all();
+
+            job.Work(0);
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto queued = std::find(jobs_.begin(), jobs_.end(), &job);
+            if (queued != jobs_.end()) jobs_.erase(queued);   // no one joins from here on
+            finished_.wait(lock, [&job] { return job.working == 0; });
+        }
+
+    private:
+        void Helper() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (;;) {
+                posted_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+                if (stopping_) return;
+
+                Job &job = *jobs_.front();
+                const size_t self = ++job.joined;
+                if (self + 1 == job.ranges.size()) jobs_.pop_front();   // every range taken
+                ++job.working;
+
+                lock.unlock();
+                job.Work(self);
+                lock.lock();
+
+                if (--job.working == 0) finished_.notify_all();
+            }
+        }
+
+        std::mutex mutex_;                   // guards everything below
+        std::condition_variable posted_;     // a job was posted, or stopping
+        std::condition_variable finished_;   // a job's last helper left
+        std::deque<Job *> jobs_;             // jobs with ranges no helper has taken
+        std::vector<std::thread> threads_;
+        bool stopping_ {false};
+    };
+
+    Pool &SharedPool() {
+        static Pool pool;
+        return pool;
+    }
+}
+
+namespace WorkStealing {
+
+void ParallelFor(size_t count, unsigned threadCount, const std::function<void(size_t)> &task) {
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min<unsigned>(threadCount, std::max<size_t>(1, count));
+    if (threadCount == 1) {
+        for (size_t i = 0; i < count; ++i) task(i);
+        return;
+    }
+
+    if (count <= MAX_JOB_TASKS) {
+        Job job(count, threadCount, task);
+        SharedPool().Run(job);
+        return;
+    }
+    for (size_t first = 0; first < count; first += MAX_JOB_TASKS) {
+        const std::function<void(size_t)> slice = [&task, first](size_t i) { task(first + i); };
+        Job job(std::min(count - first, MAX_JOB_TASKS), threadCount, slice);
+        SharedPool().Run(job);
+    }
+}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+/****************************************************************
+ * NAMESPACE: WorkStealing
+ * --------------------------------------------------------------
+ * Scheduler for many independent tasks of uneven cost (a batch of
+ * lookups where most are hash probes and a few are full scans).
+ *
+ * Each thread starts with its own contiguous share of the task
+ * indexes and takes them from the front one at a time with an
+ * atomic exchange on its own share's bounds, touching no counter
+ * the other threads use. A thread that runs out steals the back
+ * half of the largest share left, so a share that turned out to
+ * hold the expensive tasks is split up instead of finishing last.
+ *
+ * The helper threads belong to one pool for the whole process:
+ * they start with the first parallel call (as many as the largest
+ * threadCount asked for, less the caller) and sleep between calls,
+ * so a call costs a wake-up rather than thread creation. Every
+ * parallel loop in the program (batch queries, ranked scans,
+ * duplicate scoring, block decoding, lazy indexing) runs here.
+ ***************************************************************/
+namespace WorkStealing {
+
+    /************************************************************
+     * ParallelFor
+     * ----------------------------------------------------------
+     * PURPOSE : Run task(i) once for every i in [0, count) and
+     *           return when all have finished. The calling thread
+     *           works too. Tasks must not throw and must be safe
+     *           to run concurrently with each other.
+     * PARAMS  : count       (IN) - number of tasks
+     *           threadCount (IN) - threads to use (0 = one per core)
+     *           task        (IN) - called with each task index
+     ***********************************************************/
+    void ParallelFor(size_t count, unsigned threadCount, const std::function<void(size_t)> &task);
+}
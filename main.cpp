@@ -1,10 +1,65 @@
 // main.cpp
 #include "AddressBook.h"
+#include "AppConfig.h"
+#include "Benchmarks.h"
+#include "BookServer.h"
 #include "MainUI.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
 
-int main()
+int main(int argc, char* argv[])
 {
+    std::vector<std::string> configWarnings;
+    const AppConfig config = AppConfig::Load(argc, argv, configWarnings);
+    for (const auto& warning : configWarnings)
+    {
+        std::cout << "Warning: " << warning << "\n";
+    }
+
+    if (config.benchmark == "compression")
+    {
+        return Benchmarks::RunCompression(std::cout);
+    }
+    if (config.benchmark == "batch")
+    {
+        return Benchmarks::RunBatchQueries(std::cout);
+    }
+    if (config.benchmark == "ranking")
+    {
+        return Benchmarks::RunRanking(std::cout);
+    }
+
     AddressBook addressBookInstance;
+    addressBookInstance.SetCompressedSaves(config.compressSaves);
+    addressBookInstance.SetLazyLoad(config.lazyLoad);
+    addressBookInstance.SetStemming(config.stemWords);
+    if (!config.shardDirectory.empty())
+    {
+        addressBookInstance.SetShardDirectory(config.shardDirectory);
+    }
+    if (!config.changeStream.empty())
+    {
+        addressBookInstance.StreamChangesTo(config.changeStream);
+    }
+    if (config.autosaveEnabled)
+    {
+        addressBookInstance.EnableAutosave(Autosaver::Policy {
+            config.autosaveMutations,
+            std::chrono::seconds(config.autosaveSeconds),
+            std::chrono::seconds(config.autosaveMinIntervalSeconds) });
+    }
+    if (!config.watchList.empty())
+    {
+        addressBookInstance.LoadFromFile();
+        return addressBookInstance.ReportWatchList(config.watchList) ? 0 : 1;
+    }
+    if (!config.serveSocket.empty())
+    {
+        addressBookInstance.LoadFromFile();
+        BookServer server(addressBookInstance, config.serveSocket, config.serverThreads);
+        return server.Run();
+    }
     UI::RunMainMenuLoop(addressBookInstance);
     return 0;
-}
\ No newline at end of file
+}